@@ -6,13 +6,66 @@ typedef enum ASSET_TYPE {
     ASSET_FONT,
     ASSET_SHADER,
     ASSET_TEXTURE,
+    ASSET_MESH,
 } ASSET_TYPE;
 
 typedef struct rl_asset {
     ASSET_TYPE type;
     const char *filename;
     void *handle;
+    u64 name_hash; // Filled in by the asset system
 } rl_asset;
 
-REALM_API const char *get_assets_dir(ASSET_TYPE asset_type);
+typedef enum ASSET_STATE {
+    ASSET_STATE_UNLOADED, // Listed in the manifest, nothing requested it yet
+    ASSET_STATE_PENDING,
+    ASSET_STATE_READY,
+    ASSET_STATE_FAILED,
+    ASSET_STATE_EVICTED, // Dropped to stay within budget, asset_touch / asset_load_async bring it back
+} ASSET_STATE;
+
+typedef enum ASSET_BUDGET {
+    ASSET_BUDGET_CPU, // Decoded data plus the pack bytes it points into
+    ASSET_BUDGET_GPU, // As reported by the renderers through asset_set_gpu_size
+    ASSET_BUDGET_MAX,
+} ASSET_BUDGET;
+
+// Stable reference into the registry, generation 0 is never valid
+typedef struct rl_asset_handle {
+    u32 index;
+    u32 generation;
+} rl_asset_handle;
+
+REALM_API const char *get_assets_dir(ASSET_TYPE asset_type); // Virtual directory, open files through the VFS
+REALM_API const char *get_cache_dir(); // Real path. Derived data (shader binaries, pipeline caches), safe to delete
 REALM_API rl_asset *get_asset(const char *filename);
+
+REALM_API u64 asset_name_hash(const char *filename);
+REALM_API rl_asset_handle asset_find(const char *filename);
+REALM_API rl_asset_handle asset_find_hash(u64 name_hash); // Hash from asset_name_hash()
+REALM_API rl_asset *asset_get(rl_asset_handle handle);    // nullptr if the handle is stale or not ready
+REALM_API b8 asset_handle_valid(rl_asset_handle handle);
+
+// Registers `filename` and decodes it on the job system, returns the existing handle if it's already known.
+// Finished loads are published by the engine each frame within a time budget, EVENT_ASSET_LOADED fires
+// with the rl_asset_handle once the asset is ready. Main thread only, like asset_get_state.
+REALM_API rl_asset_handle asset_load_async(ASSET_TYPE type, const char *filename);
+REALM_API ASSET_STATE asset_get_state(rl_asset_handle handle); // FAILED for stale handles
+
+// Loads every non on-demand asset of a manifest group and blocks until they're ready. Members are pinned.
+REALM_API b8 asset_load_group(const char *group);
+
+/* Streaming
+ *  Assets registered through asset_load_async are evictable. Once a budget is exceeded, asset_system_update
+ *  evicts the least recently touched ones (lowest priority first among equals) until it fits again, never
+ *  anything touched this frame (asset_get counts). Evicted assets reload from the pack or their source on
+ *  the next touch. GPU residency stays counted until the renderer releases its copy on EVENT_ASSET_EVICTED
+ *  and reports a size of 0.
+ *  Assets loaded at startup are pinned.
+ */
+// Marks the asset as used this frame, `priority` is app defined (e.g. inverse distance), higher stays longer
+REALM_API void asset_touch(rl_asset_handle handle, f32 priority);
+REALM_API void asset_set_pinned(rl_asset_handle handle, b8 pinned);
+REALM_API void asset_set_gpu_size(rl_asset_handle handle, u64 size);
+REALM_API void asset_set_budget(ASSET_BUDGET budget, u64 size);
+REALM_API u64 asset_get_resident_size(ASSET_BUDGET budget);
@@ -23,18 +23,36 @@ typedef enum EVENT_TYPE {
 
     // Splash
     EVENT_SPLASH_INCREMENT,
+
+    // Assets, payload is the rl_asset_handle
+    EVENT_ASSET_LOADED,
+    EVENT_ASSET_RELOADED, // Source changed on disk, the asset now points at the new data
+    EVENT_ASSET_EVICTED,  // Fired while the data is still valid, drop GPU copies and pointers into it
+
+    EVENT_TYPE_MAX,
 } EVENT_TYPE;
 
+// Return true to consume the event, handlers registered after this one won't see it
+typedef b8 (*rl_event_callback)(void *event, void *user_data);
+
 typedef struct rl_event {
-    EVENT_TYPE type;
-    b8 (*event_callback)(void *event, void *user_data);
+    rl_event_callback event_callback;
     void *user_data;
 } rl_event;
 
 REALM_API u64 event_system_size();
 REALM_API b8 event_system_start(void *memory);
 
+// Handlers run in registration order
 REALM_API void event_fire(EVENT_TYPE type, void *event_data);
-REALM_API void event_register(EVENT_TYPE type, b8 (*callback)(void *data, void *user_data), void *user_data);
+REALM_API void event_register(EVENT_TYPE type, rl_event_callback callback, void *user_data);
+// Removes the handler matching both callback and user_data, safe to call from inside a handler
+REALM_API b8 event_unregister(EVENT_TYPE type, rl_event_callback callback, void *user_data);
+
+// Thread-safe and lock-free. The payload is copied into the current frame's buffer and handlers run
+// on the main thread at the next event_dispatch_posted(), grouped by type. Returns false if the frame is full.
+REALM_API b8 event_post(EVENT_TYPE type, const void *payload, u64 size);
+// Main thread only, called once per frame by the engine
+REALM_API void event_dispatch_posted();
 
 REALM_API void event_system_shutdown();
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "defines.h"
+
+#include <stdatomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Work-stealing job system
+ *  One worker per logical core (main thread counts as worker 0).
+ *  Jobs are pushed to the calling thread's deque, idle workers steal from the others.
+ *  Completion is tracked with counters: every job decrements its counter once finished.
+ */
+
+typedef void (*rl_job_fn)(void *data);
+
+typedef struct rl_job {
+    rl_job_fn entry;
+    void *data;
+} rl_job;
+
+typedef struct rl_job_counter {
+    _Atomic i32 pending;
+} rl_job_counter;
+
+REALM_API u64 job_system_size();
+REALM_API b8 job_system_start(void *memory);
+REALM_API void job_system_shutdown();
+
+// Queue `count` jobs, counter is optional. Threads outside the pool run the jobs inline.
+REALM_API void job_run(const rl_job *jobs, u32 count, rl_job_counter *counter);
+
+// Blocks until counter reaches zero, executing other queued jobs in the meantime.
+REALM_API void job_wait(rl_job_counter *counter);
+REALM_API b8 job_is_done(rl_job_counter *counter);
+// Runs one queued job on the calling pool thread, false if there was none. For waits that need to do other work.
+REALM_API b8 job_try_run_one();
+
+REALM_API u32 job_worker_count(); // Includes the main thread
+REALM_API i32 job_thread_index(); // -1 for threads outside the pool
+
+#ifdef __cplusplus
+}
+#endif
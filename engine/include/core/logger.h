@@ -21,21 +21,109 @@ REALM_API u64 logger_system_size();
 REALM_API b8 logger_system_start(void *memory);
 REALM_API void logger_system_shutdown();
 
+// Binary mode: callers only enqueue the format pointer, timestamp, thread id and packed arguments,
+// formatting happens on the writer thread. Format strings must outlive the logger (string literals).
+REALM_API void logger_set_binary_mode(b8 enabled);
+
+// Writes out everything queued so far on the calling thread and forgets the dump's string table.
+// Queued records and the dump refer to format / function names by address, call it before unloading a module that logs.
+REALM_API void logger_flush();
+
+// Mirrors every record in raw binary form to `path` for offline decoding
+REALM_API b8 logger_dump_open(const char *path);
+REALM_API void logger_dump_close();
+
+// File sink: lines are appended into a pre-sized memory-mapped file and written back once per drain.
+// Rotates to path.1 ... path.max_files when `max_size` bytes or `max_lines` lines (0 = no limit) are reached.
+REALM_API b8 logger_file_open(const char *path, u64 max_size, u64 max_lines, u32 max_files);
+REALM_API void logger_file_close();
+
+// Console output is on by default, headless runs can log to the file sink only
+REALM_API void logger_set_console_enabled(b8 enabled);
+
 REALM_API void log_output(const char *message, LOG_LEVEL level, const char *func, ...);
 
-#define RL_INFO(msg, ...) log_output(msg, LOG_INFO, __func__, ##__VA_ARGS__);
+/* Log categories
+ *  Engine sources get theirs from the build (per source directory), anything else logs as app.
+ *  Define RL_LOG_CATEGORY before the first include to override it for a translation unit.
+ */
+typedef enum LOG_CATEGORY {
+    LOG_CAT_CORE,
+    LOG_CAT_RENDERER,
+    LOG_CAT_ASSET,
+    LOG_CAT_PLATFORM,
+    LOG_CAT_MEMORY,
+    LOG_CAT_APP,
+    LOG_CAT_MAX
+} LOG_CATEGORY;
+
+#ifndef RL_LOG_CATEGORY
+#define RL_LOG_CATEGORY LOG_CAT_APP
+#endif
+
+// Runtime filters, one bit per LOG_LEVEL. Checked before any argument is evaluated.
+REALM_API extern u8 log_category_masks[LOG_CAT_MAX];
+
+// Enables every level at or above `min_level` in severity (trace < debug < info < warn < error < fatal)
+REALM_API void logger_set_category_level(LOG_CATEGORY category, LOG_LEVEL min_level);
+REALM_API void logger_set_category_mask(LOG_CATEGORY category, u8 mask);
+
+// Severity order for the compile-time cutoff, LOG_LEVEL itself is in display order
+#define RL_LOG_SEVERITY_TRACE 0
+#define RL_LOG_SEVERITY_DEBUG 1
+#define RL_LOG_SEVERITY_INFO 2
+#define RL_LOG_SEVERITY_WARN 3
+#define RL_LOG_SEVERITY_ERROR 4
+#define RL_LOG_SEVERITY_FATAL 5
+
+// Calls below this severity are removed by the preprocessor, arguments included
+#ifndef RL_LOG_MIN_SEVERITY
 #ifdef _DEBUG
-#define RL_DEBUG(msg, ...) log_output(msg, LOG_DEBUG, __func__, ##__VA_ARGS__);
-#define RL_TRACE(msg, ...) log_output(msg, LOG_TRACE, __func__, ##__VA_ARGS__);
-#define RL_WARN(msg, ...) log_output(msg, LOG_WARN, __func__, ##__VA_ARGS__);
+#define RL_LOG_MIN_SEVERITY RL_LOG_SEVERITY_TRACE
+#else
+#define RL_LOG_MIN_SEVERITY RL_LOG_SEVERITY_INFO
+#endif
+#endif
+
+#define RL_LOG(category, level, msg, ...)                         \
+    do {                                                          \
+        if (log_category_masks[category] & (1u << (level))) {     \
+            log_output(msg, level, __func__, ##__VA_ARGS__);      \
+        }                                                         \
+    } while (0)
+
+#if RL_LOG_MIN_SEVERITY <= RL_LOG_SEVERITY_TRACE
+#define RL_TRACE(msg, ...) RL_LOG(RL_LOG_CATEGORY, LOG_TRACE, msg, ##__VA_ARGS__)
 #else
-// These expand to nothing but still swallow parameters correctly.
-#define RL_DEBUG(msg, ...) ((void)0)
 #define RL_TRACE(msg, ...) ((void)0)
+#endif
+
+#if RL_LOG_MIN_SEVERITY <= RL_LOG_SEVERITY_DEBUG
+#define RL_DEBUG(msg, ...) RL_LOG(RL_LOG_CATEGORY, LOG_DEBUG, msg, ##__VA_ARGS__)
+#else
+#define RL_DEBUG(msg, ...) ((void)0)
+#endif
+
+#if RL_LOG_MIN_SEVERITY <= RL_LOG_SEVERITY_INFO
+#define RL_INFO(msg, ...) RL_LOG(RL_LOG_CATEGORY, LOG_INFO, msg, ##__VA_ARGS__)
+#else
+#define RL_INFO(msg, ...) ((void)0)
+#endif
+
+#if RL_LOG_MIN_SEVERITY <= RL_LOG_SEVERITY_WARN
+#define RL_WARN(msg, ...) RL_LOG(RL_LOG_CATEGORY, LOG_WARN, msg, ##__VA_ARGS__)
+#else
 #define RL_WARN(msg, ...) ((void)0)
 #endif
-#define RL_ERROR(msg, ...) log_output(msg, LOG_ERROR, __func__, ##__VA_ARGS__);
-#define RL_FATAL(msg, ...) log_output(msg, LOG_FATAL, __func__, ##__VA_ARGS__);
+
+#if RL_LOG_MIN_SEVERITY <= RL_LOG_SEVERITY_ERROR
+#define RL_ERROR(msg, ...) RL_LOG(RL_LOG_CATEGORY, LOG_ERROR, msg, ##__VA_ARGS__)
+#else
+#define RL_ERROR(msg, ...) ((void)0)
+#endif
+
+// Fatal is never compiled out or masked
+#define RL_FATAL(msg, ...) log_output(msg, LOG_FATAL, __func__, ##__VA_ARGS__)
 
 #ifdef __cplusplus
 }
@@ -3,6 +3,10 @@
 #include "defines.h"
 #include <memory/memory.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /* Bump / Linear / Arena allocator
  *  Not thread safe!
  */
@@ -44,3 +48,7 @@ REALM_API void arena_scratch_release(rl_temp_arena scratch);
 
 #define ARENA_SCRATCH_START() rl_temp_arena scratch = rl_arena_scratch_get()
 #define ARENA_SCRATCH_RELEASE() arena_scratch_release(scratch)
+
+#ifdef __cplusplus
+}
+#endif
@@ -125,14 +125,17 @@ typedef enum KEYBOARD_KEY {
     KEY_MAX_KEYS,
 } KEYBOARD_KEY;
 
+// Key and button transitions are posted as events, timestamp is the platform clock counter at the OS message
 typedef struct input_key {
     KEYBOARD_KEY key;
     b8 pressed;
+    i64 timestamp;
 } input_key;
 
 typedef struct input_mouse_button {
     MOUSE_BUTTON button;
     b8 pressed;
+    i64 timestamp;
 } input_mouse_button;
 
 typedef struct input_mouse_move {
@@ -143,6 +146,28 @@ typedef struct input_mouse_scroll {
     i16 z_delta;
 } input_mouse_scroll;
 
+#define INPUT_KEY_WORDS ((KEY_MAX_KEYS + 63) / 64)
+
+/* Input state for one frame
+ *  Motion, scroll and raw deltas are coalesced between frames and published once by input_update().
+ *  Snapshots are immutable once published and stay valid for one more frame after being replaced,
+ *  so any thread can read them without locking.
+ */
+typedef struct input_snapshot {
+    u64 frame;
+    i64 timestamp;
+
+    i16 mouse_x, mouse_y;
+    i16 prev_mouse_x, prev_mouse_y;
+    i32 mouse_dx, mouse_dy; // Cursor motion or raw deltas accumulated this frame
+    i32 scroll;
+
+    u64 keys[INPUT_KEY_WORDS];
+    u64 prev_keys[INPUT_KEY_WORDS];
+    u8 buttons;
+    u8 prev_buttons;
+} input_snapshot;
+
 void input_system_init();
 
 // Perform mapping from keycode to button per platform
@@ -153,6 +178,8 @@ void input_process_mouse_raw(i32 dx, i32 dy);
 void input_process_mouse_move(i32 position_x, i32 position_y);
 void input_process_mouse_scroll(i32 delta); // Flatten the input to an OS-independent (-1, 1)
 
+REALM_API const input_snapshot *input_get_snapshot();
+
 REALM_API b8 input_is_key_down(KEYBOARD_KEY key);  // now
 REALM_API b8 input_key_pressed(KEYBOARD_KEY key);  // up -> down
 REALM_API b8 input_key_released(KEYBOARD_KEY key); // down -> up
@@ -165,4 +192,4 @@ REALM_API void input_get_mouse_position(vec2 pos);
 REALM_API void input_get_previous_mouse_position(vec2 pos);
 REALM_API void input_get_mouse_delta(vec2 delta_pos);
 
-void input_update();
+void input_update(); // Publishes the next snapshot, main thread only
@@ -3,6 +3,13 @@
 #include "defines.h"
 #include "memory/arena.h"
 
+// Readahead hints for mapped ranges
+typedef enum FILE_ACCESS {
+    FILE_ACCESS_SEQUENTIAL, // Read front to back once, aggressive readahead
+    FILE_ACCESS_RANDOM,     // Scattered reads, no readahead past what's touched
+    FILE_ACCESS_WILLNEED,   // Start reading the range now, doesn't wait for it
+} FILE_ACCESS;
+
 typedef enum FILE_PERM {
     P_FILE_READ,
     P_FILE_WRITE,
@@ -10,6 +17,21 @@ typedef enum FILE_PERM {
     P_FILE_ALL,
 } FILE_PERM;
 
+// Memory-mapped file
+typedef struct rl_file_map {
+    void *handle;
+    void *mapping; // Win32 mapping object
+    u8 *data;
+    u64 size;
+} rl_file_map;
+
+// Change notifications for the files directly inside a set of directories
+typedef struct rl_file_watch {
+    void *handle;
+} rl_file_watch;
+
+typedef void (*rl_file_watch_fn)(const char *filename, void *user_data);
+
 typedef struct rl_file {
     void *handle;
     void *buf;
@@ -21,9 +43,36 @@ typedef struct rl_file {
 
 REALM_API b8 platform_file_exists(const char *path);
 REALM_API b8 platform_dir_exists(const char *path);
+REALM_API b8 platform_dir_create(const char *path); // Succeeds if it already exists
 REALM_API b8 platform_file_copy(const char *source_path, const char *dest_path, b8 overwrite);
 REALM_API b8 platform_file_delete(const char *path);
+REALM_API b8 platform_file_rename(const char *source_path, const char *dest_path); // Replaces dest
+REALM_API u64 platform_file_mtime(const char *path);                              // Last write time, 0 if missing
+REALM_API b8 platform_executable_dir(char *out, u64 size);                         // With a trailing separator
 
 REALM_API b8 platform_file_open(const char *path, FILE_PERM perms, rl_file *out_file);
 REALM_API b8 platform_file_read_all(rl_file *file);
 REALM_API void platform_file_close(rl_file *file);
+
+// Creates (or truncates) a file for sequential writing
+REALM_API b8 platform_file_create(const char *path, rl_file *out_file);
+REALM_API b8 platform_file_write(rl_file *file, const void *data, u64 size);
+
+// Maps an existing file read-only
+REALM_API b8 platform_file_map_open(const char *path, rl_file_map *out_map);
+// Creates (or truncates) `path`, pre-sizes it to `size` bytes and maps it writable
+REALM_API b8 platform_file_map_create(const char *path, u64 size, rl_file_map *out_map);
+// Starts writeback of a dirty range, does not wait for it
+REALM_API void platform_file_map_flush(rl_file_map *map, u64 offset, u64 size);
+// Unmaps and truncates the file to `used` bytes, pass `map->size` for read-only maps
+REALM_API void platform_file_map_close(rl_file_map *map, u64 used);
+// Readahead hint for a range of a read-only mapping, page cache and mapping both where the OS allows
+REALM_API void platform_file_map_advise(const rl_file_map *map, u64 offset, u64 size, FILE_ACCESS access);
+
+// Linux only (inotify). On macOS and Windows open returns false and the other calls do nothing, so asset
+// hot reload is off there.
+REALM_API b8 platform_file_watch_open(rl_file_watch *out_watch);
+REALM_API b8 platform_file_watch_add(rl_file_watch *watch, const char *dir);
+// Doesn't block. Calls `callback` with the name of every file that was written or moved into a watched dir since the last poll.
+REALM_API void platform_file_watch_poll(rl_file_watch *watch, rl_file_watch_fn callback, void *user_data);
+REALM_API void platform_file_watch_close(rl_file_watch *watch);
@@ -17,6 +17,8 @@ REALM_API void renderer_render_text(const char *text, f32 size_px, f32 x, f32 y,
 REALM_API void renderer_set_active_font(rl_font *font);
 
 REALM_API void renderer_set_view_projection(mat4 view, mat4 projection, vec3 pos);
+// Screen space error in pixels allowed when picking mesh LODs, higher trades detail for triangles
+REALM_API void renderer_set_lod_threshold(f32 threshold_px);
 
 REALM_API platform_window *renderer_get_active_window();
 REALM_API void renderer_set_active_window(platform_window *window);
@@ -1,32 +1,178 @@
 #include "asset/asset_internal.h"
 
 #include "asset/asset.h"
-#include "asset/asset_table.h"
+#include "asset/asset_pack.h"
+#include "asset/asset_manifest.h"
+#include "asset/vfs.h"
 
 #include "asset/font.h"
+#include "asset/mesh.h"
 #include "asset/shader.h"
 #include "asset/texture.h"
 #include "core/event.h"
+#include "core/job.h"
 #include "core/logger.h"
+#include "memory/containers/dynamic_array.h"
 #include "platform/platform.h"
 #include "platform/io/file_io.h"
 #include "platform/splash/splash.h"
+#include "util/str.h"
 
+#include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 
+#define ASSET_PAGE_SHIFT 8
+#define ASSET_PAGE_SIZE (1u << ASSET_PAGE_SHIFT)
+#define ASSET_MAX_PAGES 64 // 16K assets
+#define ASSET_TABLE_MIN_CAPACITY 64
+#define ASSET_TABLE_MAX_LOAD 70 // Percent
+#define ASSET_FRAME_BUDGET_US 2000 // Main thread time asset_system_update may spend finishing loads
+#define ASSET_RECOOK_DELAY_MS 1000 // Quiet time after the last hot reload before the pack is rewritten
+#define ASSET_ROOT_DIR "../../../assets/" // Relative to the executable
+#define ASSET_CACHE_DIR ".cache/"
+#define ASSET_ARENA_RESERVE MiB(256) // Per asset, address space only
+#define ASSET_ARENA_COMMIT KiB(64)
+#define ASSET_DEFAULT_CPU_BUDGET GiB(1ull)
+#define ASSET_DEFAULT_GPU_BUDGET GiB(2ull)
+
+// Slots live in fixed pages so pointers and handles survive registry growth
+typedef struct asset_slot {
+    rl_asset asset;
+    rl_arena arena; // Everything the loader allocated, released on eviction
+    u64 group_hash;
+    u64 sizes[ASSET_BUDGET_MAX];
+    u64 last_used_frame;
+    f32 priority;
+    u32 generation;
+    ASSET_STATE state;
+    b8 loading;       // A request for this slot is in flight
+    b8 reload_queued; // The source changed while it was
+    b8 pinned;        // Never evicted
+    b8 on_demand;     // Skipped by group loads
+    u64 source_mtime; // Of the source the resident data came from, what the pack records
+} asset_slot;
+
+// One in-flight load. The job decodes into `asset` and `arena`, the main thread publishes both to the slot.
+typedef struct asset_request {
+    u32 index;
+    rl_asset asset;
+    rl_arena arena;
+    u64 mapped_size; // Pack bytes the result points into
+    u64 source_mtime; // Read before decoding, an edit during the load leaves the cooked copy stale instead of wrong
+    b8 reload;       // The slot keeps serving the old data until this one is published
+    b8 success;
+    rl_job_counter counter;
+} asset_request;
+
+DA_DEFINE(asset_requests, asset_request *);
+DA_DEFINE(asset_arenas, rl_arena);
+
+typedef struct asset_bucket {
+    u64 hash; // 0 = empty
+    u32 index;
+} asset_bucket;
+
 typedef struct asset_system {
-    rl_arena asset_arena;
-    Assets assets;
+    rl_arena asset_arena; // Registry pages, names and the manifest
+    asset_manifest manifest;
+    char cache_dir[VFS_MAX_PATH]; // Real path, handed to renderers
+    asset_requests requests;
+
+    // Streaming
+    u64 frame;
+    u64 resident[ASSET_BUDGET_MAX];
+    u64 budgets[ASSET_BUDGET_MAX];
+    b8 over_budget_logged;
+
+    // Hot reload
+    rl_file_watch watch;
+    b8 pack_stale;  // Something was decoded from source since the last cook
+    i64 last_reload;
+    asset_arenas retired; // Replaced by a reload, a renderer or the app may still point into them
+
+    asset_slot *pages[ASSET_MAX_PAGES];
+    u32 count;
+
+    // Open addressing, linear probing, capacity is a power of two
+    asset_bucket *buckets;
+    u32 capacity;
 } asset_system;
 
 static asset_system *state;
 
+static asset_slot *get_slot(u32 index) {
+    return &state->pages[index >> ASSET_PAGE_SHIFT][index & (ASSET_PAGE_SIZE - 1)];
+}
+
+static void table_place(asset_bucket *buckets, u32 capacity, u64 hash, u32 index) {
+    u32 i = (u32)hash & (capacity - 1);
+    while (buckets[i].hash != 0) {
+        i = (i + 1) & (capacity - 1);
+    }
+    buckets[i] = (asset_bucket){hash, index};
+}
+
+static void table_insert(u64 hash, u32 index) {
+    if ((u64)(state->count + 1) * 100 > (u64)state->capacity * ASSET_TABLE_MAX_LOAD) {
+        u32 capacity = state->capacity ? state->capacity * 2 : ASSET_TABLE_MIN_CAPACITY;
+        asset_bucket *buckets = mem_alloc(capacity * sizeof(asset_bucket), MEM_SUBSYSTEM_ASSET);
+        mem_zero(buckets, capacity * sizeof(asset_bucket));
+
+        for (u32 i = 0; i < state->capacity; i++) {
+            if (state->buckets[i].hash != 0) {
+                table_place(buckets, capacity, state->buckets[i].hash, state->buckets[i].index);
+            }
+        }
+
+        if (state->buckets) {
+            mem_free(state->buckets, state->capacity * sizeof(asset_bucket), MEM_SUBSYSTEM_ASSET);
+        }
+        state->buckets = buckets;
+        state->capacity = capacity;
+    }
+
+    table_place(state->buckets, state->capacity, hash, index);
+}
+
+static rl_asset_handle make_handle(u32 index) {
+    return (rl_asset_handle){index, get_slot(index)->generation};
+}
+
 u32 get_asset_count() {
-    return state->assets.count;
+    return state->count;
+}
+
+rl_asset *get_asset_at(u32 index) {
+    return (index < state->count) ? &get_slot(index)->asset : nullptr;
+}
+
+u64 get_asset_source_mtime(u32 index) {
+    return (index < state->count) ? get_slot(index)->source_mtime : 0;
 }
 
-Assets *get_assets() {
-    return &state->assets;
+// Takes the next registry slot, inserts it into the table and returns it
+static asset_slot *slot_push(const rl_asset *asset) {
+    u32 index = state->count;
+    if (index >= ASSET_MAX_PAGES * ASSET_PAGE_SIZE) {
+        RL_ERROR("Asset registry is full, can't load '%s'", asset->filename);
+        return nullptr;
+    }
+
+    u32 page = index >> ASSET_PAGE_SHIFT;
+    if (!state->pages[page]) {
+        state->pages[page] = rl_arena_push(&state->asset_arena, ASSET_PAGE_SIZE * sizeof(asset_slot), true);
+    }
+
+    asset_slot *slot = get_slot(index);
+    slot->asset = *asset;
+    slot->asset.name_hash = asset_name_hash(asset->filename);
+    slot->generation++;
+    slot->state = ASSET_STATE_PENDING;
+
+    state->count++;
+    table_insert(slot->asset.name_hash, index);
+    return slot;
 }
 
 u64 asset_system_size() {
@@ -35,31 +181,447 @@ u64 asset_system_size() {
 
 b8 asset_system_start(void *system) {
     state = system;
-    rl_arena_init(&state->asset_arena, MiB(200), MiB(5), MEM_SUBSYSTEM_ASSET);
-    da_init(&state->assets);
+    mem_zero(state, sizeof(asset_system));
+    rl_arena_init(&state->asset_arena, MiB(16), MiB(1), MEM_SUBSYSTEM_ASSET);
+    da_init(&state->requests);
+    da_init(&state->retired);
+    state->budgets[ASSET_BUDGET_CPU] = ASSET_DEFAULT_CPU_BUDGET;
+    state->budgets[ASSET_BUDGET_GPU] = ASSET_DEFAULT_GPU_BUDGET;
+
+    vfs_system_start();
+    if (!vfs_mount_dir("", ASSET_ROOT_DIR)) {
+        return false;
+    }
+    if (vfs_real_path(ASSET_CACHE_DIR, state->cache_dir, sizeof(state->cache_dir))) {
+        platform_dir_create(state->cache_dir);
+    }
+
+    // Everything in the manifest is registered up front, so handles and asset_find work before it's loaded
+    if (!asset_manifest_load(ASSET_MANIFEST_PATH, &state->asset_arena, &state->manifest)) {
+        return false;
+    }
+    for (u32 i = 0; i < state->manifest.entry_count; i++) {
+        const asset_manifest_entry *entry = &state->manifest.entries[i];
+        if (asset_find(entry->asset.filename).generation != 0) {
+            RL_WARN("Asset manifest lists '%s' twice", entry->asset.filename);
+            continue;
+        }
+        asset_slot *slot = slot_push(&entry->asset);
+        if (!slot) {
+            break;
+        }
+        slot->state = ASSET_STATE_UNLOADED;
+        slot->group_hash = entry->group_hash;
+        slot->on_demand = entry->on_demand;
+    }
+
+    // Validated once, each asset is still checked against its source before it's resolved
+    vfs_mount_pack(ASSET_PACK_MOUNT, ASSET_PACK_FILE);
+
+    ASSET_TYPE watched[] = {ASSET_FONT, ASSET_SHADER, ASSET_TEXTURE, ASSET_MESH};
+    if (platform_file_watch_open(&state->watch)) {
+        for (u32 i = 0; i < sizeof(watched) / sizeof(watched[0]); i++) {
+            char dir[VFS_MAX_PATH];
+            if (vfs_real_path(get_assets_dir(watched[i]), dir, sizeof(dir))) {
+                platform_file_watch_add(&state->watch, dir);
+            }
+        }
+        RL_DEBUG("Watching asset directories for changes");
+    }
     return true;
 }
 
 void asset_system_shutdown() {
-    da_free(&state->assets);
+    // Jobs write into the request arenas, let them finish first
+    for (u64 i = 0; i < state->requests.count; i++) {
+        job_wait(&state->requests.items[i]->counter);
+        rl_arena_deinit(&state->requests.items[i]->arena);
+        mem_free(state->requests.items[i], sizeof(asset_request), MEM_SUBSYSTEM_ASSET);
+    }
+    da_free(&state->requests);
+
+    for (u32 i = 0; i < state->count; i++) {
+        asset_slot *slot = get_slot(i);
+        if (slot->arena.base) {
+            rl_arena_deinit(&slot->arena);
+        }
+    }
+    for (u64 i = 0; i < state->retired.count; i++) {
+        rl_arena_deinit(&state->retired.items[i]);
+    }
+    da_free(&state->retired);
+
+    platform_file_watch_close(&state->watch);
+
+    vfs_system_shutdown();
+    if (state->buckets) {
+        mem_free(state->buckets, state->capacity * sizeof(asset_bucket), MEM_SUBSYSTEM_ASSET);
+    }
     rl_arena_deinit(&state->asset_arena);
     state = nullptr;
 }
 
-b8 asset_system_load_all() {
-    b8 splash_active = splash_show();
+static void set_sizes(asset_slot *slot, u64 cpu_size, u64 gpu_size) {
+    state->resident[ASSET_BUDGET_CPU] += cpu_size - slot->sizes[ASSET_BUDGET_CPU];
+    state->resident[ASSET_BUDGET_GPU] += gpu_size - slot->sizes[ASSET_BUDGET_GPU];
+    slot->sizes[ASSET_BUDGET_CPU] = cpu_size;
+    slot->sizes[ASSET_BUDGET_GPU] = gpu_size;
+}
+
+// Points a slot straight into the pack if it has a current copy, on the calling thread
+static b8 resolve_from_pack(u32 index) {
+    asset_slot *slot = get_slot(index);
+    const rl_file_map *pack = vfs_pack(ASSET_PACK_MOUNT);
+    if (!pack || !asset_pack_is_fresh(pack, &slot->asset)) {
+        return false;
+    }
+
+    rl_arena_init(&slot->arena, ASSET_ARENA_RESERVE, ASSET_ARENA_COMMIT, MEM_SUBSYSTEM_ASSET);
+    if (!asset_pack_resolve(pack, &slot->arena, &slot->asset)) {
+        rl_arena_deinit(&slot->arena);
+        return false;
+    }
+
+    slot->state = ASSET_STATE_READY;
+    slot->last_used_frame = state->frame;
+    slot->source_mtime = asset_pack_cooked_mtime(pack, &slot->asset);
+    set_sizes(slot, slot->arena.pos + asset_pack_mapped_size(pack, &slot->asset), 0);
+
+    rl_asset_handle handle = make_handle(index);
+    event_fire(EVENT_ASSET_LOADED, &handle);
+    return true;
+}
+
+// Cooks the registry and remounts the new pack. The VFS keeps the old mapping alive, resolved assets point into it.
+// Only called with no loads in flight, remounting must not race the workers.
+static void write_pack() {
+    state->pack_stale = false;
+    char path[VFS_MAX_PATH];
+    if (!vfs_real_path(ASSET_PACK_FILE, path, sizeof(path)) || !asset_pack_write(path, vfs_pack(ASSET_PACK_MOUNT))) {
+        RL_WARN("Failed to write asset pack '%s'", ASSET_PACK_FILE);
+        return;
+    }
+    vfs_mount_pack(ASSET_PACK_MOUNT, ASSET_PACK_FILE);
+}
+
+static void asset_load_job(void *data) {
+    asset_request *request = data;
+    rl_arena *arena = &request->arena;
+
+    // Evicted assets come back from the pack while it's current, reloads always mean the source changed
+    const rl_file_map *pack = vfs_pack(ASSET_PACK_MOUNT);
+    if (!request->reload && pack && asset_pack_is_fresh(pack, &request->asset) &&
+        asset_pack_resolve(pack, arena, &request->asset)) {
+        request->mapped_size = asset_pack_mapped_size(pack, &request->asset);
+        request->source_mtime = asset_pack_cooked_mtime(pack, &request->asset);
+        request->success = true;
+        return;
+    }
+
+    request->source_mtime = asset_pack_source_mtime(&request->asset);
+
+    switch (request->asset.type) {
+    case ASSET_FONT:
+        request->success = rl_font_load(arena, &request->asset);
+        break;
+    case ASSET_SHADER:
+        request->success = load_shader(arena, &request->asset);
+        break;
+    case ASSET_TEXTURE:
+        request->success = load_texture(arena, &request->asset);
+        break;
+    case ASSET_MESH:
+        request->success = load_mesh(arena, &request->asset);
+        break;
+    }
+}
+
+static void queue_request(u32 index, b8 reload) {
+    asset_slot *slot = get_slot(index);
+    slot->loading = true;
+
+    if (!reload) {
+        slot->state = ASSET_STATE_PENDING;
+    }
+
+    asset_request *request = mem_alloc(sizeof(asset_request), MEM_SUBSYSTEM_ASSET);
+    *request = (asset_request){
+        .index = index,
+        .asset = slot->asset,
+        .reload = reload,
+    };
+    request->asset.handle = nullptr;
+    rl_arena_init(&request->arena, ASSET_ARENA_RESERVE, ASSET_ARENA_COMMIT, MEM_SUBSYSTEM_ASSET);
+    da_append(&state->requests, request);
+
+    job_run(&(rl_job){asset_load_job, request}, 1, &request->counter);
+}
+
+static rl_asset_handle queue_load(const rl_asset *asset) {
+    if (!slot_push(asset)) {
+        return (rl_asset_handle){0};
+    }
+
+    queue_request(state->count - 1, false);
+    return make_handle(state->count - 1);
+}
+
+// Re-imports a registered asset whose source changed, called by the file watcher
+static void on_file_changed(const char *filename, void *user_data) {
+    (void)user_data;
+    rl_asset_handle handle = asset_find(filename);
+    if (!asset_handle_valid(handle)) {
+        return; // Not an asset (editor temp files, caches)
+    }
+
+    asset_slot *slot = get_slot(handle.index);
+    if (slot->state == ASSET_STATE_EVICTED || slot->state == ASSET_STATE_UNLOADED) {
+        return; // Picks up the new source when it's touched
+    }
+    if (slot->loading) {
+        slot->reload_queued = true; // Pick up the newest version once the current load lands
+        return;
+    }
+
+    RL_DEBUG("'%s' changed, reloading", filename);
+    queue_request(handle.index, true);
+}
+
+static void finish_reload(asset_request *request) {
+    asset_slot *slot = get_slot(request->index);
+    if (!request->success) {
+        RL_WARN("Failed to reload '%s', keeping the previous version", slot->asset.filename);
+        rl_arena_deinit(&request->arena);
+        return;
+    }
+
+    // The previous data stays in its arena until shutdown, a renderer or the app may still point into it
+    if (slot->arena.base) {
+        da_append(&state->retired, slot->arena);
+    }
+    slot->arena = request->arena;
+    slot->asset.handle = request->asset.handle;
+    slot->source_mtime = request->source_mtime;
+    slot->state = ASSET_STATE_READY;
+    set_sizes(slot, slot->arena.pos + request->mapped_size, slot->sizes[ASSET_BUDGET_GPU]);
+    state->pack_stale = true;
+    state->last_reload = platform_get_clock_counter();
+
+    RL_INFO("Reloaded '%s'", slot->asset.filename);
+    rl_asset_handle handle = make_handle(request->index);
+    event_fire(EVENT_ASSET_RELOADED, &handle);
+}
+
+static void publish_load(asset_request *request) {
+    asset_slot *slot = get_slot(request->index);
+    slot->asset = request->asset;
+    slot->state = request->success ? ASSET_STATE_READY : ASSET_STATE_FAILED;
+    slot->last_used_frame = state->frame; // Give it a frame to be touched before it can be evicted
+
+    if (request->success) {
+        slot->arena = request->arena;
+        slot->source_mtime = request->source_mtime;
+        set_sizes(slot, slot->arena.pos + request->mapped_size, 0);
+
+        // Decoded from source, cook it in once loading settles
+        if (request->mapped_size == 0) {
+            state->pack_stale = true;
+            state->last_reload = platform_get_clock_counter();
+        }
+    } else {
+        rl_arena_deinit(&request->arena);
+    }
+
+    RL_TRACE("  '%s' = %s", slot->asset.filename, request->success ? "OK!" : "Failed");
+    event_fire(EVENT_SPLASH_INCREMENT, nullptr);
+    if (request->success) {
+        rl_asset_handle handle = make_handle(request->index);
+        event_fire(EVENT_ASSET_LOADED, &handle);
+    }
+}
+
+// Publishes a finished request, listeners of EVENT_ASSET_LOADED / RELOADED do their uploads here
+static void finish_load(asset_request *request) {
+    asset_slot *slot = get_slot(request->index);
+    slot->loading = false;
+
+    if (request->reload) {
+        finish_reload(request);
+    } else {
+        publish_load(request);
+    }
+
+    if (slot->reload_queued) {
+        slot->reload_queued = false;
+        queue_request(request->index, true);
+    }
+}
+
+// Finishes completed requests until `budget` clock ticks are spent, 0 = no limit. Returns how many finished.
+static u32 finish_loads(i64 budget) {
+    i64 start = platform_get_clock_counter();
+    u32 finished = 0;
+
+    for (u64 i = 0; i < state->requests.count;) {
+        asset_request *request = state->requests.items[i];
+        if (!job_is_done(&request->counter)) {
+            i++;
+            continue;
+        }
+
+        finish_load(request);
+        mem_free(request, sizeof(asset_request), MEM_SUBSYSTEM_ASSET);
+        state->requests.items[i] = state->requests.items[--state->requests.count];
+        finished++;
+
+        if (budget > 0 && platform_get_clock_counter() - start >= budget) {
+            break;
+        }
+    }
+    return finished;
+}
+
+// Members still in flight, including loads queued before the group was requested
+static b8 group_loading(u64 group_hash) {
+    for (u32 i = 0; i < state->count; i++) {
+        asset_slot *slot = get_slot(i);
+        if (slot->group_hash == group_hash && !slot->on_demand && slot->loading) {
+            return true;
+        }
+    }
+    return false;
+}
+
+b8 asset_system_load_startup() {
+    for (u32 i = 0; i < state->manifest.startup_group_count; i++) {
+        if (!asset_load_group(state->manifest.startup_groups[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static b8 over_budget(ASSET_BUDGET budget) {
+    return state->resident[budget] > state->budgets[budget];
+}
+
+// Least recently touched, then lowest priority, among what's holding memory of the exceeded budget
+static u32 find_victim(ASSET_BUDGET budget) {
+    u32 victim = UINT32_MAX;
+    for (u32 i = 0; i < state->count; i++) {
+        asset_slot *slot = get_slot(i);
+        if (slot->state != ASSET_STATE_READY || slot->pinned || slot->loading ||
+            slot->last_used_frame >= state->frame || slot->sizes[budget] == 0) {
+            continue;
+        }
+        asset_slot *best = victim != UINT32_MAX ? get_slot(victim) : nullptr;
+        if (!best || slot->last_used_frame < best->last_used_frame ||
+            (slot->last_used_frame == best->last_used_frame && slot->priority < best->priority)) {
+            victim = i;
+        }
+    }
+    return victim;
+}
+
+static void evict(u32 index) {
+    asset_slot *slot = get_slot(index);
+
+    // Listeners release their copies while the data is still valid
+    rl_asset_handle handle = make_handle(index);
+    event_fire(EVENT_ASSET_EVICTED, &handle);
+
+    RL_TRACE("Evicting '%s' (%llu KiB)", slot->asset.filename, slot->sizes[ASSET_BUDGET_CPU] / KiB(1));
+    set_sizes(slot, 0, slot->sizes[ASSET_BUDGET_GPU]); // GPU residency is reclaimed by the listener that frees it
+    rl_arena_deinit(&slot->arena);
+    slot->asset.handle = nullptr;
+    slot->state = ASSET_STATE_EVICTED;
+}
+
+static void enforce_budgets() {
+    for (ASSET_BUDGET budget = 0; budget < ASSET_BUDGET_MAX; budget++) {
+        while (over_budget(budget)) {
+            u32 victim = find_victim(budget);
+            if (victim == UINT32_MAX) {
+                // Everything left is pinned or in use this frame
+                if (!state->over_budget_logged) {
+                    RL_WARN("Asset %s budget exceeded (%llu / %llu MiB) by pinned or in-use assets",
+                            budget == ASSET_BUDGET_CPU ? "CPU" : "GPU",
+                            state->resident[budget] / MiB(1), state->budgets[budget] / MiB(1));
+                    state->over_budget_logged = true;
+                }
+                break;
+            }
+            evict(victim);
+        }
+    }
+}
+
+void asset_system_update() {
+    state->frame++;
+    platform_file_watch_poll(&state->watch, on_file_changed, nullptr);
+
+    i64 freq = platform_get_info()->clock_freq;
+    if (state->requests.count > 0) {
+        finish_loads(ASSET_FRAME_BUDGET_US * freq / 1000000);
+    }
+
+    enforce_budgets();
+
+    // Re-cook from memory once edits and source loads settle, so the next start maps them instead of decoding.
+    // The pack is replaced by rename, the current mapping stays valid.
+    if (state->pack_stale && state->requests.count == 0 &&
+        platform_get_clock_counter() - state->last_reload >= ASSET_RECOOK_DELAY_MS * freq / 1000) {
+        write_pack();
+    }
+}
+
+b8 asset_load_group(const char *group) {
+    u64 group_hash = cstr_hash(group);
+
+    // Start paging in the members' cooked blobs, the pack is otherwise read in random order
+    for (u32 i = 0; i < state->count; i++) {
+        asset_slot *slot = get_slot(i);
+        if (slot->group_hash == group_hash && !slot->on_demand && slot->state != ASSET_STATE_READY) {
+            char path[VFS_MAX_PATH];
+            snprintf(path, sizeof(path), "%s%s", ASSET_PACK_MOUNT, slot->asset.filename);
+            vfs_prefetch(path);
+        }
+    }
+
+    // Cooked members resolve right here, the rest decode on the workers
+    u32 queued = 0;
+    u32 member_count = 0;
+    for (u32 i = 0; i < state->count; i++) {
+        asset_slot *slot = get_slot(i);
+        if (slot->group_hash != group_hash || slot->on_demand) {
+            continue;
+        }
+        member_count++;
+        if (slot->state == ASSET_STATE_READY || slot->loading || resolve_from_pack(i)) {
+            continue;
+        }
+        queue_request(i, false);
+        queued++;
+    }
+
+    if (member_count == 0) {
+        RL_WARN("Asset group '%s' is empty or not in the manifest", group);
+        return true;
+    }
+
+    b8 splash_active = queued > 0 && splash_show(queued);
     if (splash_active) {
         splash_update();
     }
+    if (queued > 0) {
+        RL_DEBUG("Loading %u assets of '%s' on %u workers...", queued, group, job_worker_count());
+    }
 
-    RL_DEBUG("Loading assets...");
-    for (u32 i = 0; i < ASSET_TABLE_TOTAL; i++) {
-        b8 success = asset_system_load(&asset_table[i]);
-        if (!success) {
-            if (splash_active) {
-                splash_hide();
-            }
-            return false;
+    // The main thread is worker 0: it decodes too between splash updates, so the group finishes even when no
+    // worker thread could be started. Unrelated loads keep streaming, only their publishing happens here.
+    while (group_loading(group_hash)) {
+        if (finish_loads(0) == 0 && !job_try_run_one()) {
+            platform_sleep(1);
         }
         if (splash_active) {
             splash_update();
@@ -71,50 +633,158 @@ b8 asset_system_load_all() {
         splash_hide();
     }
 
-    return true;
-}
+    // Group members are what the app holds raw pointers to, keep them resident
+    b8 success = true;
+    for (u32 i = 0; i < state->count; i++) {
+        asset_slot *slot = get_slot(i);
+        if (slot->group_hash != group_hash || slot->on_demand) {
+            continue;
+        }
+        if (slot->state != ASSET_STATE_READY) {
+            RL_ERROR("Failed to load asset '%s'", slot->asset.filename);
+            success = false;
+            continue;
+        }
+        slot->pinned = true;
+    }
 
-b8 asset_system_load(rl_asset *asset) {
-    b8 success = false;
-    switch (asset->type) {
-    case ASSET_FONT:
-        success = rl_font_load(&state->asset_arena, asset);
-        break;
-    case ASSET_SHADER:
-        success = load_shader(&state->asset_arena, asset);
-        break;
-    case ASSET_TEXTURE:
-        success = load_texture(&state->asset_arena, asset);
+    // Cook what was just decoded, the next start maps it instead. Unrelated loads may still be reading the
+    // current pack, asset_system_update cooks once they drained.
+    if (queued > 0) {
+        if (state->requests.count == 0) {
+            write_pack();
+        } else {
+            state->pack_stale = true;
+        }
     }
 
-    RL_TRACE("  '%s' = %s", asset->filename, success ? "OK!" : "Failed");
-    da_append(&state->assets, *asset);
-    event_fire(EVENT_SPLASH_INCREMENT, nullptr);
+    RL_DEBUG("Loaded asset group '%s' (%u assets, %u from source)", group, member_count, queued);
     return success;
 }
 
-rl_asset *get_asset(const char *filename) {
-    for (u32 i = 0; i < state->assets.count; i++) {
-        if (strcmp(state->assets.items[i].filename, filename) == 0) {
-            return &state->assets.items[i];
+rl_asset_handle asset_load_async(ASSET_TYPE type, const char *filename) {
+    rl_asset_handle existing = asset_find(filename);
+    if (existing.generation != 0) {
+        asset_touch(existing, get_slot(existing.index)->priority);
+        return existing;
+    }
+
+    // The registry keeps the name, the caller's string may not outlive the load
+    rl_string name = rl_string_create(&state->asset_arena, filename);
+    return queue_load(&(rl_asset){.type = type, .filename = name.cstr});
+}
+
+ASSET_STATE asset_get_state(rl_asset_handle handle) {
+    return asset_handle_valid(handle) ? get_slot(handle.index)->state : ASSET_STATE_FAILED;
+}
+
+void asset_touch(rl_asset_handle handle, f32 priority) {
+    if (!asset_handle_valid(handle)) {
+        return;
+    }
+
+    asset_slot *slot = get_slot(handle.index);
+    slot->last_used_frame = state->frame;
+    slot->priority = priority;
+    if ((slot->state == ASSET_STATE_EVICTED || slot->state == ASSET_STATE_UNLOADED) && !slot->loading) {
+        queue_request(handle.index, false);
+    }
+}
+
+void asset_set_pinned(rl_asset_handle handle, b8 pinned) {
+    if (asset_handle_valid(handle)) {
+        get_slot(handle.index)->pinned = pinned;
+    }
+}
+
+void asset_set_gpu_size(rl_asset_handle handle, u64 size) {
+    if (asset_handle_valid(handle)) {
+        asset_slot *slot = get_slot(handle.index);
+        set_sizes(slot, slot->sizes[ASSET_BUDGET_CPU], size);
+    }
+}
+
+void asset_set_budget(ASSET_BUDGET budget, u64 size) {
+    state->budgets[budget] = size;
+    state->over_budget_logged = false;
+}
+
+u64 asset_get_resident_size(ASSET_BUDGET budget) {
+    return state->resident[budget];
+}
+
+u64 asset_name_hash(const char *filename) {
+    u64 hash = cstr_hash(filename);
+    return hash ? hash : 1; // 0 marks empty buckets
+}
+
+rl_asset_handle asset_find_hash(u64 name_hash) {
+    if (state->capacity == 0) {
+        return (rl_asset_handle){0};
+    }
+
+    for (u32 i = (u32)name_hash & (state->capacity - 1); state->buckets[i].hash != 0; i = (i + 1) & (state->capacity - 1)) {
+        if (state->buckets[i].hash == name_hash) {
+            return make_handle(state->buckets[i].index);
+        }
+    }
+    return (rl_asset_handle){0};
+}
+
+rl_asset_handle asset_find(const char *filename) {
+    if (state->capacity == 0) {
+        return (rl_asset_handle){0};
+    }
+
+    // Compare names too, so a hash collision can't return the wrong asset
+    u64 name_hash = asset_name_hash(filename);
+    for (u32 i = (u32)name_hash & (state->capacity - 1); state->buckets[i].hash != 0; i = (i + 1) & (state->capacity - 1)) {
+        if (state->buckets[i].hash == name_hash && strcmp(get_slot(state->buckets[i].index)->asset.filename, filename) == 0) {
+            return make_handle(state->buckets[i].index);
         }
     }
+    return (rl_asset_handle){0};
+}
+
+b8 asset_handle_valid(rl_asset_handle handle) {
+    return handle.generation != 0 && handle.index < state->count && get_slot(handle.index)->generation == handle.generation;
+}
+
+rl_asset *asset_get(rl_asset_handle handle) {
+    if (asset_get_state(handle) != ASSET_STATE_READY) {
+        return nullptr;
+    }
 
-    RL_FATAL("FAILED TO FIND ASSET '%s'", filename);
-    return nullptr;
+    asset_slot *slot = get_slot(handle.index);
+    slot->last_used_frame = state->frame;
+    return &slot->asset;
+}
+
+rl_asset *get_asset(const char *filename) {
+    rl_asset *asset = asset_get(asset_find(filename));
+    if (!asset) {
+        RL_FATAL("FAILED TO FIND ASSET '%s'", filename);
+    }
+    return asset;
 }
 
 const char *get_assets_dir(ASSET_TYPE asset_type) {
     switch (asset_type) {
     case ASSET_FONT:
-        return "../../../assets/fonts/";
+        return "fonts/";
     case ASSET_SHADER:
-        return "../../../assets/shaders/";
+        return "shaders/";
     case ASSET_TEXTURE:
-        return "../../../assets/textures/";
+        return "textures/";
+    case ASSET_MESH:
+        return "meshes/";
     default:
         break;
     }
 
-    return "../../../assets/";
+    return "";
+}
+
+const char *get_cache_dir() {
+    return state->cache_dir;
 }
@@ -1,17 +1,15 @@
 #pragma once
 
-#include "memory/containers/dynamic_array.h"
 #include <asset/asset.h>
 
-DA_DEFINE(Assets, rl_asset);
-
 u64 asset_system_size();
 b8 asset_system_start(void *system);
 void asset_system_shutdown();
 
-b8 asset_system_load_all();
-b8 asset_system_load(rl_asset *asset);
+b8 asset_system_load_startup(); // The manifest's "startup" groups
+void asset_system_update(); // Publishes finished async loads, once per frame
 
-Assets *get_assets();
+rl_asset *get_asset_at(u32 index); // Registry order, 0 .. get_asset_count()
+u64 get_asset_source_mtime(u32 index); // Of the source the resident data came from, read when it was loaded
 
 u32 get_asset_count();
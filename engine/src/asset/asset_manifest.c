@@ -0,0 +1,100 @@
+#include "asset/asset_manifest.h"
+
+#include "asset/vfs.h"
+#include "core/logger.h"
+#include "memory/memory.h"
+#include "util/str.h"
+
+#include "yyjson.h"
+
+#include <string.h>
+
+static b8 parse_type(const char *name, ASSET_TYPE *out_type) {
+    if (strcmp(name, "font") == 0) {
+        *out_type = ASSET_FONT;
+    } else if (strcmp(name, "shader") == 0) {
+        *out_type = ASSET_SHADER;
+    } else if (strcmp(name, "texture") == 0) {
+        *out_type = ASSET_TEXTURE;
+    } else if (strcmp(name, "mesh") == 0) {
+        *out_type = ASSET_MESH;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static b8 parse_entry(yyjson_val *val, asset_manifest_entry *out_entry) {
+    const char *file = yyjson_get_str(yyjson_obj_get(val, "file"));
+    const char *type = yyjson_get_str(yyjson_obj_get(val, "type"));
+    if (!file || !type || !parse_type(type, &out_entry->asset.type)) {
+        return false;
+    }
+
+    const char *group = yyjson_get_str(yyjson_obj_get(val, "group"));
+    out_entry->asset.filename = file;
+    out_entry->group_hash = cstr_hash(group ? group : ASSET_DEFAULT_GROUP);
+    out_entry->on_demand = yyjson_is_true(yyjson_obj_get(val, "on_demand"));
+    return true;
+}
+
+b8 asset_manifest_load(const char *path, rl_arena *arena, asset_manifest *out_manifest) {
+    rl_vfs_file file;
+    if (!vfs_open(path, FILE_ACCESS_SEQUENTIAL, &file)) {
+        RL_ERROR("Failed to open asset manifest '%s'", path);
+        return false;
+    }
+
+    // The in-situ reader terminates strings inside the buffer, so it lives as long as the registry
+    char *json = rl_arena_push(arena, file.size + YYJSON_PADDING_SIZE, true);
+    mem_copy((void *)file.data, json, file.size);
+    u64 json_size = file.size;
+    vfs_close(&file);
+
+    // The DOM is only walked once, keep it in scratch memory
+    rl_temp_arena scratch = rl_arena_scratch_get();
+    yyjson_read_flag flags = YYJSON_READ_INSITU | YYJSON_READ_ALLOW_COMMENTS | YYJSON_READ_ALLOW_TRAILING_COMMAS;
+    u64 pool_size = yyjson_read_max_memory_usage(json_size, flags);
+    yyjson_alc alc;
+    yyjson_alc_pool_init(&alc, rl_arena_push(scratch.arena, pool_size, false), pool_size);
+
+    yyjson_read_err err;
+    yyjson_doc *doc = yyjson_read_opts(json, json_size, flags, &alc, &err);
+    if (!doc) {
+        RL_ERROR("Asset manifest '%s': %s at byte %llu", path, err.msg, (u64)err.pos);
+        arena_scratch_release(scratch);
+        return false;
+    }
+
+    yyjson_val *root = yyjson_doc_get_root(doc);
+    yyjson_val *assets = yyjson_obj_get(root, "assets");
+    yyjson_val *startup = yyjson_obj_get(root, "startup");
+
+    u32 asset_count = (u32)yyjson_arr_size(assets);
+    out_manifest->entries = rl_arena_push(arena, asset_count * sizeof(asset_manifest_entry), true);
+    out_manifest->entry_count = 0;
+
+    u64 idx, max;
+    yyjson_val *val;
+    yyjson_arr_foreach(assets, idx, max, val) {
+        asset_manifest_entry *entry = &out_manifest->entries[out_manifest->entry_count];
+        if (!parse_entry(val, entry)) {
+            RL_WARN("Asset manifest '%s': skipping entry %llu, needs a \"file\" and a known \"type\"", path, idx);
+            continue;
+        }
+        out_manifest->entry_count++;
+    }
+
+    u32 group_count = (u32)yyjson_arr_size(startup);
+    out_manifest->startup_groups = rl_arena_push(arena, group_count * sizeof(const char *), true);
+    out_manifest->startup_group_count = 0;
+    yyjson_arr_foreach(startup, idx, max, val) {
+        if (yyjson_is_str(val)) {
+            out_manifest->startup_groups[out_manifest->startup_group_count++] = yyjson_get_str(val);
+        }
+    }
+
+    arena_scratch_release(scratch);
+    RL_DEBUG("Asset manifest: %u assets, %u startup groups", out_manifest->entry_count, out_manifest->startup_group_count);
+    return true;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "defines.h"
+#include "asset/asset.h"
+
+#include "memory/arena.h"
+
+/* Asset manifest
+ *  assets/manifest.json lists every asset the engine may load:
+ *
+ *    {
+ *        "startup": ["engine"],
+ *        "assets": [
+ *            { "file": "face.jpg", "type": "texture", "group": "engine" },
+ *            { "file": "level1.jpg", "type": "texture", "group": "level1", "on_demand": true }
+ *        ]
+ *    }
+ *
+ *  Every entry is registered when the asset system starts, so handles and asset_find work before anything
+ *  loads. Groups load as a unit through asset_load_group, the "startup" ones during engine init. Group loads
+ *  skip on-demand entries, they stream in on the first asset_touch / asset_load_async.
+ */
+
+#define ASSET_MANIFEST_PATH "manifest.json" // Virtual path, at the root of the asset mount
+#define ASSET_DEFAULT_GROUP "default" // For entries without a "group"
+
+typedef struct asset_manifest_entry {
+    rl_asset asset;
+    u64 group_hash; // cstr_hash of the group name
+    b8 on_demand;
+} asset_manifest_entry;
+
+typedef struct asset_manifest {
+    asset_manifest_entry *entries;
+    u32 entry_count;
+    const char **startup_groups;
+    u32 startup_group_count;
+} asset_manifest;
+
+// Parses the virtual file `path` in place, every string stays valid for the lifetime of `arena`
+b8 asset_manifest_load(const char *path, rl_arena *arena, asset_manifest *out_manifest);
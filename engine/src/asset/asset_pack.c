@@ -0,0 +1,490 @@
+#include "asset/asset_pack.h"
+
+#include "asset/asset_internal.h"
+#include "asset/font.h"
+#include "asset/mesh.h"
+#include "asset/shader.h"
+#include "asset/texture.h"
+#include "asset/texture_compress.h"
+#include "asset/vfs.h"
+#include "core/job.h"
+#include "core/logger.h"
+#include "memory/memory.h"
+#include "util/str.h"
+
+#include <stdlib.h>
+
+#define RPAK_MAGIC 0x4B415052 // "RPAK"
+#define RPAK_VERSION 3
+#define RPAK_ALIGN KiB(4)   // Blob alignment, one page
+#define RPAK_BLOB_HEADER 64 // Payload starts one cache line into each blob
+
+#define RPAK_ALIGN_UP(n, p) (((u64)(n) + ((u64)(p) - 1)) & ~((u64)(p) - 1))
+
+typedef struct rpak_header {
+    u32 magic;
+    u32 version;
+    u32 entry_count;
+    u32 alignment;
+    u64 file_size;
+} rpak_header;
+
+typedef struct rpak_entry {
+    u64 name_hash;
+    u64 source_mtime;
+    u64 offset;
+    u64 size;
+    u32 type;
+    u32 reserved;
+} rpak_entry;
+
+typedef struct rpak_texture {
+    i32 width, height, channels;
+    u32 format; // TEXTURE_FORMAT
+    u32 mip_count;
+    u32 reserved;
+    u64 size;
+} rpak_texture;
+
+typedef struct rpak_shader {
+    u32 type;
+    u32 source_len; // Without the null terminator
+} rpak_shader;
+
+typedef struct rpak_font {
+    f32 ascender;
+    f32 descender;
+    f64 line_height;
+    f32 scale;
+    f32 pixel_range;
+    u32 glyph_count; // Glyphs follow the blob header
+    i32 atlas_width, atlas_height, atlas_channels;
+    u64 atlas_size;
+    u64 atlas_offset; // From blob start
+} rpak_font;
+
+typedef struct rpak_mesh {
+    u32 vertex_count; // Vertices follow the blob header
+    u32 index_count;
+    u32 submesh_count;
+    u32 index_type; // MESH_INDEX_TYPE
+    f32 bounds_min[3];
+    f32 bounds_max[3];
+    u32 lod_count;
+    u64 index_offset;   // From blob start
+    u64 submesh_offset; // Submeshes of every LOD, then the LOD table
+} rpak_mesh;
+
+STATIC_ASSERT(sizeof(rpak_texture) <= RPAK_BLOB_HEADER, "rpak_texture must fit the blob header");
+STATIC_ASSERT(sizeof(rpak_shader) <= RPAK_BLOB_HEADER, "rpak_shader must fit the blob header");
+STATIC_ASSERT(sizeof(rpak_font) <= RPAK_BLOB_HEADER, "rpak_font must fit the blob header");
+STATIC_ASSERT(sizeof(rpak_mesh) <= RPAK_BLOB_HEADER, "rpak_mesh must fit the blob header");
+
+typedef struct pack_item {
+    rpak_entry entry;
+    const rl_asset *asset;
+    const u8 *cooked; // Blob in the previous pack, for assets that aren't resident
+    u8 *blob;
+    TEXTURE_FORMAT texture_format; // What a texture is cooked to, decoded sources get block compressed
+    u32 texture_mip_count;
+    b8 failed; // Set by the job, the cook is abandoned
+} pack_item;
+
+u64 asset_pack_source_mtime(const rl_asset *asset) {
+    rl_temp_arena scratch = rl_arena_scratch_get();
+    rl_string path = rl_string_format(scratch.arena, "%s%s", get_assets_dir(asset->type), asset->filename);
+    u64 mtime = vfs_mtime(path.cstr);
+    arena_scratch_release(scratch);
+    return mtime;
+}
+
+static u64 font_glyphs_size(const rl_font *font) {
+    return RPAK_ALIGN_UP(font->glyph_count * sizeof(rl_glyph), RPAK_BLOB_HEADER);
+}
+
+static u64 mesh_index_offset(const rl_mesh *mesh) {
+    return RPAK_BLOB_HEADER + RPAK_ALIGN_UP(mesh->vertex_count * sizeof(rl_mesh_vertex), RPAK_BLOB_HEADER);
+}
+
+static u64 mesh_submesh_offset(const rl_mesh *mesh) {
+    return mesh_index_offset(mesh) + RPAK_ALIGN_UP((u64)mesh->index_count * mesh_index_size(mesh->index_type), RPAK_BLOB_HEADER);
+}
+
+static u64 mesh_lod_offset(const rl_mesh *mesh) {
+    return mesh_submesh_offset(mesh) + (u64)mesh->submesh_count * mesh->lod_count * sizeof(rl_submesh);
+}
+
+static u64 blob_size(const pack_item *item) {
+    const rl_asset *asset = item->asset;
+    switch (asset->type) {
+    case ASSET_TEXTURE: {
+        const rl_texture *texture = asset->handle;
+        return RPAK_BLOB_HEADER + texture_level_offset(item->texture_format, texture->width, texture->height, item->texture_mip_count);
+    }
+    case ASSET_SHADER: {
+        const rl_asset_shader *shader = asset->handle;
+        return RPAK_BLOB_HEADER + cstr_len(shader->source) + 1;
+    }
+    case ASSET_FONT: {
+        const rl_font *font = asset->handle;
+        return RPAK_BLOB_HEADER + font_glyphs_size(font) + font->atlas.size;
+    }
+    case ASSET_MESH: {
+        const rl_mesh *mesh = asset->handle;
+        return mesh_lod_offset(mesh) + mesh->lod_count * sizeof(rl_mesh_lod);
+    }
+    }
+    return 0;
+}
+
+// Job entry, one per item. Textures are encoded straight into the mapping.
+static void blob_write(void *data) {
+    pack_item *item = data;
+    const rl_asset *asset = item->asset;
+    u8 *blob = item->blob;
+
+    if (item->cooked) {
+        mem_copy((void *)item->cooked, blob, item->entry.size);
+        return;
+    }
+
+    switch (asset->type) {
+    case ASSET_TEXTURE: {
+        const rl_texture *texture = asset->handle;
+        *(rpak_texture *)blob = (rpak_texture){
+            .width = texture->width,
+            .height = texture->height,
+            .channels = texture->channels,
+            .format = item->texture_format,
+            .mip_count = item->texture_mip_count,
+            .size = item->entry.size - RPAK_BLOB_HEADER,
+        };
+        if (item->texture_format == texture->format) {
+            mem_copy(texture->data, blob + RPAK_BLOB_HEADER, texture->size);
+        } else {
+            item->failed = !texture_compress(texture, item->texture_format, item->texture_mip_count, blob + RPAK_BLOB_HEADER);
+        }
+    } break;
+    case ASSET_SHADER: {
+        const rl_asset_shader *shader = asset->handle;
+        u32 len = cstr_len(shader->source);
+        *(rpak_shader *)blob = (rpak_shader){shader->type, len};
+        mem_copy((void *)shader->source, blob + RPAK_BLOB_HEADER, len + 1);
+    } break;
+    case ASSET_FONT: {
+        const rl_font *font = asset->handle;
+        u64 atlas_offset = RPAK_BLOB_HEADER + font_glyphs_size(font);
+        *(rpak_font *)blob = (rpak_font){
+            .ascender = font->ascender,
+            .descender = font->descender,
+            .line_height = font->line_height,
+            .scale = font->scale,
+            .pixel_range = font->pixel_range,
+            .glyph_count = font->glyph_count,
+            .atlas_width = font->atlas.width,
+            .atlas_height = font->atlas.height,
+            .atlas_channels = font->atlas.channels,
+            .atlas_size = font->atlas.size,
+            .atlas_offset = atlas_offset,
+        };
+        mem_copy(font->glyphs, blob + RPAK_BLOB_HEADER, font->glyph_count * sizeof(rl_glyph));
+        mem_copy(font->atlas.data, blob + atlas_offset, font->atlas.size);
+    } break;
+    case ASSET_MESH: {
+        const rl_mesh *mesh = asset->handle;
+        rpak_mesh *dst = (rpak_mesh *)blob;
+        *dst = (rpak_mesh){
+            .vertex_count = mesh->vertex_count,
+            .index_count = mesh->index_count,
+            .submesh_count = mesh->submesh_count,
+            .index_type = mesh->index_type,
+            .lod_count = mesh->lod_count,
+            .index_offset = mesh_index_offset(mesh),
+            .submesh_offset = mesh_submesh_offset(mesh),
+        };
+        mem_copy((void *)mesh->bounds_min, dst->bounds_min, sizeof(dst->bounds_min));
+        mem_copy((void *)mesh->bounds_max, dst->bounds_max, sizeof(dst->bounds_max));
+        mem_copy(mesh->vertices, blob + RPAK_BLOB_HEADER, mesh->vertex_count * sizeof(rl_mesh_vertex));
+        mem_copy(mesh->indices, blob + dst->index_offset, (u64)mesh->index_count * mesh_index_size(mesh->index_type));
+        mem_copy(mesh->submeshes, blob + dst->submesh_offset, (u64)mesh->submesh_count * mesh->lod_count * sizeof(rl_submesh));
+        mem_copy(mesh->lods, blob + mesh_lod_offset(mesh), mesh->lod_count * sizeof(rl_mesh_lod));
+    } break;
+    }
+}
+
+static int compare_items(const void *a, const void *b) {
+    u64 ha = ((const pack_item *)a)->entry.name_hash;
+    u64 hb = ((const pack_item *)b)->entry.name_hash;
+    return (ha > hb) - (ha < hb);
+}
+
+static const rpak_entry *pack_entries(const rl_file_map *pack) {
+    return (const rpak_entry *)(pack->data + sizeof(rpak_header));
+}
+
+static const rpak_entry *pack_find(const rl_file_map *pack, u64 name_hash) {
+    const rpak_entry *entries = pack_entries(pack);
+    u32 lo = 0;
+    u32 hi = ((const rpak_header *)pack->data)->entry_count;
+    while (lo < hi) {
+        u32 mid = lo + (hi - lo) / 2;
+        if (entries[mid].name_hash < name_hash) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return (lo < ((const rpak_header *)pack->data)->entry_count && entries[lo].name_hash == name_hash) ? &entries[lo] : nullptr;
+}
+
+b8 asset_pack_write(const char *path, const rl_file_map *previous) {
+    u32 asset_count = get_asset_count();
+    pack_item *items = mem_alloc(asset_count * sizeof(pack_item), MEM_SUBSYSTEM_ASSET);
+
+    u32 count = 0;
+    for (u32 i = 0; i < asset_count; i++) {
+        const rl_asset *asset = get_asset_at(i);
+        if (!asset->handle) {
+            // Not loaded this run (other groups, evicted), keep its cooked copy if it's still current
+            if (previous && previous->data && asset_pack_is_fresh(previous, asset)) {
+                const rpak_entry *entry = pack_find(previous, asset->name_hash);
+                items[count++] = (pack_item){
+                    .entry = *entry,
+                    .asset = asset,
+                    .cooked = previous->data + entry->offset,
+                };
+            }
+            continue; // Otherwise it failed to load, leave it to the source path next run
+        }
+        pack_item *item = &items[count++];
+        *item = (pack_item){
+            .entry = {
+                .name_hash = asset->name_hash,
+                .source_mtime = get_asset_source_mtime(i), // Of what was decoded, the file may have changed since
+                .type = asset->type,
+            },
+            .asset = asset,
+        };
+        if (asset->type == ASSET_TEXTURE) {
+            const rl_texture *texture = asset->handle;
+            item->texture_format = texture_cook_format(texture, asset->filename);
+            item->texture_mip_count = item->texture_format == texture->format
+                                          ? texture->mip_count
+                                          : texture_mip_count_full(texture->width, texture->height);
+        }
+        item->entry.size = blob_size(item);
+    }
+    qsort(items, count, sizeof(pack_item), compare_items);
+
+    u64 offset = RPAK_ALIGN_UP(sizeof(rpak_header) + count * sizeof(rpak_entry), RPAK_ALIGN);
+    for (u32 i = 0; i < count; i++) {
+        items[i].entry.offset = offset;
+        offset = RPAK_ALIGN_UP(offset + items[i].entry.size, RPAK_ALIGN);
+    }
+    u64 file_size = offset;
+
+    // Cook next to the real pack and swap it in, so a crash never leaves a torn pack behind
+    rl_temp_arena scratch = rl_arena_scratch_get();
+    rl_string tmp_path = rl_string_format(scratch.arena, "%s.tmp", path);
+
+    rl_file_map map = {0};
+    if (!platform_file_map_create(tmp_path.cstr, file_size, &map)) {
+        arena_scratch_release(scratch);
+        mem_free(items, asset_count * sizeof(pack_item), MEM_SUBSYSTEM_ASSET);
+        return false;
+    }
+
+    *(rpak_header *)map.data = (rpak_header){
+        .magic = RPAK_MAGIC,
+        .version = RPAK_VERSION,
+        .entry_count = count,
+        .alignment = RPAK_ALIGN,
+        .file_size = file_size,
+    };
+
+    rpak_entry *entries = (rpak_entry *)(map.data + sizeof(rpak_header));
+    rl_job *jobs = rl_arena_push(scratch.arena, count * sizeof(rl_job), false);
+    for (u32 i = 0; i < count; i++) {
+        entries[i] = items[i].entry;
+        items[i].blob = map.data + items[i].entry.offset;
+        jobs[i] = (rl_job){blob_write, &items[i]};
+    }
+
+    rl_job_counter counter = {0};
+    job_run(jobs, count, &counter);
+    job_wait(&counter);
+
+    platform_file_map_close(&map, file_size);
+    b8 success = true;
+    for (u32 i = 0; i < count && success; i++) {
+        if (items[i].failed) {
+            RL_ERROR("Failed to cook '%s'", items[i].asset->filename);
+            success = false;
+        }
+    }
+    if (success) {
+        success = platform_file_rename(tmp_path.cstr, path);
+    } else {
+        platform_file_delete(tmp_path.cstr);
+    }
+    if (success) {
+        RL_INFO("Cooked %u assets into '%s' (%llu KiB)", count, path, file_size / KiB(1));
+    }
+
+    arena_scratch_release(scratch);
+    mem_free(items, asset_count * sizeof(pack_item), MEM_SUBSYSTEM_ASSET);
+    return success;
+}
+
+b8 asset_pack_open(const char *path, rl_file_map *out_pack) {
+    if (!platform_file_map_open(path, out_pack)) {
+        return false;
+    }
+
+    const rpak_header *header = (const rpak_header *)out_pack->data;
+    b8 valid = out_pack->size >= sizeof(rpak_header) &&
+               header->magic == RPAK_MAGIC &&
+               header->version == RPAK_VERSION &&
+               header->alignment == RPAK_ALIGN &&
+               header->file_size == out_pack->size &&
+               sizeof(rpak_header) + (u64)header->entry_count * sizeof(rpak_entry) <= out_pack->size;
+
+    const rpak_entry *entries = pack_entries(out_pack);
+    for (u32 i = 0; valid && i < header->entry_count; i++) {
+        valid = entries[i].offset % RPAK_ALIGN == 0 &&
+                entries[i].size >= RPAK_BLOB_HEADER &&
+                entries[i].offset + entries[i].size <= out_pack->size;
+    }
+
+    if (!valid) {
+        RL_WARN("Asset pack '%s' is invalid, ignoring it", path);
+        asset_pack_close(out_pack);
+        return false;
+    }
+    return true;
+}
+
+void asset_pack_close(rl_file_map *pack) {
+    platform_file_map_close(pack, pack->size);
+}
+
+b8 asset_pack_is_fresh(const rl_file_map *pack, const rl_asset *asset) {
+    const rpak_entry *entry = pack_find(pack, asset_name_hash(asset->filename));
+    if (!entry || entry->type != (u32)asset->type) {
+        return false;
+    }
+
+    // A missing source is fine, shipped builds only carry the pack
+    u64 mtime = asset_pack_source_mtime(asset);
+    return mtime == 0 || mtime == entry->source_mtime;
+}
+
+u64 asset_pack_cooked_mtime(const rl_file_map *pack, const rl_asset *asset) {
+    const rpak_entry *entry = pack_find(pack, asset_name_hash(asset->filename));
+    return entry ? entry->source_mtime : 0;
+}
+
+b8 asset_pack_resolve(const rl_file_map *pack, rl_arena *arena, rl_asset *asset) {
+    const rpak_entry *entry = pack_find(pack, asset_name_hash(asset->filename));
+    if (!entry || entry->type != (u32)asset->type) {
+        return false;
+    }
+
+    u8 *blob = pack->data + entry->offset;
+    u64 payload = entry->size - RPAK_BLOB_HEADER;
+
+    switch (asset->type) {
+    case ASSET_TEXTURE: {
+        const rpak_texture *src = (const rpak_texture *)blob;
+        if (src->size > payload || src->format > TEXTURE_FORMAT_BC7 || src->mip_count == 0 ||
+            src->size != texture_level_offset(src->format, src->width, src->height, src->mip_count)) {
+            return false;
+        }
+        rl_texture *texture = rl_arena_push(arena, sizeof(rl_texture), true);
+        texture->width = src->width;
+        texture->height = src->height;
+        texture->channels = src->channels;
+        texture->format = (TEXTURE_FORMAT)src->format;
+        texture->mip_count = src->mip_count;
+        texture->size = src->size;
+        texture->data = blob + RPAK_BLOB_HEADER;
+        asset->handle = texture;
+    } break;
+    case ASSET_SHADER: {
+        const rpak_shader *src = (const rpak_shader *)blob;
+        if ((u64)src->source_len + 1 > payload) {
+            return false;
+        }
+        rl_asset_shader *shader = rl_arena_push(arena, sizeof(rl_asset_shader), true);
+        shader->source = (const char *)(blob + RPAK_BLOB_HEADER);
+        shader->type = (SHADER_TYPE)src->type;
+        asset->handle = shader;
+    } break;
+    case ASSET_FONT: {
+        const rpak_font *src = (const rpak_font *)blob;
+        if (RPAK_BLOB_HEADER + (u64)src->glyph_count * sizeof(rl_glyph) > src->atlas_offset ||
+            src->atlas_offset + src->atlas_size > entry->size) {
+            return false;
+        }
+        rl_font *font = rl_arena_push(arena, sizeof(rl_font), true);
+        font->name = asset->filename;
+        font->path = ASSET_PACK_FILE;
+        font->glyphs = (rl_glyph *)(blob + RPAK_BLOB_HEADER);
+        font->glyph_count = src->glyph_count;
+        font->ascender = src->ascender;
+        font->descender = src->descender;
+        font->line_height = src->line_height;
+        font->scale = src->scale;
+        font->pixel_range = src->pixel_range;
+        font->atlas = (rl_texture){
+            .width = src->atlas_width,
+            .height = src->atlas_height,
+            .channels = src->atlas_channels,
+            .size = src->atlas_size,
+            .data = blob + src->atlas_offset,
+        };
+        asset->handle = font;
+    } break;
+    case ASSET_MESH: {
+        const rpak_mesh *src = (const rpak_mesh *)blob;
+        u64 lod_offset = src->submesh_offset + (u64)src->submesh_count * src->lod_count * sizeof(rl_submesh);
+        if (src->index_type > MESH_INDEX_U32 || src->lod_count == 0 || src->lod_count > MESH_MAX_LODS ||
+            RPAK_BLOB_HEADER + (u64)src->vertex_count * sizeof(rl_mesh_vertex) > src->index_offset ||
+            src->index_offset + (u64)src->index_count * mesh_index_size(src->index_type) > src->submesh_offset ||
+            lod_offset + src->lod_count * sizeof(rl_mesh_lod) > entry->size) {
+            return false;
+        }
+        // Vertex and index data upload straight from the mapping
+        rl_mesh *mesh = rl_arena_push(arena, sizeof(rl_mesh), true);
+        mesh->vertices = (rl_mesh_vertex *)(blob + RPAK_BLOB_HEADER);
+        mesh->indices = blob + src->index_offset;
+        mesh->submeshes = (rl_submesh *)(blob + src->submesh_offset);
+        mesh->lods = (rl_mesh_lod *)(blob + lod_offset);
+        mesh->lod_count = src->lod_count;
+        mesh->vertex_count = src->vertex_count;
+        mesh->index_count = src->index_count;
+        mesh->submesh_count = src->submesh_count;
+        mesh->index_type = (MESH_INDEX_TYPE)src->index_type;
+        mem_copy((void *)src->bounds_min, mesh->bounds_min, sizeof(mesh->bounds_min));
+        mem_copy((void *)src->bounds_max, mesh->bounds_max, sizeof(mesh->bounds_max));
+        asset->handle = mesh;
+    } break;
+    }
+
+    return true;
+}
+
+u64 asset_pack_mapped_size(const rl_file_map *pack, const rl_asset *asset) {
+    const rpak_entry *entry = pack_find(pack, asset_name_hash(asset->filename));
+    return entry ? entry->size : 0;
+}
+
+b8 asset_pack_blob(const rl_file_map *pack, u64 name_hash, u64 *out_offset, u64 *out_size) {
+    const rpak_entry *entry = pack_find(pack, name_hash);
+    if (!entry) {
+        return false;
+    }
+    *out_offset = entry->offset;
+    *out_size = entry->size;
+    return true;
+}
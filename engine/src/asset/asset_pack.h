@@ -0,0 +1,38 @@
+#pragma once
+
+#include "defines.h"
+#include "asset/asset.h"
+
+#include "memory/arena.h"
+#include "platform/io/file_io.h"
+
+/* .rpak cooked asset pack
+ *  Header, then a table of contents sorted by name hash, then one page aligned blob per asset.
+ *  Blobs hold block compressed texture mip chains, shader source, font glyph tables / atlases and
+ *  optimized mesh vertex / index buffers exactly as the runtime uses them, so resolving an asset only
+ *  points its structs into the mapping.
+ */
+
+#define ASSET_PACK_FILE "assets.rpak" // Virtual path, next to the manifest
+#define ASSET_PACK_MOUNT "cooked/"     // Where the pack's blobs show up in the VFS
+
+// Cooks every loaded asset in the registry into the real file `path`, unloaded ones are carried over from `previous` (may be nullptr)
+b8 asset_pack_write(const char *path, const rl_file_map *previous);
+
+// Maps `path` and validates its header and table of contents
+b8 asset_pack_open(const char *path, rl_file_map *out_pack);
+void asset_pack_close(rl_file_map *pack);
+
+// True if the pack has `asset` and it was cooked from the current source file
+b8 asset_pack_is_fresh(const rl_file_map *pack, const rl_asset *asset);
+// Last write time of the source file on disk, 0 if there is none
+u64 asset_pack_source_mtime(const rl_asset *asset);
+// Source write time the pack's copy of `asset` was cooked from, 0 if the pack doesn't have it
+u64 asset_pack_cooked_mtime(const rl_file_map *pack, const rl_asset *asset);
+
+// Points `asset->handle` into the mapping, only small headers are allocated from `arena`
+b8 asset_pack_resolve(const rl_file_map *pack, rl_arena *arena, rl_asset *asset);
+// Bytes of the mapping a resolved `asset` points into, 0 if the pack doesn't have it
+u64 asset_pack_mapped_size(const rl_file_map *pack, const rl_asset *asset);
+// Range of a blob (header included) in the mapping, by asset_name_hash()
+b8 asset_pack_blob(const rl_file_map *pack, u64 name_hash, u64 *out_offset, u64 *out_size);
@@ -1,28 +1,183 @@
 #include "font.h"
 
 #include "asset/asset.h"
+#include "asset/vfs.h"
 #include "core/logger.h"
 #include "platform/io/file_io.h"
+#include "core/job.h"
 
 #include "core/font/msdf_wrapper.h"
 
+#include "util/hash.h"
 #include "util/str.h"
 
+#include <stdatomic.h>
+#include <stdio.h>
+
+/* MSDF cache
+ *  Generated atlases and glyph tables are stored next to the font as "<font>.msdf", keyed by a hash of the
+ *  font file and every generator parameter. A hit is one mmap and two copies instead of a full MSDF run.
+ *  Fonts that don't live in a directory mount (memory overlays) are regenerated every time.
+ */
+
+#define FONT_CACHE_MAGIC 0x544E4652 // "RFNT"
+#define FONT_CACHE_VERSION 1
+#define FONT_CACHE_CHARSET_ASCII 1
+
+typedef struct font_cache_header {
+    u32 magic;
+    u32 version;
+    u64 key;
+    u32 glyph_count;
+    i32 width, height, channels;
+    f32 ascender, descender;
+    f32 scale, pixel_range;
+    f64 line_height;
+} font_cache_header;
+
+static u64 font_cache_key(const rl_vfs_file *file) {
+    struct {
+        f32 scale, pixel_range;
+        u32 charset, version;
+    } params = {MSDF_FONT_SCALE, MSDF_PIXEL_RANGE, FONT_CACHE_CHARSET_ASCII, FONT_CACHE_VERSION};
+
+    u64 key = hash_bytes(file->data, file->size, HASH_SEED);
+    return hash_bytes(&params, sizeof(params), key);
+}
+
+// Maps `cache_path` if it was generated from the same font and parameters
+static b8 font_cache_open(const char *cache_path, u64 key, rl_file_map *out_map) {
+    if (!platform_file_map_open(cache_path, out_map)) {
+        return false;
+    }
+
+    const font_cache_header *header = (const font_cache_header *)out_map->data;
+    b8 valid = out_map->size >= sizeof(font_cache_header) &&
+               header->magic == FONT_CACHE_MAGIC &&
+               header->version == FONT_CACHE_VERSION &&
+               header->key == key &&
+               sizeof(font_cache_header) + (u64)header->glyph_count * sizeof(rl_glyph) +
+                       (u64)header->width * header->height * header->channels ==
+                   out_map->size;
+
+    if (!valid) {
+        platform_file_map_close(out_map, out_map->size);
+        return false;
+    }
+    return true;
+}
+
+static b8 font_cache_read(rl_arena *arena, const char *cache_path, u64 key, rl_font *font) {
+    rl_file_map map = {0};
+    if (!font_cache_open(cache_path, key, &map)) {
+        return false;
+    }
+
+    const font_cache_header *header = (const font_cache_header *)map.data;
+    u64 glyphs_size = (u64)header->glyph_count * sizeof(rl_glyph);
+    u64 atlas_size = (u64)header->width * header->height * header->channels;
+
+    font->glyph_count = header->glyph_count;
+    font->ascender = header->ascender;
+    font->descender = header->descender;
+    font->line_height = header->line_height;
+    font->scale = header->scale;
+    font->pixel_range = header->pixel_range;
+    font->atlas.width = header->width;
+    font->atlas.height = header->height;
+    font->atlas.channels = header->channels;
+    font->atlas.size = atlas_size;
+
+    font->glyphs = rl_arena_push(arena, glyphs_size, false);
+    font->atlas.data = rl_arena_push(arena, atlas_size, false);
+    mem_copy(map.data + sizeof(font_cache_header), font->glyphs, glyphs_size);
+    mem_copy(map.data + sizeof(font_cache_header) + glyphs_size, font->atlas.data, atlas_size);
+
+    platform_file_map_close(&map, map.size);
+    return true;
+}
+
+static void font_cache_write(const char *cache_path, u64 key, const rl_font *font) {
+    char tmp_path[528];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", cache_path);
+
+    u64 glyphs_size = (u64)font->glyph_count * sizeof(rl_glyph);
+    u64 size = sizeof(font_cache_header) + glyphs_size + font->atlas.size;
+
+    rl_file_map map = {0};
+    if (!platform_file_map_create(tmp_path, size, &map)) {
+        return;
+    }
+
+    *(font_cache_header *)map.data = (font_cache_header){
+        .magic = FONT_CACHE_MAGIC,
+        .version = FONT_CACHE_VERSION,
+        .key = key,
+        .glyph_count = font->glyph_count,
+        .width = font->atlas.width,
+        .height = font->atlas.height,
+        .channels = font->atlas.channels,
+        .ascender = font->ascender,
+        .descender = font->descender,
+        .scale = font->scale,
+        .pixel_range = font->pixel_range,
+        .line_height = font->line_height,
+    };
+    mem_copy(font->glyphs, map.data + sizeof(font_cache_header), glyphs_size);
+    mem_copy(font->atlas.data, map.data + sizeof(font_cache_header) + glyphs_size, font->atlas.size);
+
+    platform_file_map_close(&map, size);
+    platform_file_rename(tmp_path, cache_path);
+}
+
+// Fonts generating an atlas right now. They run as separate load jobs and split the cores between them,
+// rather than each starting a full set of generator threads next to busy job workers.
+static _Atomic u32 fonts_generating;
+
+static b8 font_generate(const rl_vfs_file *file, const char *path, rl_arena *arena, rl_font *font) {
+    u32 generating = atomic_fetch_add_explicit(&fonts_generating, 1, memory_order_relaxed) + 1;
+    u32 thread_count = RL_MAX(job_worker_count() / generating, 1u);
+    b8 success = msdf_load_font_ascii(file->data, file->size, path, thread_count, arena, font);
+    atomic_fetch_sub_explicit(&fonts_generating, 1, memory_order_relaxed);
+    return success;
+}
+
 b8 rl_font_load(rl_arena *asset_arena, rl_asset *asset) {
     rl_temp_arena scratch = rl_arena_scratch_get();
 
     RL_DEBUG("Initializing font: %s", asset->filename);
 
-    rl_string path = rl_string_format(scratch.arena, "%s%s", get_assets_dir(ASSET_FONT), asset->filename);
+    rl_string path = rl_string_format(asset_arena, "%s%s", get_assets_dir(ASSET_FONT), asset->filename);
+    rl_string cache_name = rl_string_format(scratch.arena, "%s.msdf", path.cstr);
+    char cache_path[VFS_MAX_PATH];
+    b8 cacheable = vfs_mtime(path.cstr) != 0 && vfs_real_path(cache_name.cstr, cache_path, sizeof(cache_path));
+
+    rl_vfs_file file;
+    if (!vfs_open(path.cstr, FILE_ACCESS_SEQUENTIAL, &file)) {
+        RL_ERROR("Failed to open font '%s'", path.cstr);
+        arena_scratch_release(scratch);
+        return false;
+    }
 
     rl_font *font = rl_arena_push(asset_arena, sizeof(rl_font), alignof(rl_font));
     font->name = asset->filename;
     font->path = path.cstr;
-    if (!msdf_load_font_ascii(path.cstr, font)) {
-        RL_ERROR("failed to load msdf_font");
-        arena_scratch_release(scratch);
-        return false;
+
+    u64 key = font_cache_key(&file);
+    if (cacheable && font_cache_read(asset_arena, cache_path, key, font)) {
+        RL_DEBUG("Font '%s' loaded from MSDF cache", asset->filename);
+    } else {
+        if (!font_generate(&file, path.cstr, asset_arena, font)) {
+            RL_ERROR("failed to load msdf_font");
+            vfs_close(&file);
+            arena_scratch_release(scratch);
+            return false;
+        }
+        if (cacheable) {
+            font_cache_write(cache_path, key, font);
+        }
     }
+    vfs_close(&file);
 
     asset->handle = font;
     arena_scratch_release(scratch);
@@ -0,0 +1,733 @@
+#include "asset/mesh.h"
+
+#include "asset/mesh_optimize.h"
+#include "asset/mesh_simplify.h"
+#include "asset/vfs.h"
+#include "core/logger.h"
+#include "memory/containers/dynamic_array.h"
+#include "memory/memory.h"
+#include "util/str.h"
+
+#include "cglm.h"
+#include "yyjson.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+/* glTF 2.0 import
+ *  Every triangle primitive reachable from the default scene is merged into one vertex / index buffer, one
+ *  submesh per primitive, with node transforms applied. Supported: POSITION, NORMAL (generated if missing),
+ *  TEXCOORD_0, any index component type. Buffers come from the .glb BIN chunk, data URIs or files next to
+ *  the .gltf. Sparse accessors and other primitive modes are rejected / skipped.
+ */
+
+#define GLB_MAGIC 0x46546C67 // "glTF"
+#define GLB_CHUNK_JSON 0x4E4F534A
+#define GLB_CHUNK_BIN 0x004E4942
+#define GLTF_MAX_BUFFERS 16
+#define GLTF_MAX_NODE_DEPTH 64
+#define GLTF_MODE_TRIANGLES 4
+
+#define MESH_LOD_REDUCTION 0.5f     // Triangle target of each LOD relative to the one before
+#define MESH_LOD_MIN_PROGRESS 0.85f // A level keeping more triangles than this ends the chain
+#define MESH_LOD_MIN_TRIANGLES 32   // No LODs below twice this
+#define MESH_LOD_MIN_DISTANCE 0.1f  // The camera's near plane
+
+#define GLTF_BYTE 5120
+#define GLTF_UNSIGNED_BYTE 5121
+#define GLTF_SHORT 5122
+#define GLTF_UNSIGNED_SHORT 5123
+#define GLTF_UNSIGNED_INT 5125
+#define GLTF_FLOAT 5126
+
+DA_DEFINE(mesh_vertices, rl_mesh_vertex);
+DA_DEFINE(mesh_indices, u32);
+DA_DEFINE(mesh_submeshes, rl_submesh);
+
+typedef struct gltf_buffer {
+    const u8 *data;
+    u64 size;
+    rl_vfs_file file; // External .bin files
+    u8 *decoded;     // Data URIs
+    u64 decoded_capacity;
+} gltf_buffer;
+
+typedef struct gltf_import {
+    const char *path;
+    yyjson_val *accessors;
+    yyjson_val *buffer_views;
+    yyjson_val *meshes;
+    yyjson_val *nodes;
+    gltf_buffer buffers[GLTF_MAX_BUFFERS];
+    u32 buffer_count;
+
+    mesh_vertices vertices;
+    mesh_indices indices;
+    mesh_submeshes submeshes;
+} gltf_import;
+
+typedef struct gltf_accessor {
+    const u8 *data; // nullptr = all zeros
+    u32 count;
+    u32 stride;
+    u32 component_type;
+    u32 components;
+    b8 normalized;
+} gltf_accessor;
+
+u32 mesh_index_size(MESH_INDEX_TYPE type) {
+    return type == MESH_INDEX_U16 ? sizeof(u16) : sizeof(u32);
+}
+
+// ---------------------------------------------------------------------------------------------------------
+// Buffers
+// ---------------------------------------------------------------------------------------------------------
+
+static i32 base64_value(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+}
+
+static b8 base64_decode(const char *src, gltf_buffer *out) {
+    u32 len = cstr_len(src);
+    u64 capacity = (u64)len / 4 * 3 + 3;
+    out->decoded = mem_alloc(capacity, MEM_SUBSYSTEM_ASSET);
+    out->decoded_capacity = capacity;
+
+    u64 size = 0;
+    u32 bits = 0;
+    i32 bit_count = 0;
+    for (u32 i = 0; i < len && src[i] != '='; i++) {
+        i32 value = base64_value(src[i]);
+        if (value < 0) {
+            return false;
+        }
+        bits = (bits << 6) | (u32)value;
+        bit_count += 6;
+        if (bit_count >= 8) {
+            bit_count -= 8;
+            out->decoded[size++] = (u8)(bits >> bit_count);
+        }
+    }
+
+    out->data = out->decoded;
+    out->size = size;
+    return true;
+}
+
+static b8 buffer_load(gltf_import *import, yyjson_val *buffer, const u8 *glb_bin, u64 glb_bin_size, gltf_buffer *out) {
+    const char *uri = yyjson_get_str(yyjson_obj_get(buffer, "uri"));
+    if (!uri) {
+        // The first buffer of a .glb lives in its BIN chunk
+        out->data = glb_bin;
+        out->size = glb_bin_size;
+        return glb_bin != nullptr;
+    }
+
+    if (strncmp(uri, "data:", 5) == 0) {
+        const char *payload = strstr(uri, ";base64,");
+        return payload && base64_decode(payload + 8, out);
+    }
+
+    rl_temp_arena scratch = rl_arena_scratch_get();
+    const char *slash = strrchr(import->path, '/');
+    u32 dir_len = slash ? (u32)(slash - import->path + 1) : 0;
+    rl_string path = rl_string_format(scratch.arena, "%.*s%s", dir_len, import->path, uri);
+    // Accessors jump around the buffer, but all of it gets read
+    b8 success = vfs_open(path.cstr, FILE_ACCESS_WILLNEED, &out->file);
+    arena_scratch_release(scratch);
+    if (!success) {
+        return false;
+    }
+
+    out->data = out->file.data;
+    out->size = out->file.size;
+    return true;
+}
+
+static void buffers_release(gltf_import *import) {
+    for (u32 i = 0; i < import->buffer_count; i++) {
+        gltf_buffer *buffer = &import->buffers[i];
+        if (buffer->file.data) {
+            vfs_close(&buffer->file);
+        }
+        if (buffer->decoded) {
+            mem_free(buffer->decoded, buffer->decoded_capacity, MEM_SUBSYSTEM_ASSET);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------
+// Accessors
+// ---------------------------------------------------------------------------------------------------------
+
+static u32 component_size(u32 component_type) {
+    switch (component_type) {
+    case GLTF_BYTE:
+    case GLTF_UNSIGNED_BYTE:
+        return 1;
+    case GLTF_SHORT:
+    case GLTF_UNSIGNED_SHORT:
+        return 2;
+    case GLTF_UNSIGNED_INT:
+    case GLTF_FLOAT:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+static u32 type_components(const char *type) {
+    if (!type) return 0;
+    if (strcmp(type, "SCALAR") == 0) return 1;
+    if (strcmp(type, "VEC2") == 0) return 2;
+    if (strcmp(type, "VEC3") == 0) return 3;
+    if (strcmp(type, "VEC4") == 0) return 4;
+    return 0;
+}
+
+static b8 accessor_get(const gltf_import *import, yyjson_val *index, gltf_accessor *out) {
+    yyjson_val *accessor = yyjson_arr_get(import->accessors, yyjson_get_uint(index));
+    if (!yyjson_is_uint(index) || !accessor || yyjson_obj_get(accessor, "sparse")) {
+        return false;
+    }
+
+    *out = (gltf_accessor){
+        .count = (u32)yyjson_get_uint(yyjson_obj_get(accessor, "count")),
+        .component_type = (u32)yyjson_get_uint(yyjson_obj_get(accessor, "componentType")),
+        .components = type_components(yyjson_get_str(yyjson_obj_get(accessor, "type"))),
+        .normalized = yyjson_is_true(yyjson_obj_get(accessor, "normalized")),
+    };
+    u32 element_size = component_size(out->component_type) * out->components;
+    if (element_size == 0) {
+        return false;
+    }
+
+    yyjson_val *view_index = yyjson_obj_get(accessor, "bufferView");
+    if (!view_index) {
+        out->stride = element_size; // No view: every element is zero
+        return true;
+    }
+
+    yyjson_val *view = yyjson_arr_get(import->buffer_views, yyjson_get_uint(view_index));
+    u64 buffer_index = yyjson_get_uint(yyjson_obj_get(view, "buffer"));
+    if (!view || buffer_index >= import->buffer_count) {
+        return false;
+    }
+
+    const gltf_buffer *buffer = &import->buffers[buffer_index];
+    u64 view_offset = yyjson_get_uint(yyjson_obj_get(view, "byteOffset"));
+    u64 view_length = yyjson_get_uint(yyjson_obj_get(view, "byteLength"));
+    u64 offset = yyjson_get_uint(yyjson_obj_get(accessor, "byteOffset"));
+    u32 stride = (u32)yyjson_get_uint(yyjson_obj_get(view, "byteStride"));
+    out->stride = stride ? stride : element_size;
+
+    u64 end = offset + (out->count ? (u64)out->stride * (out->count - 1) + element_size : 0);
+    if (view_offset + view_length > buffer->size || end > view_length) {
+        return false;
+    }
+
+    out->data = buffer->data + view_offset + offset;
+    return true;
+}
+
+static f32 component_read(const gltf_accessor *accessor, u32 element, u32 component) {
+    if (!accessor->data) {
+        return 0.0f;
+    }
+
+    const u8 *p = accessor->data + (u64)accessor->stride * element + component * component_size(accessor->component_type);
+    b8 norm = accessor->normalized;
+    switch (accessor->component_type) {
+    case GLTF_FLOAT: {
+        f32 value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+    case GLTF_UNSIGNED_BYTE:
+        return norm ? p[0] / 255.0f : p[0];
+    case GLTF_BYTE:
+        return norm ? RL_MAX((i8)p[0] / 127.0f, -1.0f) : (i8)p[0];
+    case GLTF_UNSIGNED_SHORT: {
+        u16 value;
+        memcpy(&value, p, sizeof(value));
+        return norm ? value / 65535.0f : value;
+    }
+    case GLTF_SHORT: {
+        i16 value;
+        memcpy(&value, p, sizeof(value));
+        return norm ? RL_MAX(value / 32767.0f, -1.0f) : value;
+    }
+    case GLTF_UNSIGNED_INT: {
+        u32 value;
+        memcpy(&value, p, sizeof(value));
+        return (f32)value;
+    }
+    }
+    return 0.0f;
+}
+
+static u32 index_read(const gltf_accessor *accessor, u32 element) {
+    if (!accessor->data) {
+        return 0;
+    }
+
+    const u8 *p = accessor->data + (u64)accessor->stride * element;
+    switch (accessor->component_type) {
+    case GLTF_UNSIGNED_BYTE:
+        return p[0];
+    case GLTF_UNSIGNED_SHORT: {
+        u16 value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+    default: {
+        u32 value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------
+// Scene
+// ---------------------------------------------------------------------------------------------------------
+
+// Area weighted face normals for vertices [first, first + count), for primitives that don't carry any
+static void generate_normals(rl_mesh_vertex *vertices, u32 first, u32 count, const u32 *indices, u32 index_count) {
+    for (u32 v = first; v < first + count; v++) {
+        glm_vec3_zero(vertices[v].normal);
+    }
+    for (u32 i = 0; i + 2 < index_count; i += 3) {
+        rl_mesh_vertex *a = &vertices[indices[i]];
+        rl_mesh_vertex *b = &vertices[indices[i + 1]];
+        rl_mesh_vertex *c = &vertices[indices[i + 2]];
+        vec3 ab, ac, n;
+        glm_vec3_sub(b->position, a->position, ab);
+        glm_vec3_sub(c->position, a->position, ac);
+        glm_vec3_cross(ab, ac, n);
+        glm_vec3_add(a->normal, n, a->normal);
+        glm_vec3_add(b->normal, n, b->normal);
+        glm_vec3_add(c->normal, n, c->normal);
+    }
+    for (u32 v = first; v < first + count; v++) {
+        glm_vec3_normalize(vertices[v].normal);
+    }
+}
+
+static b8 import_primitive(gltf_import *import, yyjson_val *primitive, mat4 world) {
+    yyjson_val *mode = yyjson_obj_get(primitive, "mode");
+    if (mode && yyjson_get_uint(mode) != GLTF_MODE_TRIANGLES) {
+        RL_WARN("Mesh '%s': skipping a primitive that isn't a triangle list", import->path);
+        return true;
+    }
+
+    yyjson_val *attributes = yyjson_obj_get(primitive, "attributes");
+    yyjson_val *normal_index = yyjson_obj_get(attributes, "NORMAL");
+    yyjson_val *uv_index = yyjson_obj_get(attributes, "TEXCOORD_0");
+    yyjson_val *indices_index = yyjson_obj_get(primitive, "indices");
+
+    gltf_accessor positions, normals = {0}, uvs = {0}, indices = {0};
+    if (!accessor_get(import, yyjson_obj_get(attributes, "POSITION"), &positions) || positions.components != 3 ||
+        (normal_index && (!accessor_get(import, normal_index, &normals) || normals.components != 3 || normals.count != positions.count)) ||
+        (uv_index && (!accessor_get(import, uv_index, &uvs) || uvs.components != 2 || uvs.count != positions.count)) ||
+        (indices_index && (!accessor_get(import, indices_index, &indices) || indices.components != 1))) {
+        RL_ERROR("Mesh '%s': invalid or unsupported primitive accessors", import->path);
+        return false;
+    }
+
+    // Normals go through the inverse transpose, mirroring transforms flip the winding
+    mat3 normal_matrix;
+    glm_mat4_pick3(world, normal_matrix);
+    b8 mirrored = glm_mat3_det(normal_matrix) < 0.0f;
+    glm_mat3_inv(normal_matrix, normal_matrix);
+    glm_mat3_transpose(normal_matrix);
+
+    u32 base_vertex = (u32)import->vertices.count;
+    for (u32 i = 0; i < positions.count; i++) {
+        rl_mesh_vertex vertex = {0};
+        vec3 p = {component_read(&positions, i, 0), component_read(&positions, i, 1), component_read(&positions, i, 2)};
+        glm_mat4_mulv3(world, p, 1.0f, vertex.position);
+        if (normal_index) {
+            vec3 n = {component_read(&normals, i, 0), component_read(&normals, i, 1), component_read(&normals, i, 2)};
+            glm_mat3_mulv(normal_matrix, n, vertex.normal);
+            glm_vec3_normalize(vertex.normal);
+        }
+        if (uv_index) {
+            vertex.uv[0] = component_read(&uvs, i, 0);
+            vertex.uv[1] = component_read(&uvs, i, 1);
+        }
+        da_append(&import->vertices, vertex);
+    }
+
+    u32 index_count = indices_index ? indices.count : positions.count;
+    index_count -= index_count % 3;
+    rl_submesh submesh = {(u32)import->indices.count, index_count};
+    for (u32 i = 0; i < index_count; i += 3) {
+        u32 tri[3];
+        for (u32 k = 0; k < 3; k++) {
+            tri[k] = indices_index ? index_read(&indices, i + k) : i + k;
+            if (tri[k] >= positions.count) {
+                RL_ERROR("Mesh '%s': index %u out of range", import->path, tri[k]);
+                return false;
+            }
+        }
+        da_append(&import->indices, base_vertex + tri[0]);
+        da_append(&import->indices, base_vertex + tri[mirrored ? 2 : 1]);
+        da_append(&import->indices, base_vertex + tri[mirrored ? 1 : 2]);
+    }
+
+    if (!normal_index) {
+        generate_normals(import->vertices.items, base_vertex, positions.count,
+                         import->indices.items + submesh.index_offset, index_count);
+    }
+
+    if (index_count > 0) {
+        da_append(&import->submeshes, submesh);
+    }
+    return true;
+}
+
+static b8 import_mesh(gltf_import *import, u64 mesh_index, mat4 world) {
+    yyjson_val *mesh = yyjson_arr_get(import->meshes, mesh_index);
+    if (!mesh) {
+        return false;
+    }
+
+    u64 idx, max;
+    yyjson_val *primitive;
+    yyjson_arr_foreach(yyjson_obj_get(mesh, "primitives"), idx, max, primitive) {
+        if (!import_primitive(import, primitive, world)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void node_local_matrix(yyjson_val *node, mat4 out) {
+    yyjson_val *matrix = yyjson_obj_get(node, "matrix");
+    if (yyjson_arr_size(matrix) == 16) {
+        f32 values[16];
+        for (u32 i = 0; i < 16; i++) {
+            values[i] = (f32)yyjson_get_num(yyjson_arr_get(matrix, i)); // Column major, like cglm
+        }
+        glm_mat4_make(values, out);
+        return;
+    }
+
+    vec3 t = {0.0f, 0.0f, 0.0f};
+    versor r = {0.0f, 0.0f, 0.0f, 1.0f}; // x y z w, same order as glTF
+    vec3 s = {1.0f, 1.0f, 1.0f};
+    yyjson_val *translation = yyjson_obj_get(node, "translation");
+    yyjson_val *rotation = yyjson_obj_get(node, "rotation");
+    yyjson_val *scale = yyjson_obj_get(node, "scale");
+    for (u32 i = 0; i < 3 && yyjson_arr_size(translation) == 3; i++) {
+        t[i] = (f32)yyjson_get_num(yyjson_arr_get(translation, i));
+    }
+    for (u32 i = 0; i < 4 && yyjson_arr_size(rotation) == 4; i++) {
+        r[i] = (f32)yyjson_get_num(yyjson_arr_get(rotation, i));
+    }
+    for (u32 i = 0; i < 3 && yyjson_arr_size(scale) == 3; i++) {
+        s[i] = (f32)yyjson_get_num(yyjson_arr_get(scale, i));
+    }
+
+    // T * R * S
+    mat4 rotation_matrix, scale_matrix;
+    glm_translate_make(out, t);
+    glm_quat_mat4(r, rotation_matrix);
+    glm_scale_make(scale_matrix, s);
+    glm_mat4_mul(out, rotation_matrix, out);
+    glm_mat4_mul(out, scale_matrix, out);
+}
+
+static b8 import_node(gltf_import *import, u64 node_index, mat4 parent, u32 depth) {
+    yyjson_val *node = yyjson_arr_get(import->nodes, node_index);
+    if (!node || depth > GLTF_MAX_NODE_DEPTH) {
+        RL_ERROR("Mesh '%s': invalid node hierarchy", import->path);
+        return false;
+    }
+
+    mat4 local, world;
+    node_local_matrix(node, local);
+    glm_mat4_mul(parent, local, world);
+
+    yyjson_val *mesh = yyjson_obj_get(node, "mesh");
+    if (mesh && !import_mesh(import, yyjson_get_uint(mesh), world)) {
+        return false;
+    }
+
+    u64 idx, max;
+    yyjson_val *child;
+    yyjson_arr_foreach(yyjson_obj_get(node, "children"), idx, max, child) {
+        if (!import_node(import, yyjson_get_uint(child), world, depth + 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static b8 import_scene(gltf_import *import, yyjson_val *root) {
+    mat4 identity = GLM_MAT4_IDENTITY_INIT;
+    yyjson_val *scenes = yyjson_obj_get(root, "scenes");
+    yyjson_val *scene = yyjson_arr_get(scenes, yyjson_get_uint(yyjson_obj_get(root, "scene")));
+
+    // Files without scenes are a bag of meshes
+    if (!scene) {
+        for (u64 i = 0; i < yyjson_arr_size(import->meshes); i++) {
+            if (!import_mesh(import, i, identity)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    u64 idx, max;
+    yyjson_val *node;
+    yyjson_arr_foreach(yyjson_obj_get(scene, "nodes"), idx, max, node) {
+        if (!import_node(import, yyjson_get_uint(node), identity, 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------
+// Output
+// ---------------------------------------------------------------------------------------------------------
+
+// Simplifies LODs from the merged buffers, optimizes them and writes the final mesh into `arena`
+static void mesh_build(gltf_import *import, rl_arena *arena, rl_mesh *mesh) {
+    const u32 *indices = import->indices.items;
+    u32 index_count = (u32)import->indices.count;
+    u32 vertex_count = (u32)import->vertices.count;
+    u32 submesh_count = (u32)import->submeshes.count;
+    const rl_submesh *submeshes = import->submeshes.items;
+
+    f32 acmr_before = mesh_acmr(indices, index_count, vertex_count, MESH_CACHE_SIZE);
+
+    // LOD 0 followed by each simplified level, every level from LOD 0 so its error is measured against the source
+    mesh_indices chain;
+    mesh_submeshes chain_submeshes;
+    da_init_with_cap(&chain, index_count * 2ull);
+    da_init_with_cap(&chain_submeshes, submesh_count * 2ull);
+    for (u32 i = 0; i < index_count; i++) {
+        da_append(&chain, indices[i]);
+    }
+    for (u32 s = 0; s < submesh_count; s++) {
+        da_append(&chain_submeshes, submeshes[s]);
+    }
+
+    rl_mesh_lod lods[MESH_MAX_LODS] = {{0, index_count, 0.0f}};
+    u32 lod_count = 1;
+
+    // Sized by the input, too big for the thread scratch arena on large meshes
+    u32 *simplified = mem_alloc(index_count * sizeof(u32), MEM_SUBSYSTEM_ASSET);
+    u32 *simplified_counts = mem_alloc(submesh_count * sizeof(u32), MEM_SUBSYSTEM_ASSET);
+    f32 ratio = 1.0f;
+    while (lod_count < MESH_MAX_LODS && lods[lod_count - 1].index_count / 3 >= MESH_LOD_MIN_TRIANGLES * 2) {
+        const rl_mesh_lod *previous = &lods[lod_count - 1];
+        ratio *= MESH_LOD_REDUCTION;
+
+        u32 lod_index_count = 0;
+        f32 error = previous->error;
+        for (u32 s = 0; s < submesh_count; s++) {
+            const rl_submesh *submesh = &submeshes[s];
+            u32 target = (u32)((f32)(submesh->index_count / 3) * ratio) * 3;
+            f32 submesh_error;
+            simplified_counts[s] = mesh_simplify(simplified + lod_index_count, indices + submesh->index_offset,
+                                                 submesh->index_count, import->vertices.items, vertex_count, target,
+                                                 &submesh_error);
+            lod_index_count += simplified_counts[s];
+            error = RL_MAX(error, submesh_error);
+        }
+
+        // Locked borders / seams or flips stopped the simplifier, another level wouldn't pay for itself
+        if ((f32)lod_index_count > (f32)previous->index_count * MESH_LOD_MIN_PROGRESS) {
+            break;
+        }
+
+        u32 offset = (u32)chain.count;
+        for (u32 s = 0, cursor = offset; s < submesh_count; cursor += simplified_counts[s++]) {
+            da_append(&chain_submeshes, ((rl_submesh){cursor, simplified_counts[s]}));
+        }
+        for (u32 i = 0; i < lod_index_count; i++) {
+            da_append(&chain, simplified[i]);
+        }
+        lods[lod_count++] = (rl_mesh_lod){offset, lod_index_count, error};
+    }
+    mem_free(simplified, index_count * sizeof(u32), MEM_SUBSYSTEM_ASSET);
+    mem_free(simplified_counts, submesh_count * sizeof(u32), MEM_SUBSYSTEM_ASSET);
+
+    for (u64 i = 0; i < chain_submeshes.count; i++) {
+        const rl_submesh *submesh = &chain_submeshes.items[i];
+        mesh_optimize_vertex_cache(chain.items + submesh->index_offset, submesh->index_count, vertex_count);
+    }
+    f32 acmr_after = mesh_acmr(chain.items, index_count, vertex_count, MESH_CACHE_SIZE);
+
+    // LOD 0 comes first, so its vertices lead the fetch order and coarser LODs only ever index a subset
+    u32 chain_count = (u32)chain.count;
+    u32 *remap = mem_alloc(vertex_count * sizeof(u32), MEM_SUBSYSTEM_ASSET);
+    u32 used = mesh_optimize_vertex_fetch_remap(chain.items, chain_count, vertex_count, remap);
+
+    mesh->vertex_count = used;
+    mesh->vertices = rl_arena_push(arena, used * sizeof(rl_mesh_vertex), false);
+    for (u32 v = 0; v < vertex_count; v++) {
+        if (remap[v] != UINT32_MAX) {
+            mesh->vertices[remap[v]] = import->vertices.items[v];
+        }
+    }
+    mem_free(remap, vertex_count * sizeof(u32), MEM_SUBSYSTEM_ASSET);
+
+    // 0xFFFF stays free, it's the primitive restart index
+    mesh->index_count = chain_count;
+    mesh->index_type = used < UINT16_MAX ? MESH_INDEX_U16 : MESH_INDEX_U32;
+    mesh->indices = rl_arena_push(arena, chain_count * mesh_index_size(mesh->index_type), false);
+    if (mesh->index_type == MESH_INDEX_U16) {
+        u16 *dst = mesh->indices;
+        for (u32 i = 0; i < chain_count; i++) {
+            dst[i] = (u16)chain.items[i];
+        }
+    } else {
+        mem_copy(chain.items, mesh->indices, chain_count * sizeof(u32));
+    }
+
+    mesh->submesh_count = submesh_count;
+    mesh->submeshes = rl_arena_push(arena, chain_submeshes.count * sizeof(rl_submesh), false);
+    mem_copy(chain_submeshes.items, mesh->submeshes, chain_submeshes.count * sizeof(rl_submesh));
+
+    mesh->lod_count = lod_count;
+    mesh->lods = rl_arena_push(arena, lod_count * sizeof(rl_mesh_lod), false);
+    mem_copy(lods, mesh->lods, lod_count * sizeof(rl_mesh_lod));
+
+    da_free(&chain);
+    da_free(&chain_submeshes);
+
+    glm_vec3_copy(mesh->vertices[0].position, mesh->bounds_min);
+    glm_vec3_copy(mesh->vertices[0].position, mesh->bounds_max);
+    for (u32 v = 1; v < used; v++) {
+        glm_vec3_minv(mesh->bounds_min, mesh->vertices[v].position, mesh->bounds_min);
+        glm_vec3_maxv(mesh->bounds_max, mesh->vertices[v].position, mesh->bounds_max);
+    }
+
+    RL_DEBUG("Mesh: %u vertices, %u triangles, %u submeshes, %u LODs (coarsest %u triangles, error %f), %s indices, "
+             "ACMR %.2f -> %.2f",
+             used, index_count / 3, submesh_count, lod_count, lods[lod_count - 1].index_count / 3,
+             lods[lod_count - 1].error, mesh->index_type == MESH_INDEX_U16 ? "16-bit" : "32-bit", acmr_before,
+             acmr_after);
+}
+
+b8 load_mesh(rl_arena *arena, rl_asset *asset) {
+    rl_temp_arena scratch = rl_arena_scratch_get();
+    rl_string path = rl_string_format(scratch.arena, "%s%s", get_assets_dir(asset->type), asset->filename);
+
+    rl_vfs_file file;
+    if (!vfs_open(path.cstr, FILE_ACCESS_WILLNEED, &file)) {
+        RL_ERROR("Failed to open mesh '%s'", path.cstr);
+        arena_scratch_release(scratch);
+        return false;
+    }
+
+    // .glb: 12 byte header, a JSON chunk and an optional BIN chunk. Anything else is parsed as .gltf JSON.
+    const char *json = (const char *)file.data;
+    u64 json_size = file.size;
+    const u8 *bin = nullptr;
+    u64 bin_size = 0;
+    const u32 *header = (const u32 *)file.data;
+    if (file.size >= 20 && header[0] == GLB_MAGIC) {
+        json_size = header[3];
+        json = (const char *)(file.data + 20);
+        if (header[4] != GLB_CHUNK_JSON || 20 + json_size > file.size) {
+            RL_ERROR("Mesh '%s': malformed .glb", path.cstr);
+            vfs_close(&file);
+            arena_scratch_release(scratch);
+            return false;
+        }
+        u64 bin_offset = 20 + ((json_size + 3) & ~3ull);
+        if (bin_offset + 8 <= file.size && *(const u32 *)(file.data + bin_offset + 4) == GLB_CHUNK_BIN) {
+            bin_size = RL_MIN(*(const u32 *)(file.data + bin_offset), file.size - bin_offset - 8);
+            bin = file.data + bin_offset + 8;
+        }
+    }
+
+    yyjson_read_err err;
+    yyjson_doc *doc = yyjson_read_opts((char *)json, json_size, 0, nullptr, &err);
+    if (!doc) {
+        RL_ERROR("Mesh '%s': %s at byte %llu", path.cstr, err.msg, (u64)err.pos);
+        vfs_close(&file);
+        arena_scratch_release(scratch);
+        return false;
+    }
+
+    yyjson_val *root = yyjson_doc_get_root(doc);
+    gltf_import import = {
+        .path = path.cstr,
+        .accessors = yyjson_obj_get(root, "accessors"),
+        .buffer_views = yyjson_obj_get(root, "bufferViews"),
+        .meshes = yyjson_obj_get(root, "meshes"),
+        .nodes = yyjson_obj_get(root, "nodes"),
+    };
+    da_init(&import.vertices);
+    da_init(&import.indices);
+    da_init(&import.submeshes);
+
+    b8 success = true;
+    u64 idx, max;
+    yyjson_val *buffer;
+    yyjson_arr_foreach(yyjson_obj_get(root, "buffers"), idx, max, buffer) {
+        if (import.buffer_count == GLTF_MAX_BUFFERS ||
+            !buffer_load(&import, buffer, idx == 0 ? bin : nullptr, bin_size, &import.buffers[import.buffer_count++])) {
+            RL_ERROR("Mesh '%s': failed to load buffer %llu", path.cstr, idx);
+            success = false;
+            break;
+        }
+    }
+
+    success = success && import_scene(&import, root);
+    if (success && import.indices.count == 0) {
+        RL_ERROR("Mesh '%s' has no triangles", path.cstr);
+        success = false;
+    }
+
+    if (success) {
+        rl_mesh *mesh = rl_arena_push(arena, sizeof(rl_mesh), true);
+        mesh_build(&import, arena, mesh);
+        asset->handle = mesh;
+    }
+
+    da_free(&import.vertices);
+    da_free(&import.indices);
+    da_free(&import.submeshes);
+    buffers_release(&import);
+    yyjson_doc_free(doc);
+    vfs_close(&file);
+    arena_scratch_release(scratch);
+    return success;
+}
+
+u32 mesh_lod_select(const rl_mesh_lod *lods, u32 lod_count, const f32 bounds_min[3], const f32 bounds_max[3],
+                    mat4 model, vec3 eye, f32 projection_scale, f32 threshold_px) {
+    vec3 center, extent;
+    glm_vec3_add((f32 *)bounds_min, (f32 *)bounds_max, center);
+    glm_vec3_scale(center, 0.5f, center);
+    glm_vec3_sub((f32 *)bounds_max, center, extent);
+
+    // Errors and radius scale with the largest axis of the model matrix
+    f32 scale = sqrtf(RL_MAX(glm_vec3_norm2(model[0]), RL_MAX(glm_vec3_norm2(model[1]), glm_vec3_norm2(model[2]))));
+    vec3 world_center;
+    glm_mat4_mulv3(model, center, 1.0f, world_center);
+    f32 radius = glm_vec3_norm(extent) * scale;
+    f32 distance = RL_MAX(glm_vec3_distance(world_center, eye) - radius, MESH_LOD_MIN_DISTANCE);
+
+    // Errors grow along the chain, the first one over the threshold ends the search
+    f32 pixels_per_unit = scale * projection_scale / distance;
+    u32 lod = 0;
+    for (u32 i = 1; i < lod_count && lods[i].error * pixels_per_unit <= threshold_px; i++) {
+        lod = i;
+    }
+    return lod;
+}
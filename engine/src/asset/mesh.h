@@ -0,0 +1,62 @@
+#pragma once
+
+#include "defines.h"
+#include "asset/asset.h"
+
+#include "memory/arena.h"
+
+#include "cglm.h"
+
+#define MESH_MAX_LODS 8
+#define MESH_LOD_PIXEL_THRESHOLD 1.0f // Initial renderer_set_lod_threshold value
+
+// Interleaved, the layout the renderers bind (location 0 / 1 / 2)
+typedef struct rl_mesh_vertex {
+    f32 position[3];
+    f32 normal[3];
+    f32 uv[2];
+} rl_mesh_vertex;
+
+typedef enum MESH_INDEX_TYPE {
+    MESH_INDEX_U16, // Meshes with at most 65535 vertices
+    MESH_INDEX_U32,
+} MESH_INDEX_TYPE;
+
+// One glTF primitive, a range of the shared index buffer
+typedef struct rl_submesh {
+    u32 index_offset;
+    u32 index_count;
+} rl_submesh;
+
+// The submeshes of one LOD are contiguous, so a LOD is drawable as a single range too
+typedef struct rl_mesh_lod {
+    u32 index_offset;
+    u32 index_count;
+    f32 error; // Max deviation from LOD 0 in object units, non-decreasing over the chain
+} rl_mesh_lod;
+
+typedef struct rl_mesh {
+    rl_mesh_vertex *vertices;
+    void *indices; // u16 or u32 per `index_type`, triangle list
+    rl_submesh *submeshes; // `submesh_count` per LOD, LOD major
+    rl_mesh_lod *lods;
+    u32 vertex_count;
+    u32 index_count;
+    u32 submesh_count;
+    u32 lod_count;
+    MESH_INDEX_TYPE index_type;
+    f32 bounds_min[3];
+    f32 bounds_max[3];
+} rl_mesh;
+
+// Imports a glTF 2.0 scene (.gltf with external / data URI buffers, or .glb) as one mesh. Node transforms are
+// baked into the vertices, a LOD chain is simplified from the result, indices are optimized for the
+// post-transform cache and vertices for fetch order.
+b8 load_mesh(rl_arena *arena, rl_asset *asset);
+
+u32 mesh_index_size(MESH_INDEX_TYPE type);
+
+// Coarsest LOD whose error projects to at most `threshold_px` pixels. `projection_scale` is pixels per unit at
+// distance 1 (viewport height / (2 * tan(fov / 2))), the distance is measured to the transformed bounds sphere.
+u32 mesh_lod_select(const rl_mesh_lod *lods, u32 lod_count, const f32 bounds_min[3], const f32 bounds_max[3],
+                    mat4 model, vec3 eye, f32 projection_scale, f32 threshold_px);
@@ -0,0 +1,187 @@
+#include "asset/mesh_optimize.h"
+
+#include "memory/arena.h"
+#include "memory/memory.h"
+
+#include <math.h>
+#include <stdint.h>
+
+// Tuning from the paper
+#define CACHE_DECAY_POWER 1.5f
+#define LAST_TRI_SCORE 0.75f
+#define VALENCE_BOOST_SCALE 2.0f
+#define VALENCE_BOOST_POWER 0.5f
+
+// Recently used vertices score high, the three of the last triangle a bit less so strips don't win over fans.
+// Vertices with few triangles left get a boost, so they're finished off instead of leaving stragglers.
+static f32 vertex_score(i32 cache_pos, u32 remaining) {
+    if (remaining == 0) {
+        return -1.0f;
+    }
+
+    f32 score = 0.0f;
+    if (cache_pos >= 0) {
+        score = cache_pos < 3 ? LAST_TRI_SCORE
+                              : powf(1.0f - (f32)(cache_pos - 3) / (MESH_CACHE_SIZE - 3), CACHE_DECAY_POWER);
+    }
+    return score + VALENCE_BOOST_SCALE * powf((f32)remaining, -VALENCE_BOOST_POWER);
+}
+
+void mesh_optimize_vertex_cache(u32 *indices, u32 index_count, u32 vertex_count) {
+    u32 tri_count = index_count / 3;
+    if (tri_count < 2) {
+        return;
+    }
+
+    rl_temp_arena scratch = rl_arena_scratch_get();
+
+    // Triangles per vertex, as one flat adjacency list. `remaining` counts the ones not emitted yet,
+    // emitted triangles are swapped past the end of each vertex's range.
+    u32 *remaining = rl_arena_push(scratch.arena, vertex_count * sizeof(u32), true);
+    for (u32 i = 0; i < index_count; i++) {
+        remaining[indices[i]]++;
+    }
+
+    u32 *offsets = rl_arena_push(scratch.arena, vertex_count * sizeof(u32), false);
+    u32 offset = 0;
+    for (u32 v = 0; v < vertex_count; v++) {
+        offsets[v] = offset;
+        offset += remaining[v];
+    }
+
+    u32 *adjacency = rl_arena_push(scratch.arena, index_count * sizeof(u32), false);
+    u32 *fill = rl_arena_push(scratch.arena, vertex_count * sizeof(u32), true);
+    for (u32 i = 0; i < index_count; i++) {
+        u32 v = indices[i];
+        adjacency[offsets[v] + fill[v]++] = i / 3;
+    }
+
+    i32 *cache_pos = rl_arena_push(scratch.arena, vertex_count * sizeof(i32), false);
+    f32 *vscore = rl_arena_push(scratch.arena, vertex_count * sizeof(f32), false);
+    for (u32 v = 0; v < vertex_count; v++) {
+        cache_pos[v] = -1;
+        vscore[v] = vertex_score(-1, remaining[v]);
+    }
+
+    f32 *tscore = rl_arena_push(scratch.arena, tri_count * sizeof(f32), false);
+    b8 *emitted = rl_arena_push(scratch.arena, tri_count * sizeof(b8), true);
+    u32 best = 0;
+    for (u32 t = 0; t < tri_count; t++) {
+        tscore[t] = vscore[indices[t * 3]] + vscore[indices[t * 3 + 1]] + vscore[indices[t * 3 + 2]];
+        if (tscore[t] > tscore[best]) {
+            best = t;
+        }
+    }
+
+    u32 *out = rl_arena_push(scratch.arena, index_count * sizeof(u32), false);
+    u32 cache[MESH_CACHE_SIZE + 3];
+    u32 cache_count = 0;
+    u32 cursor = 0;
+
+    for (u32 n = 0; n < tri_count; n++) {
+        // Nothing in the cache has triangles left, continue with the next one in input order
+        if (best == UINT32_MAX) {
+            while (emitted[cursor]) {
+                cursor++;
+            }
+            best = cursor;
+        }
+
+        const u32 *tri = &indices[best * 3];
+        emitted[best] = true;
+        out[n * 3 + 0] = tri[0];
+        out[n * 3 + 1] = tri[1];
+        out[n * 3 + 2] = tri[2];
+
+        for (u32 k = 0; k < 3; k++) {
+            u32 v = tri[k];
+            u32 *list = &adjacency[offsets[v]];
+            for (u32 i = 0; i < remaining[v]; i++) {
+                if (list[i] == best) {
+                    list[i] = list[--remaining[v]];
+                    list[remaining[v]] = best;
+                    break;
+                }
+            }
+        }
+
+        // The triangle's vertices move to the front, everything pushed past the cache size falls out
+        u32 next_cache[MESH_CACHE_SIZE + 3];
+        u32 next_count = 0;
+        for (u32 k = 0; k < 3; k++) {
+            if ((k == 0 || tri[k] != tri[0]) && (k < 2 || tri[k] != tri[1])) {
+                next_cache[next_count++] = tri[k];
+            }
+        }
+        for (u32 i = 0; i < cache_count; i++) {
+            u32 v = cache[i];
+            if (v != tri[0] && v != tri[1] && v != tri[2]) {
+                next_cache[next_count++] = v;
+            }
+        }
+
+        for (u32 i = 0; i < next_count; i++) {
+            u32 v = next_cache[i];
+            cache_pos[v] = i < MESH_CACHE_SIZE ? (i32)i : -1;
+            vscore[v] = vertex_score(cache_pos[v], remaining[v]);
+        }
+
+        // Only triangles around the touched vertices changed score
+        best = UINT32_MAX;
+        f32 best_score = -1.0f;
+        for (u32 i = 0; i < next_count; i++) {
+            u32 v = next_cache[i];
+            const u32 *list = &adjacency[offsets[v]];
+            for (u32 j = 0; j < remaining[v]; j++) {
+                u32 t = list[j];
+                tscore[t] = vscore[indices[t * 3]] + vscore[indices[t * 3 + 1]] + vscore[indices[t * 3 + 2]];
+                if (tscore[t] > best_score) {
+                    best_score = tscore[t];
+                    best = t;
+                }
+            }
+        }
+
+        cache_count = RL_MIN(next_count, (u32)MESH_CACHE_SIZE);
+        mem_copy(next_cache, cache, cache_count * sizeof(u32));
+    }
+
+    mem_copy(out, indices, tri_count * 3 * sizeof(u32));
+    arena_scratch_release(scratch);
+}
+
+u32 mesh_optimize_vertex_fetch_remap(u32 *indices, u32 index_count, u32 vertex_count, u32 *remap) {
+    for (u32 v = 0; v < vertex_count; v++) {
+        remap[v] = UINT32_MAX;
+    }
+
+    u32 next = 0;
+    for (u32 i = 0; i < index_count; i++) {
+        u32 v = indices[i];
+        if (remap[v] == UINT32_MAX) {
+            remap[v] = next++;
+        }
+        indices[i] = remap[v];
+    }
+    return next;
+}
+
+f32 mesh_acmr(const u32 *indices, u32 index_count, u32 vertex_count, u32 cache_size) {
+    if (index_count < 3) {
+        return 0.0f;
+    }
+
+    // A vertex is cached while fewer than `cache_size` misses happened since it was inserted
+    rl_temp_arena scratch = rl_arena_scratch_get();
+    u32 *inserted = rl_arena_push(scratch.arena, vertex_count * sizeof(u32), true);
+    u32 misses = 0;
+    for (u32 i = 0; i < index_count; i++) {
+        u32 v = indices[i];
+        if (inserted[v] == 0 || misses - inserted[v] >= cache_size) {
+            inserted[v] = ++misses;
+        }
+    }
+
+    arena_scratch_release(scratch);
+    return (f32)misses / (f32)(index_count / 3);
+}
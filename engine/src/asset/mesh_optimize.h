@@ -0,0 +1,22 @@
+#pragma once
+
+#include "defines.h"
+
+/* Mesh optimization
+ *  Run at import, so cooked meshes upload as-is.
+ *  - Vertex cache: greedy triangle reordering after Forsyth ("Linear-Speed Vertex Cache Optimisation"),
+ *    scored against a 32 entry LRU so it holds up on any post-transform cache size.
+ *  - Vertex fetch: vertices renumbered in order of first use, so the fetch walks memory forward.
+ */
+
+#define MESH_CACHE_SIZE 32
+
+// Reorders the triangles of `indices` in place
+void mesh_optimize_vertex_cache(u32 *indices, u32 index_count, u32 vertex_count);
+
+// Renumbers `indices` in order of first use and writes the matching `remap` (old index -> new, UINT32_MAX if
+// unused). Returns the number of used vertices.
+u32 mesh_optimize_vertex_fetch_remap(u32 *indices, u32 index_count, u32 vertex_count, u32 *remap);
+
+// Average cache miss ratio (transformed vertices per triangle) against a FIFO of `cache_size`, for logging
+f32 mesh_acmr(const u32 *indices, u32 index_count, u32 vertex_count, u32 cache_size);
@@ -0,0 +1,328 @@
+#include "asset/mesh_simplify.h"
+
+#include "memory/memory.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Symmetric 4x4 plane quadric plus the accumulated triangle area, so costs normalize to squared distance
+typedef struct quadric {
+    f64 a2, b2, c2, ab, ac, bc, ad, bd, cd, d2;
+    f64 weight;
+} quadric;
+
+typedef struct collapse {
+    u32 from;
+    u32 to;
+    f32 cost;
+} collapse;
+
+static void quadric_add(quadric *dst, const quadric *src) {
+    dst->a2 += src->a2;
+    dst->b2 += src->b2;
+    dst->c2 += src->c2;
+    dst->ab += src->ab;
+    dst->ac += src->ac;
+    dst->bc += src->bc;
+    dst->ad += src->ad;
+    dst->bd += src->bd;
+    dst->cd += src->cd;
+    dst->d2 += src->d2;
+    dst->weight += src->weight;
+}
+
+static f64 quadric_eval(const quadric *q, const f32 p[3]) {
+    f64 x = p[0], y = p[1], z = p[2];
+    return q->a2 * x * x + q->b2 * y * y + q->c2 * z * z + 2.0 * (q->ab * x * y + q->ac * x * z + q->bc * y * z) +
+           2.0 * (q->ad * x + q->bd * y + q->cd * z) + q->d2;
+}
+
+static void triangle_normal(const f32 *p0, const f32 *p1, const f32 *p2, f64 n[3]) {
+    f64 e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+    f64 e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+    n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+    n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+    n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+}
+
+// Mean squared distance of `to` from the planes of both vertices, after collapsing `from` onto it
+static f32 collapse_cost(const quadric *quadrics, const rl_mesh_vertex *vertices, u32 from, u32 to) {
+    quadric q = quadrics[from];
+    quadric_add(&q, &quadrics[to]);
+    f64 cost = q.weight > 0.0 ? quadric_eval(&q, vertices[to].position) / q.weight : 0.0;
+    return (f32)RL_MAX(cost, 0.0);
+}
+
+static int collapse_compare(const void *a, const void *b) {
+    f32 ca = ((const collapse *)a)->cost;
+    f32 cb = ((const collapse *)b)->cost;
+    return (ca > cb) - (ca < cb);
+}
+
+static u32 hash_u32(u32 h) {
+    h ^= h >> 16;
+    h *= 0x7feb352du;
+    h ^= h >> 15;
+    h *= 0x846ca68bu;
+    h ^= h >> 16;
+    return h;
+}
+
+static u32 hash_position(const f32 p[3]) {
+    u32 bits[3];
+    memcpy(bits, p, sizeof(bits));
+    return hash_u32(bits[0] ^ hash_u32(bits[1] ^ hash_u32(bits[2])));
+}
+
+static u32 table_capacity(u32 count) {
+    u32 capacity = 16;
+    while (capacity < count * 2) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+// Vertices with bitwise equal positions map to the first of them
+static void build_position_ids(u32 *ids, const rl_mesh_vertex *vertices, u32 vertex_count) {
+    u32 capacity = table_capacity(vertex_count);
+    u32 *table = mem_alloc(capacity * sizeof(u32), MEM_SUBSYSTEM_ASSET);
+    memset(table, 0xff, capacity * sizeof(u32));
+
+    for (u32 v = 0; v < vertex_count; v++) {
+        u32 slot = hash_position(vertices[v].position) & (capacity - 1);
+        while (table[slot] != UINT32_MAX &&
+               memcmp(vertices[table[slot]].position, vertices[v].position, sizeof(f32) * 3) != 0) {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        if (table[slot] == UINT32_MAX) {
+            table[slot] = v;
+        }
+        ids[v] = table[slot];
+    }
+    mem_free(table, capacity * sizeof(u32), MEM_SUBSYSTEM_ASSET);
+}
+
+static b8 edge_set_insert(u64 *table, u32 capacity, u64 key) {
+    u32 slot = hash_u32((u32)key ^ hash_u32((u32)(key >> 32))) & (capacity - 1);
+    while (table[slot] != UINT64_MAX) {
+        if (table[slot] == key) {
+            return false;
+        }
+        slot = (slot + 1) & (capacity - 1);
+    }
+    table[slot] = key;
+    return true;
+}
+
+static b8 edge_set_contains(const u64 *table, u32 capacity, u64 key) {
+    u32 slot = hash_u32((u32)key ^ hash_u32((u32)(key >> 32))) & (capacity - 1);
+    while (table[slot] != UINT64_MAX) {
+        if (table[slot] == key) {
+            return true;
+        }
+        slot = (slot + 1) & (capacity - 1);
+    }
+    return false;
+}
+
+// Seams: more than one vertex at a position. Borders: a directed position edge without its opposite.
+static void lock_vertices(b8 *locked, const u32 *position_ids, const u32 *indices, u32 index_count, u32 vertex_count) {
+    u32 *shared = mem_alloc(vertex_count * sizeof(u32), MEM_SUBSYSTEM_ASSET);
+    mem_zero(shared, vertex_count * sizeof(u32));
+    for (u32 v = 0; v < vertex_count; v++) {
+        shared[position_ids[v]]++;
+    }
+    for (u32 v = 0; v < vertex_count; v++) {
+        locked[v] = shared[position_ids[v]] > 1;
+    }
+    mem_free(shared, vertex_count * sizeof(u32), MEM_SUBSYSTEM_ASSET);
+
+    u32 capacity = table_capacity(index_count);
+    u64 *edges = mem_alloc(capacity * sizeof(u64), MEM_SUBSYSTEM_ASSET);
+    memset(edges, 0xff, capacity * sizeof(u64));
+    for (u32 i = 0; i < index_count; i++) {
+        u32 a = position_ids[indices[i]];
+        u32 b = position_ids[indices[i - i % 3 + (i + 1) % 3]];
+        edge_set_insert(edges, capacity, (u64)a << 32 | b);
+    }
+
+    for (u32 i = 0; i < index_count; i++) {
+        u32 va = indices[i];
+        u32 vb = indices[i - i % 3 + (i + 1) % 3];
+        u32 a = position_ids[va];
+        u32 b = position_ids[vb];
+        if (!edge_set_contains(edges, capacity, (u64)b << 32 | a)) {
+            locked[va] = true;
+            locked[vb] = true;
+        }
+    }
+    mem_free(edges, capacity * sizeof(u64), MEM_SUBSYSTEM_ASSET);
+}
+
+// Moving `from` onto `to` must not turn any of its remaining triangles around
+static b8 collapse_flips(const u32 *indices, const u32 *offsets, const u32 *counts, const u32 *adjacency,
+                         const rl_mesh_vertex *vertices, u32 from, u32 to) {
+    const u32 *list = &adjacency[offsets[from]];
+    for (u32 i = 0; i < counts[from]; i++) {
+        const u32 *tri = &indices[list[i] * 3];
+        if (tri[0] == to || tri[1] == to || tri[2] == to) {
+            continue;
+        }
+
+        const f32 *p[3];
+        const f32 *q[3];
+        for (u32 k = 0; k < 3; k++) {
+            p[k] = vertices[tri[k]].position;
+            q[k] = tri[k] == from ? vertices[to].position : p[k];
+        }
+
+        f64 before[3], after[3];
+        triangle_normal(p[0], p[1], p[2], before);
+        triangle_normal(q[0], q[1], q[2], after);
+        if (before[0] * after[0] + before[1] * after[1] + before[2] * after[2] <= 0.0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+u32 mesh_simplify(u32 *dst, const u32 *indices, u32 index_count, const rl_mesh_vertex *vertices, u32 vertex_count,
+                  u32 target_index_count, f32 *out_error) {
+    mem_copy((void *)indices, dst, index_count * sizeof(u32));
+    *out_error = 0.0f;
+    if (index_count <= target_index_count || index_count < 6) {
+        return index_count;
+    }
+
+    // Working memory scales with the input, heap allocated: large meshes outgrow the thread scratch arena
+    u32 *position_ids = mem_alloc(vertex_count * sizeof(u32), MEM_SUBSYSTEM_ASSET);
+    build_position_ids(position_ids, vertices, vertex_count);
+
+    b8 *locked = mem_alloc(vertex_count * sizeof(b8), MEM_SUBSYSTEM_ASSET);
+    lock_vertices(locked, position_ids, indices, index_count, vertex_count);
+    mem_free(position_ids, vertex_count * sizeof(u32), MEM_SUBSYSTEM_ASSET);
+
+    // Every vertex starts with the planes of its triangles, area weighted
+    quadric *quadrics = mem_alloc(vertex_count * sizeof(quadric), MEM_SUBSYSTEM_ASSET);
+    mem_zero(quadrics, vertex_count * sizeof(quadric));
+    for (u32 i = 0; i < index_count; i += 3) {
+        const f32 *p0 = vertices[indices[i]].position;
+        f64 n[3];
+        triangle_normal(p0, vertices[indices[i + 1]].position, vertices[indices[i + 2]].position, n);
+        f64 length = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (length <= 0.0) {
+            continue;
+        }
+
+        f64 a = n[0] / length, b = n[1] / length, c = n[2] / length;
+        f64 d = -(a * p0[0] + b * p0[1] + c * p0[2]);
+        f64 w = length * 0.5;
+        quadric plane = {w * a * a, w * b * b, w * c * c, w * a * b, w * a * c, w * b * c,
+                         w * a * d, w * b * d, w * c * d, w * d * d, w};
+        for (u32 k = 0; k < 3; k++) {
+            quadric_add(&quadrics[indices[i + k]], &plane);
+        }
+    }
+
+    u32 *counts = mem_alloc(vertex_count * sizeof(u32), MEM_SUBSYSTEM_ASSET);
+    u32 *offsets = mem_alloc(vertex_count * sizeof(u32), MEM_SUBSYSTEM_ASSET);
+    u32 *adjacency = mem_alloc(index_count * sizeof(u32), MEM_SUBSYSTEM_ASSET);
+    u32 *remap = mem_alloc(vertex_count * sizeof(u32), MEM_SUBSYSTEM_ASSET);
+    b8 *touched = mem_alloc(vertex_count * sizeof(b8), MEM_SUBSYSTEM_ASSET);
+    collapse *collapses = mem_alloc(index_count * sizeof(collapse), MEM_SUBSYSTEM_ASSET);
+
+    f32 max_cost = 0.0f;
+    u32 count = index_count;
+    while (count > target_index_count) {
+        // Triangles per vertex for the flip test, rebuilt as indices change between passes
+        mem_zero(counts, vertex_count * sizeof(u32));
+        for (u32 i = 0; i < count; i++) {
+            counts[dst[i]]++;
+        }
+        u32 offset = 0;
+        for (u32 v = 0; v < vertex_count; v++) {
+            offsets[v] = offset;
+            offset += counts[v];
+            counts[v] = 0;
+        }
+        for (u32 i = 0; i < count; i++) {
+            u32 v = dst[i];
+            adjacency[offsets[v] + counts[v]++] = i / 3;
+        }
+
+        // Cheaper direction of every edge, shared edges show up twice and the second one gets skipped below
+        u32 collapse_count = 0;
+        for (u32 i = 0; i < count; i++) {
+            u32 a = dst[i];
+            u32 b = dst[i - i % 3 + (i + 1) % 3];
+            f32 ab = locked[a] ? INFINITY : collapse_cost(quadrics, vertices, a, b);
+            f32 ba = locked[b] ? INFINITY : collapse_cost(quadrics, vertices, b, a);
+            if (ab == INFINITY && ba == INFINITY) {
+                continue;
+            }
+            collapses[collapse_count++] = ab <= ba ? (collapse){a, b, ab} : (collapse){b, a, ba};
+        }
+        if (collapse_count == 0) {
+            break;
+        }
+        qsort(collapses, collapse_count, sizeof(collapse), collapse_compare);
+
+        for (u32 v = 0; v < vertex_count; v++) {
+            remap[v] = v;
+        }
+        mem_zero(touched, vertex_count * sizeof(b8));
+
+        // Cheapest first, each vertex at most once per pass so the flip test sees current positions.
+        // A collapse removes the triangles sharing its edge, usually two.
+        u32 goal = (count - target_index_count) / 3;
+        u32 removed = 0;
+        u32 performed = 0;
+        for (u32 c = 0; c < collapse_count && removed < goal; c++) {
+            collapse edge = collapses[c];
+            if (touched[edge.from] || touched[edge.to] ||
+                collapse_flips(dst, offsets, counts, adjacency, vertices, edge.from, edge.to)) {
+                continue;
+            }
+
+            const u32 *list = &adjacency[offsets[edge.from]];
+            for (u32 i = 0; i < counts[edge.from]; i++) {
+                const u32 *tri = &dst[list[i] * 3];
+                removed += tri[0] == edge.to || tri[1] == edge.to || tri[2] == edge.to;
+            }
+
+            remap[edge.from] = edge.to;
+            quadric_add(&quadrics[edge.to], &quadrics[edge.from]);
+            touched[edge.from] = true;
+            touched[edge.to] = true;
+            max_cost = RL_MAX(max_cost, edge.cost);
+            performed++;
+        }
+        if (performed == 0) {
+            break;
+        }
+
+        u32 write = 0;
+        for (u32 i = 0; i < count; i += 3) {
+            u32 a = remap[dst[i]], b = remap[dst[i + 1]], c = remap[dst[i + 2]];
+            if (a != b && b != c && a != c) {
+                dst[write++] = a;
+                dst[write++] = b;
+                dst[write++] = c;
+            }
+        }
+        count = write;
+    }
+
+    mem_free(locked, vertex_count * sizeof(b8), MEM_SUBSYSTEM_ASSET);
+    mem_free(quadrics, vertex_count * sizeof(quadric), MEM_SUBSYSTEM_ASSET);
+    mem_free(counts, vertex_count * sizeof(u32), MEM_SUBSYSTEM_ASSET);
+    mem_free(offsets, vertex_count * sizeof(u32), MEM_SUBSYSTEM_ASSET);
+    mem_free(adjacency, index_count * sizeof(u32), MEM_SUBSYSTEM_ASSET);
+    mem_free(remap, vertex_count * sizeof(u32), MEM_SUBSYSTEM_ASSET);
+    mem_free(touched, vertex_count * sizeof(b8), MEM_SUBSYSTEM_ASSET);
+    mem_free(collapses, index_count * sizeof(collapse), MEM_SUBSYSTEM_ASSET);
+    *out_error = sqrtf(max_cost);
+    return count;
+}
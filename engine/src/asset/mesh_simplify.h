@@ -0,0 +1,16 @@
+#pragma once
+
+#include "defines.h"
+#include "asset/mesh.h"
+
+/* Mesh simplification
+ *  Quadric error edge collapse (Garland & Heckbert) onto existing vertices, so every LOD indexes the same
+ *  vertex buffer. Vertices on open borders and attribute seams (several vertices at one position) are
+ *  locked, which keeps silhouettes and UV / normal discontinuities intact at the cost of reduction on
+ *  heavily split meshes. Collapses that would flip a triangle are rejected.
+ */
+
+// Simplifies the triangle list `indices` towards `target_index_count` into `dst` (index_count entries).
+// Returns the new index count, `out_error` is the largest deviation of a performed collapse in object units.
+u32 mesh_simplify(u32 *dst, const u32 *indices, u32 index_count, const rl_mesh_vertex *vertices, u32 vertex_count,
+                  u32 target_index_count, f32 *out_error);
@@ -1,6 +1,6 @@
 #include "asset/shader.h"
 
-#include "platform/io/file_io.h"
+#include "asset/vfs.h"
 #include "util/str.h"
 
 static SHADER_TYPE infer_shader_type(const char *filename) {
@@ -27,27 +27,30 @@ b8 load_shader(rl_arena *arena, rl_asset *asset) {
     const char *filename = asset->filename;
     rl_string path = rl_string_format(scratch.arena, "%s%s", dir, filename);
 
-    rl_file shader_file = {};
-    platform_file_open(path.cstr, P_FILE_READ, &shader_file);
-    platform_file_read_all(&shader_file);
+    rl_vfs_file shader_file;
+    if (!vfs_open(path.cstr, FILE_ACCESS_SEQUENTIAL, &shader_file)) {
+        RL_ERROR("Failed to open shader '%s'", path.cstr);
+        arena_scratch_release(scratch);
+        return false;
+    }
 
     rl_asset_shader *shader = rl_arena_push(arena, sizeof(rl_asset_shader), alignof(rl_asset_shader));
     // Allocate space for shader text + null terminator
-    char *text = rl_arena_push(arena, shader_file.buf_len + 1, alignof(char));
-    mem_copy(shader_file.buf, text, shader_file.buf_len);
-    text[shader_file.buf_len] = '\0';
+    char *text = rl_arena_push(arena, shader_file.size + 1, alignof(char));
+    mem_copy((void *)shader_file.data, text, shader_file.size);
+    text[shader_file.size] = '\0';
+    vfs_close(&shader_file);
 
     shader->source = text;
-    shader->type = infer_shader_type(shader_file.name);
+    shader->type = infer_shader_type(filename);
     if (shader->type == SHADER_TYPE_UNKNOWN) {
         RL_ERROR("Failed to load shader file, unsupported file extension");
+        arena_scratch_release(scratch);
         return false;
     }
 
     asset->handle = shader;
 
-    platform_file_close(&shader_file);
-
     arena_scratch_release(scratch);
     return true;
 }
\ No newline at end of file
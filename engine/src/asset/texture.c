@@ -1,12 +1,93 @@
 #include "texture.h"
 
-#define STB_IMAGE_IMPLEMENTATION
+#include "asset/vfs.h"
 #include "core/logger.h"
 #include "memory/arena.h"
-#include "platform/io/file_io.h"
 #include "util/str.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Zero-copy decode
+ *  stb_image allocates its own output buffer. The allocator hooks below hand it the caller's destination
+ *  instead when it asks for the size of the RGBA8 result (JPEG adds a byte, hence the padding), so pixels
+ *  are written once, in place.
+ *  If a decoder path allocates differently the result is copied, so the hook only affects speed.
+ */
+
+typedef struct decode_target {
+    u8 *dst;
+    u64 size;
+    b8 taken;
+} decode_target;
+
+static _Thread_local decode_target decode_dst;
+
+static void *decode_malloc(u64 size) {
+    if (decode_dst.dst && !decode_dst.taken && size >= decode_dst.size && size <= decode_dst.size + TEXTURE_DECODE_PADDING) {
+        decode_dst.taken = true;
+        return decode_dst.dst;
+    }
+    return malloc(size);
+}
+
+static void *decode_realloc(void *ptr, u64 size) {
+    if (ptr && ptr == decode_dst.dst) {
+        void *moved = malloc(size);
+        if (moved) {
+            memcpy(moved, ptr, RL_MIN(size, decode_dst.size + TEXTURE_DECODE_PADDING));
+        }
+        return moved;
+    }
+    return realloc(ptr, size);
+}
+
+static void decode_free(void *ptr) {
+    if (ptr != decode_dst.dst) {
+        free(ptr);
+    }
+}
+
+#define STBI_MALLOC(sz) decode_malloc(sz)
+#define STBI_REALLOC(p, newsz) decode_realloc(p, newsz)
+#define STBI_FREE(p) decode_free(p)
+#define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
+b8 texture_decode_info(const u8 *encoded, u64 encoded_size, rl_texture *out_texture) {
+    i32 width, height, channels;
+    if (!stbi_info_from_memory(encoded, (int)encoded_size, &width, &height, &channels)) {
+        return false;
+    }
+
+    // Always expanded to RGBA8
+    out_texture->width = width;
+    out_texture->height = height;
+    out_texture->channels = 4;
+    out_texture->format = TEXTURE_FORMAT_RGBA8;
+    out_texture->mip_count = 1;
+    out_texture->size = (u64)width * height * 4;
+    return true;
+}
+
+b8 texture_decode_into(const u8 *encoded, u64 encoded_size, const rl_texture *texture, u8 *dst) {
+    decode_dst = (decode_target){dst, texture->size, false};
+
+    i32 width, height, channels;
+    u8 *pixels = stbi_load_from_memory(encoded, (int)encoded_size, &width, &height, &channels, STBI_rgb_alpha);
+    decode_dst = (decode_target){0};
+
+    if (!pixels) {
+        return false;
+    }
+
+    if (pixels != dst) {
+        mem_copy(pixels, dst, texture->size);
+        stbi_image_free(pixels);
+    }
+    return true;
+}
+
 b8 load_texture(rl_arena *asset_arena, rl_asset *asset) {
     rl_temp_arena scratch = rl_arena_scratch_get();
 
@@ -14,30 +95,68 @@ b8 load_texture(rl_arena *asset_arena, rl_asset *asset) {
     const char *filename = asset->filename;
     rl_string path = rl_string_format(scratch.arena, "%s%s", dir, filename);
 
-    i32 width, height, channels;
-    u8 *data = stbi_load(path.cstr, &width, &height, &channels, STBI_rgb_alpha);
-
-    if (data == NULL) {
+    rl_vfs_file file = {0};
+    rl_texture *texture = rl_arena_push(asset_arena, sizeof(rl_texture), true);
+    if (!vfs_open(path.cstr, FILE_ACCESS_SEQUENTIAL, &file) || !texture_decode_info(file.data, file.size, texture)) {
         RL_ERROR("Failed to load texture at '%s'", path.cstr);
+        vfs_close(&file);
         arena_scratch_release(scratch);
         return false;
     }
 
-    rl_texture *texture = rl_arena_push(asset_arena, sizeof(rl_texture), alignof(rl_texture));
-    texture->width = width;
-    texture->height = height;
-
-    // STBI_rgb_alpha guarantees 4 channels
-    texture->channels = 4; // RGBA
-    u64 size = texture->width * texture->height * texture->channels;
-    texture->size = size;
+    // Not zeroed, the decoder writes every byte
+    texture->data = rl_arena_push(asset_arena, texture->size + TEXTURE_DECODE_PADDING, false);
+    b8 success = texture_decode_into(file.data, file.size, texture, texture->data);
+    vfs_close(&file);
 
-    texture->data = rl_arena_push(asset_arena, size, 1);
-    mem_copy(data, texture->data, size);
+    if (!success) {
+        RL_ERROR("Failed to decode texture at '%s': %s", path.cstr, stbi_failure_reason());
+        arena_scratch_release(scratch);
+        return false;
+    }
 
     asset->handle = texture;
-
-    stbi_image_free(data);
     arena_scratch_release(scratch);
     return true;
-}
\ No newline at end of file
+}
+
+b8 texture_format_is_compressed(TEXTURE_FORMAT format) {
+    return format != TEXTURE_FORMAT_RGBA8;
+}
+
+u32 texture_mip_count_full(i32 width, i32 height) {
+    u32 count = 1;
+    for (i32 extent = RL_MAX(width, height); extent > 1; extent >>= 1) {
+        count++;
+    }
+    return count;
+}
+
+i32 texture_level_extent(i32 extent, u32 level) {
+    return RL_MAX(extent >> level, 1);
+}
+
+u64 texture_level_size(TEXTURE_FORMAT format, i32 width, i32 height, u32 level) {
+    u64 w = texture_level_extent(width, level);
+    u64 h = texture_level_extent(height, level);
+
+    switch (format) {
+    case TEXTURE_FORMAT_RGBA8:
+        return w * h * 4;
+    case TEXTURE_FORMAT_BC1:
+        return ((w + 3) / 4) * ((h + 3) / 4) * 8;
+    case TEXTURE_FORMAT_BC3:
+    case TEXTURE_FORMAT_BC5:
+    case TEXTURE_FORMAT_BC7:
+        return ((w + 3) / 4) * ((h + 3) / 4) * 16;
+    }
+    return 0;
+}
+
+u64 texture_level_offset(TEXTURE_FORMAT format, i32 width, i32 height, u32 level) {
+    u64 offset = 0;
+    for (u32 i = 0; i < level; i++) {
+        offset += texture_level_size(format, width, height, i);
+    }
+    return offset;
+}
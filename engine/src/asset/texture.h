@@ -5,10 +5,35 @@
 
 #include "memory/arena.h"
 
+typedef enum TEXTURE_FORMAT {
+    TEXTURE_FORMAT_RGBA8, // Decoded source pixels
+    TEXTURE_FORMAT_BC1,   // Opaque color, 8 bytes per 4x4 block
+    TEXTURE_FORMAT_BC3,   // Color + smooth alpha, 16 bytes per block
+    TEXTURE_FORMAT_BC5,   // Two linear channels (normal maps), 16 bytes per block
+    TEXTURE_FORMAT_BC7,   // Color + alpha at higher quality, 16 bytes per block
+} TEXTURE_FORMAT;
+
 typedef struct rl_texture {
     i32 width, height, channels;
-    u64 size;
+    TEXTURE_FORMAT format;
+    u32 mip_count; // Levels are stored largest first, back to back in `data`
+    u64 size;      // All levels
     u8 *data;
 } rl_texture;
 
-b8 load_texture(rl_arena *asset_arena, rl_asset *asset);
\ No newline at end of file
+#define TEXTURE_DECODE_PADDING 16 // Extra bytes texture_decode_into may write past texture->size
+
+// Rows are stored top to bottom as decoded, renderers account for it in their texture coordinates
+b8 load_texture(rl_arena *asset_arena, rl_asset *asset);
+
+// Reads the image header, fills width / height / channels / size of the RGBA8 result without decoding
+b8 texture_decode_info(const u8 *encoded, u64 encoded_size, rl_texture *out_texture);
+// Decodes into `dst` (texture->size + TEXTURE_DECODE_PADDING bytes), e.g. arena memory or a mapped staging buffer
+b8 texture_decode_into(const u8 *encoded, u64 encoded_size, const rl_texture *texture, u8 *dst);
+
+b8 texture_format_is_compressed(TEXTURE_FORMAT format);
+u32 texture_mip_count_full(i32 width, i32 height);
+i32 texture_level_extent(i32 extent, u32 level);
+// Byte size / offset of mip `level` in a chain of `format`
+u64 texture_level_size(TEXTURE_FORMAT format, i32 width, i32 height, u32 level);
+u64 texture_level_offset(TEXTURE_FORMAT format, i32 width, i32 height, u32 level);
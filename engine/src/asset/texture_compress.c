@@ -0,0 +1,579 @@
+#include "texture_compress.h"
+
+#include "memory/arena.h"
+#include "memory/memory.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef u8 block_pixels[16][4];
+
+static const u8 bc7_weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+// Edge blocks repeat the last row / column
+static void block_load(const u8 *pixels, i32 width, i32 height, i32 bx, i32 by, block_pixels out) {
+    for (i32 y = 0; y < 4; y++) {
+        i32 sy = RL_MIN(by * 4 + y, height - 1);
+        for (i32 x = 0; x < 4; x++) {
+            i32 sx = RL_MIN(bx * 4 + x, width - 1);
+            mem_copy((void *)(pixels + ((u64)sy * width + sx) * 4), out[y * 4 + x], 4);
+        }
+    }
+}
+
+static void block_store(const block_pixels px, i32 width, i32 height, i32 bx, i32 by, u8 *pixels) {
+    for (i32 y = 0; y < 4 && by * 4 + y < height; y++) {
+        for (i32 x = 0; x < 4 && bx * 4 + x < width; x++) {
+            mem_copy((void *)px[y * 4 + x], pixels + ((u64)(by * 4 + y) * width + bx * 4 + x) * 4, 4);
+        }
+    }
+}
+
+static u32 distance_sq(const u8 *a, const u8 *b, u32 channels) {
+    u32 d = 0;
+    for (u32 c = 0; c < channels; c++) {
+        i32 e = (i32)a[c] - (i32)b[c];
+        d += (u32)(e * e);
+    }
+    return d;
+}
+
+static u32 nearest(const u8 *px, const u8 (*palette)[4], u32 palette_count, u32 channels) {
+    u32 best = 0;
+    u32 best_dist = UINT32_MAX;
+    for (u32 i = 0; i < palette_count; i++) {
+        u32 d = distance_sq(px, palette[i], channels);
+        if (d < best_dist) {
+            best_dist = d;
+            best = i;
+        }
+    }
+    return best;
+}
+
+/* Endpoints
+ *  Project the block onto the dominant direction of its covariance (power iteration), take the extremes
+ *  and pull them in by 1/16 of the range, the quantized palette then straddles the block instead of
+ *  sitting on its outliers.
+ */
+static void block_endpoints(const block_pixels px, u32 channels, f32 hi[4], f32 lo[4]) {
+    f32 mean[4] = {0};
+    for (u32 i = 0; i < 16; i++) {
+        for (u32 c = 0; c < channels; c++) {
+            mean[c] += px[i][c] / 16.0f;
+        }
+    }
+
+    f32 cov[4][4] = {0};
+    for (u32 i = 0; i < 16; i++) {
+        f32 d[4];
+        for (u32 c = 0; c < channels; c++) {
+            d[c] = px[i][c] - mean[c];
+        }
+        for (u32 r = 0; r < channels; r++) {
+            for (u32 c = 0; c < channels; c++) {
+                cov[r][c] += d[r] * d[c];
+            }
+        }
+    }
+
+    // Start from the widest channel, never orthogonal to the answer unless the block is flat
+    u32 widest = 0;
+    for (u32 c = 1; c < channels; c++) {
+        if (cov[c][c] > cov[widest][widest]) {
+            widest = c;
+        }
+    }
+    f32 axis[4] = {0};
+    for (u32 c = 0; c < channels; c++) {
+        axis[c] = cov[widest][c];
+    }
+
+    for (u32 iteration = 0; iteration < 8; iteration++) {
+        f32 next[4] = {0};
+        f32 scale = 0.0f;
+        for (u32 r = 0; r < channels; r++) {
+            for (u32 c = 0; c < channels; c++) {
+                next[r] += cov[r][c] * axis[c];
+            }
+            scale = RL_MAX(scale, fabsf(next[r]));
+        }
+        if (scale == 0.0f) {
+            break;
+        }
+        for (u32 c = 0; c < channels; c++) {
+            axis[c] = next[c] / scale;
+        }
+    }
+
+    f32 length = 0.0f;
+    for (u32 c = 0; c < channels; c++) {
+        length += axis[c] * axis[c];
+    }
+    length = sqrtf(length);
+
+    f32 t_min = 0.0f, t_max = 0.0f;
+    if (length > 0.0f) {
+        for (u32 c = 0; c < channels; c++) {
+            axis[c] /= length;
+        }
+        t_min = INFINITY;
+        t_max = -INFINITY;
+        for (u32 i = 0; i < 16; i++) {
+            f32 t = 0.0f;
+            for (u32 c = 0; c < channels; c++) {
+                t += (px[i][c] - mean[c]) * axis[c];
+            }
+            t_min = RL_MIN(t_min, t);
+            t_max = RL_MAX(t_max, t);
+        }
+        f32 inset = (t_max - t_min) / 16.0f;
+        t_min += inset;
+        t_max -= inset;
+    }
+
+    for (u32 c = 0; c < channels; c++) {
+        hi[c] = RL_CLAMP(mean[c] + axis[c] * t_max, 0.0f, 255.0f);
+        lo[c] = RL_CLAMP(mean[c] + axis[c] * t_min, 0.0f, 255.0f);
+    }
+}
+
+static void write_u16(u8 *out, u16 value) {
+    out[0] = (u8)value;
+    out[1] = (u8)(value >> 8);
+}
+
+static u16 read_u16(const u8 *in) {
+    return (u16)(in[0] | in[1] << 8);
+}
+
+// BC1 -----------------------------------------------------------------------------------------------------
+
+static u16 pack_565(const f32 color[4]) {
+    u32 r = (u32)(color[0] * 31.0f / 255.0f + 0.5f);
+    u32 g = (u32)(color[1] * 63.0f / 255.0f + 0.5f);
+    u32 b = (u32)(color[2] * 31.0f / 255.0f + 0.5f);
+    return (u16)(r << 11 | g << 5 | b);
+}
+
+static void unpack_565(u16 color, u8 out[4]) {
+    u32 r = (color >> 11) & 31;
+    u32 g = (color >> 5) & 63;
+    u32 b = color & 31;
+    out[0] = (u8)(r << 3 | r >> 2);
+    out[1] = (u8)(g << 2 | g >> 4);
+    out[2] = (u8)(b << 3 | b >> 2);
+    out[3] = 255;
+}
+
+static void bc1_palette(u16 c0, u16 c1, b8 four_color, u8 palette[4][4]) {
+    unpack_565(c0, palette[0]);
+    unpack_565(c1, palette[1]);
+    for (u32 c = 0; c < 3; c++) {
+        if (four_color || c0 > c1) {
+            palette[2][c] = (u8)((2 * palette[0][c] + palette[1][c]) / 3);
+            palette[3][c] = (u8)((palette[0][c] + 2 * palette[1][c]) / 3);
+        } else {
+            palette[2][c] = (u8)((palette[0][c] + palette[1][c]) / 2);
+            palette[3][c] = 0;
+        }
+    }
+    palette[2][3] = 255;
+    palette[3][3] = (four_color || c0 > c1) ? 255 : 0;
+}
+
+// Always four color mode, so the same block is valid as the color half of BC3
+static void encode_bc1(const block_pixels px, u8 *out) {
+    f32 hi[4], lo[4];
+    block_endpoints(px, 3, hi, lo);
+
+    u16 c0 = pack_565(hi);
+    u16 c1 = pack_565(lo);
+    if (c0 < c1) {
+        u16 swap = c0;
+        c0 = c1;
+        c1 = swap;
+    }
+
+    u8 palette[4][4];
+    bc1_palette(c0, c1, true, palette);
+
+    // Equal endpoints select three color mode, index 0 is the only safe choice there
+    u32 indices = 0;
+    if (c0 != c1) {
+        for (u32 i = 0; i < 16; i++) {
+            indices |= nearest(px[i], palette, 4, 3) << (i * 2);
+        }
+    }
+
+    write_u16(out, c0);
+    write_u16(out + 2, c1);
+    write_u16(out + 4, (u16)indices);
+    write_u16(out + 6, (u16)(indices >> 16));
+}
+
+static void decode_bc1(const u8 *in, b8 four_color, block_pixels out) {
+    u8 palette[4][4];
+    bc1_palette(read_u16(in), read_u16(in + 2), four_color, palette);
+
+    u32 indices = read_u16(in + 4) | (u32)read_u16(in + 6) << 16;
+    for (u32 i = 0; i < 16; i++) {
+        mem_copy(palette[(indices >> (i * 2)) & 3], out[i], 4);
+    }
+}
+
+// BC4 (one channel, alpha of BC3 and each half of BC5) ---------------------------------------------------
+
+static void encode_bc4(const block_pixels px, u32 channel, u8 *out) {
+    u8 lo = 255, hi = 0;
+    for (u32 i = 0; i < 16; i++) {
+        lo = RL_MIN(lo, px[i][channel]);
+        hi = RL_MAX(hi, px[i][channel]);
+    }
+
+    // Eight value mode: code 0 = hi, 1 = lo, 2..7 step from hi towards lo
+    u64 indices = 0;
+    if (hi > lo) {
+        for (u32 i = 0; i < 16; i++) {
+            u32 step = (u32)((f32)(hi - px[i][channel]) * 7.0f / (f32)(hi - lo) + 0.5f);
+            u64 code = step == 0 ? 0 : step == 7 ? 1 : step + 1;
+            indices |= code << (i * 3);
+        }
+    }
+
+    out[0] = hi;
+    out[1] = lo;
+    for (u32 i = 0; i < 6; i++) {
+        out[2 + i] = (u8)(indices >> (i * 8));
+    }
+}
+
+static void decode_bc4(const u8 *in, u32 channel, block_pixels out) {
+    u32 a0 = in[0], a1 = in[1];
+    u8 palette[8] = {(u8)a0, (u8)a1};
+    if (a0 > a1) {
+        for (u32 i = 1; i < 7; i++) {
+            palette[i + 1] = (u8)(((7 - i) * a0 + i * a1) / 7);
+        }
+    } else {
+        for (u32 i = 1; i < 5; i++) {
+            palette[i + 1] = (u8)(((5 - i) * a0 + i * a1) / 5);
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+
+    u64 indices = 0;
+    for (u32 i = 0; i < 6; i++) {
+        indices |= (u64)in[2 + i] << (i * 8);
+    }
+    for (u32 i = 0; i < 16; i++) {
+        out[i][channel] = palette[(indices >> (i * 3)) & 7];
+    }
+}
+
+// BC7 mode 6 ----------------------------------------------------------------------------------------------
+
+typedef struct bit_stream {
+    u8 *data;
+    u32 position;
+} bit_stream;
+
+static void write_bits(bit_stream *stream, u32 value, u32 count) {
+    for (u32 i = 0; i < count; i++, stream->position++) {
+        if ((value >> i) & 1) {
+            stream->data[stream->position / 8] |= (u8)(1 << (stream->position % 8));
+        }
+    }
+}
+
+static u32 read_bits(bit_stream *stream, u32 count) {
+    u32 value = 0;
+    for (u32 i = 0; i < count; i++, stream->position++) {
+        value |= (u32)((stream->data[stream->position / 8] >> (stream->position % 8)) & 1) << i;
+    }
+    return value;
+}
+
+static void bc7_palette(const u8 e0[4], const u8 e1[4], u8 palette[16][4]) {
+    for (u32 i = 0; i < 16; i++) {
+        u32 w = bc7_weights[i];
+        for (u32 c = 0; c < 4; c++) {
+            palette[i][c] = (u8)(((64 - w) * e0[c] + w * e1[c] + 32) >> 6);
+        }
+    }
+}
+
+// 7 bits per channel plus a p-bit shared by the endpoint's four channels, keeps the p-bit with less error
+static void bc7_quantize(const f32 endpoint[4], u8 out_bits[4], u8 *out_p) {
+    f32 best_error = INFINITY;
+    for (u32 p = 0; p < 2; p++) {
+        u8 bits[4];
+        f32 error = 0.0f;
+        for (u32 c = 0; c < 4; c++) {
+            i32 q = (i32)((endpoint[c] - (f32)p) / 2.0f + 0.5f);
+            bits[c] = (u8)RL_CLAMP(q, 0, 127);
+            f32 e = (f32)(bits[c] << 1 | p) - endpoint[c];
+            error += e * e;
+        }
+        if (error < best_error) {
+            best_error = error;
+            mem_copy(bits, out_bits, 4);
+            *out_p = (u8)p;
+        }
+    }
+}
+
+static void encode_bc7(const block_pixels px, u8 *out) {
+    f32 hi[4], lo[4];
+    block_endpoints(px, 4, hi, lo);
+
+    u8 bits[2][4], p[2];
+    bc7_quantize(lo, bits[0], &p[0]);
+    bc7_quantize(hi, bits[1], &p[1]);
+
+    u8 endpoints[2][4];
+    for (u32 e = 0; e < 2; e++) {
+        for (u32 c = 0; c < 4; c++) {
+            endpoints[e][c] = (u8)(bits[e][c] << 1 | p[e]);
+        }
+    }
+
+    u8 palette[16][4];
+    bc7_palette(endpoints[0], endpoints[1], palette);
+
+    u8 indices[16];
+    for (u32 i = 0; i < 16; i++) {
+        indices[i] = (u8)nearest(px[i], palette, 16, 4);
+    }
+
+    // The first index drops its top bit, swap the endpoints so it is always clear
+    if (indices[0] & 8) {
+        for (u32 c = 0; c < 4; c++) {
+            u8 swap = bits[0][c];
+            bits[0][c] = bits[1][c];
+            bits[1][c] = swap;
+        }
+        u8 swap = p[0];
+        p[0] = p[1];
+        p[1] = swap;
+        for (u32 i = 0; i < 16; i++) {
+            indices[i] = (u8)(15 - indices[i]);
+        }
+    }
+
+    mem_zero(out, 16);
+    bit_stream stream = {out, 0};
+    write_bits(&stream, 1 << 6, 7); // Mode 6
+    for (u32 c = 0; c < 4; c++) {
+        write_bits(&stream, bits[0][c], 7);
+        write_bits(&stream, bits[1][c], 7);
+    }
+    write_bits(&stream, p[0], 1);
+    write_bits(&stream, p[1], 1);
+    write_bits(&stream, indices[0], 3);
+    for (u32 i = 1; i < 16; i++) {
+        write_bits(&stream, indices[i], 4);
+    }
+}
+
+static b8 decode_bc7(const u8 *in, block_pixels out) {
+    bit_stream stream = {(u8 *)in, 0};
+    if (read_bits(&stream, 7) != 1 << 6) {
+        return false; // Not written by encode_bc7
+    }
+
+    u8 endpoints[2][4];
+    for (u32 c = 0; c < 4; c++) {
+        endpoints[0][c] = (u8)(read_bits(&stream, 7) << 1);
+        endpoints[1][c] = (u8)(read_bits(&stream, 7) << 1);
+    }
+    for (u32 e = 0; e < 2; e++) {
+        u8 p = (u8)read_bits(&stream, 1);
+        for (u32 c = 0; c < 4; c++) {
+            endpoints[e][c] |= p;
+        }
+    }
+
+    u8 palette[16][4];
+    bc7_palette(endpoints[0], endpoints[1], palette);
+    for (u32 i = 0; i < 16; i++) {
+        mem_copy(palette[read_bits(&stream, i == 0 ? 3 : 4)], out[i], 4);
+    }
+    return true;
+}
+
+// Levels ------------------------------------------------------------------------------------------------
+
+static void encode_block(TEXTURE_FORMAT format, const block_pixels px, u8 *out) {
+    switch (format) {
+    case TEXTURE_FORMAT_RGBA8:
+        break;
+    case TEXTURE_FORMAT_BC1:
+        encode_bc1(px, out);
+        break;
+    case TEXTURE_FORMAT_BC3:
+        encode_bc4(px, 3, out);
+        encode_bc1(px, out + 8);
+        break;
+    case TEXTURE_FORMAT_BC5:
+        encode_bc4(px, 0, out);
+        encode_bc4(px, 1, out + 8);
+        break;
+    case TEXTURE_FORMAT_BC7:
+        encode_bc7(px, out);
+        break;
+    }
+}
+
+static b8 decode_block(TEXTURE_FORMAT format, const u8 *in, block_pixels out) {
+    switch (format) {
+    case TEXTURE_FORMAT_RGBA8:
+        return false;
+    case TEXTURE_FORMAT_BC1:
+        decode_bc1(in, false, out);
+        return true;
+    case TEXTURE_FORMAT_BC3:
+        decode_bc1(in + 8, true, out);
+        decode_bc4(in, 3, out);
+        return true;
+    case TEXTURE_FORMAT_BC5:
+        for (u32 i = 0; i < 16; i++) {
+            out[i][2] = 0;
+            out[i][3] = 255;
+        }
+        decode_bc4(in, 0, out);
+        decode_bc4(in + 8, 1, out);
+        return true;
+    case TEXTURE_FORMAT_BC7:
+        return decode_bc7(in, out);
+    }
+    return false;
+}
+
+static u32 block_bytes(TEXTURE_FORMAT format) {
+    return format == TEXTURE_FORMAT_BC1 ? 8 : 16;
+}
+
+static f32 srgb_to_linear(u8 value) {
+    f32 v = value / 255.0f;
+    return v <= 0.04045f ? v / 12.92f : powf((v + 0.055f) / 1.055f, 2.4f);
+}
+
+static u8 linear_to_srgb(f32 value) {
+    f32 v = value <= 0.0031308f ? value * 12.92f : 1.055f * powf(value, 1.0f / 2.4f) - 0.055f;
+    return (u8)RL_CLAMP(v * 255.0f + 0.5f, 0.0f, 255.0f);
+}
+
+// 2x2 box filter, color channels are averaged as light unless the data is linear (BC5)
+static void downsample(const u8 *src, i32 width, i32 height, b8 srgb, u8 *dst) {
+    i32 dst_width = texture_level_extent(width, 1);
+    i32 dst_height = texture_level_extent(height, 1);
+
+    for (i32 y = 0; y < dst_height; y++) {
+        const u8 *row0 = src + (u64)RL_MIN(y * 2, height - 1) * width * 4;
+        const u8 *row1 = src + (u64)RL_MIN(y * 2 + 1, height - 1) * width * 4;
+        for (i32 x = 0; x < dst_width; x++) {
+            i32 x0 = RL_MIN(x * 2, width - 1) * 4;
+            i32 x1 = RL_MIN(x * 2 + 1, width - 1) * 4;
+            const u8 *taps[4] = {row0 + x0, row0 + x1, row1 + x0, row1 + x1};
+            u8 *out = dst + ((u64)y * dst_width + x) * 4;
+
+            for (u32 c = 0; c < 4; c++) {
+                if (srgb && c < 3) {
+                    f32 sum = 0.0f;
+                    for (u32 t = 0; t < 4; t++) {
+                        sum += srgb_to_linear(taps[t][c]);
+                    }
+                    out[c] = linear_to_srgb(sum / 4.0f);
+                } else {
+                    out[c] = (u8)((taps[0][c] + taps[1][c] + taps[2][c] + taps[3][c] + 2) / 4);
+                }
+            }
+        }
+    }
+}
+
+TEXTURE_FORMAT texture_cook_format(const rl_texture *texture, const char *filename) {
+    if (texture->format != TEXTURE_FORMAT_RGBA8) {
+        return texture->format;
+    }
+    if (strstr(filename, "_normal")) {
+        return TEXTURE_FORMAT_BC5;
+    }
+    for (u64 i = 3; i < texture->size; i += 4) {
+        if (texture->data[i] != 255) {
+            return TEXTURE_COOK_ALPHA_FORMAT;
+        }
+    }
+    return TEXTURE_FORMAT_BC1;
+}
+
+b8 texture_compress(const rl_texture *texture, TEXTURE_FORMAT format, u32 mip_count, u8 *dst) {
+    if (texture->format != TEXTURE_FORMAT_RGBA8 || !texture_format_is_compressed(format)) {
+        return false;
+    }
+
+    // Ping-pong between two buffers the size of level 1. Heap, not scratch: large textures outgrow the thread arena.
+    u64 level_size = texture_level_size(TEXTURE_FORMAT_RGBA8, texture->width, texture->height, 1);
+    u8 *buffers[2] = {nullptr, nullptr};
+    if (mip_count > 1) {
+        buffers[0] = mem_alloc(level_size, MEM_SUBSYSTEM_ASSET);
+        buffers[1] = mem_alloc(level_size, MEM_SUBSYSTEM_ASSET);
+        if (!buffers[0] || !buffers[1]) {
+            mem_free(buffers[0], level_size, MEM_SUBSYSTEM_ASSET);
+            mem_free(buffers[1], level_size, MEM_SUBSYSTEM_ASSET);
+            return false;
+        }
+    }
+
+    const u8 *level = texture->data;
+    u8 *out = dst;
+    for (u32 l = 0; l < mip_count; l++) {
+        i32 width = texture_level_extent(texture->width, l);
+        i32 height = texture_level_extent(texture->height, l);
+
+        for (i32 by = 0; by < (height + 3) / 4; by++) {
+            for (i32 bx = 0; bx < (width + 3) / 4; bx++) {
+                block_pixels px;
+                block_load(level, width, height, bx, by, px);
+                encode_block(format, px, out);
+                out += block_bytes(format);
+            }
+        }
+
+        if (l + 1 < mip_count) {
+            u8 *next = buffers[l % 2];
+            downsample(level, width, height, format != TEXTURE_FORMAT_BC5, next);
+            level = next;
+        }
+    }
+
+    if (mip_count > 1) {
+        mem_free(buffers[0], level_size, MEM_SUBSYSTEM_ASSET);
+        mem_free(buffers[1], level_size, MEM_SUBSYSTEM_ASSET);
+    }
+    return true;
+}
+
+b8 texture_decompress(const rl_texture *texture, u8 *dst) {
+    const u8 *in = texture->data;
+    for (u32 l = 0; l < texture->mip_count; l++) {
+        i32 width = texture_level_extent(texture->width, l);
+        i32 height = texture_level_extent(texture->height, l);
+        u8 *level = dst + texture_level_offset(TEXTURE_FORMAT_RGBA8, texture->width, texture->height, l);
+
+        for (i32 by = 0; by < (height + 3) / 4; by++) {
+            for (i32 bx = 0; bx < (width + 3) / 4; bx++) {
+                block_pixels px;
+                if (!decode_block(texture->format, in, px)) {
+                    return false;
+                }
+                block_store(px, width, height, bx, by, level);
+                in += block_bytes(texture->format);
+            }
+        }
+    }
+    return true;
+}
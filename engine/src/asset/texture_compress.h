@@ -0,0 +1,23 @@
+#pragma once
+
+#include "defines.h"
+#include "asset/texture.h"
+
+/* Block compression
+ *  Cook-time BC1 / BC3 / BC5 / BC7 encoder. Endpoints come from the principal axis of each 4x4 block,
+ *  BC7 always uses mode 6 (one subset, RGBA endpoints), which is what most fast encoders emit for
+ *  single-region blocks. The decoder covers exactly what the encoder writes and is only used when the
+ *  GPU can't sample a format.
+ */
+
+// Alpha textures cook to BC7, set to TEXTURE_FORMAT_BC3 for older targets
+#define TEXTURE_COOK_ALPHA_FORMAT TEXTURE_FORMAT_BC7
+
+// Format a decoded RGBA8 texture cooks to. "_normal" in the file name marks a normal map (BC5).
+TEXTURE_FORMAT texture_cook_format(const rl_texture *texture, const char *filename);
+
+// Builds a box filtered mip chain from level 0 of the RGBA8 `texture` and encodes `mip_count` levels into `dst`
+b8 texture_compress(const rl_texture *texture, TEXTURE_FORMAT format, u32 mip_count, u8 *dst);
+
+// Expands every level of a compressed `texture` to RGBA8 (texture_level_offset(TEXTURE_FORMAT_RGBA8, ...) layout)
+b8 texture_decompress(const rl_texture *texture, u8 *dst);
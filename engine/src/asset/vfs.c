@@ -0,0 +1,324 @@
+#include "asset/vfs.h"
+
+#include "asset/asset_pack.h"
+#include "core/logger.h"
+#include "memory/containers/dynamic_array.h"
+#include "memory/memory.h"
+#include "util/str.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#define VFS_MAX_MOUNTS 16
+#define VFS_CACHE_SIZE 1024 // Direct mapped, power of two
+
+typedef struct vfs_mount {
+    VFS_MOUNT_TYPE type;
+    char point[VFS_MAX_PATH]; // Prefix, memory mounts hold their full path
+    u32 point_len;
+    char root[VFS_MAX_PATH]; // Directory: real path with a trailing separator
+    rl_file_map pack;
+    const u8 *data; // Memory
+    u64 size;
+} vfs_mount;
+
+typedef enum VFS_QUERY {
+    VFS_QUERY_EXISTS,
+    VFS_QUERY_OPEN,
+    VFS_QUERY_MTIME,
+} VFS_QUERY;
+
+typedef struct vfs_query {
+    VFS_QUERY type;
+    FILE_ACCESS access;
+    rl_vfs_file *file;
+    u64 mtime;
+} vfs_query;
+
+DA_DEFINE(vfs_maps, rl_file_map);
+
+typedef struct vfs_state {
+    vfs_mount mounts[VFS_MAX_MOUNTS];
+    u32 mount_count;
+    vfs_maps retired; // Replaced pack mappings
+    // Path hash with the low byte replaced by the index + 1 of the mount that answered
+    _Atomic u64 cache[VFS_CACHE_SIZE];
+} vfs_state;
+
+static vfs_state state;
+
+static void cache_clear() {
+    for (u32 i = 0; i < VFS_CACHE_SIZE; i++) {
+        atomic_store_explicit(&state.cache[i], 0, memory_order_relaxed);
+    }
+}
+
+static b8 mount_covers(const vfs_mount *mount, const char *path) {
+    if (mount->type == VFS_MOUNT_MEMORY) {
+        return strcmp(path, mount->point) == 0;
+    }
+    return strncmp(path, mount->point, mount->point_len) == 0;
+}
+
+static b8 mount_real_path(const vfs_mount *mount, const char *path, char *out, u64 size) {
+    return (u64)snprintf(out, size, "%s%s", mount->root, path + mount->point_len) < size;
+}
+
+static b8 mount_query(const vfs_mount *mount, const char *path, vfs_query *query) {
+    if (!mount_covers(mount, path)) {
+        return false;
+    }
+
+    switch (mount->type) {
+    case VFS_MOUNT_DIR: {
+        char real[VFS_MAX_PATH];
+        if (!mount_real_path(mount, path, real, sizeof(real))) {
+            return false;
+        }
+        if (query->type == VFS_QUERY_EXISTS) {
+            return platform_file_exists(real);
+        }
+        if (query->type == VFS_QUERY_MTIME) {
+            query->mtime = platform_file_mtime(real);
+            return query->mtime != 0;
+        }
+
+        rl_vfs_file *file = query->file;
+        if (!platform_file_map_open(real, &file->map)) {
+            return false;
+        }
+        platform_file_map_advise(&file->map, 0, file->map.size, query->access);
+        file->data = file->map.data;
+        file->size = file->map.size;
+        return true;
+    }
+    case VFS_MOUNT_PACK: {
+        u64 offset, size;
+        if (!mount->pack.data ||
+            !asset_pack_blob(&mount->pack, asset_name_hash(path + mount->point_len), &offset, &size)) {
+            return false;
+        }
+        if (query->type == VFS_QUERY_OPEN) {
+            platform_file_map_advise(&mount->pack, offset, size, query->access);
+            query->file->data = mount->pack.data + offset;
+            query->file->size = size;
+        }
+        return true; // Found, but not on disk: mtime stays 0
+    }
+    case VFS_MOUNT_MEMORY:
+        if (query->type == VFS_QUERY_OPEN) {
+            query->file->data = mount->data;
+            query->file->size = mount->size;
+        }
+        return true;
+    }
+    return false;
+}
+
+// Tries the mount that answered last time first, then every mount newest first
+static b8 vfs_resolve(const char *path, vfs_query *query) {
+    u64 hash = cstr_hash(path) & ~0xFFull;
+    _Atomic u64 *slot = &state.cache[(hash >> 8) & (VFS_CACHE_SIZE - 1)];
+
+    u64 cached = atomic_load_explicit(slot, memory_order_relaxed);
+    u32 cached_index = (u32)(cached & 0xFF);
+    if ((cached & ~0xFFull) == hash && cached_index != 0 && cached_index <= state.mount_count &&
+        mount_query(&state.mounts[cached_index - 1], path, query)) {
+        return true;
+    }
+
+    for (u32 i = state.mount_count; i-- > 0;) {
+        if (i + 1 != cached_index && mount_query(&state.mounts[i], path, query)) {
+            atomic_store_explicit(slot, hash | (i + 1), memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+static vfs_mount *mount_find(const char *mount_point) {
+    for (u32 i = 0; i < state.mount_count; i++) {
+        if (strcmp(state.mounts[i].point, mount_point) == 0) {
+            return &state.mounts[i];
+        }
+    }
+    return nullptr;
+}
+
+static void mount_release(vfs_mount *mount) {
+    if (mount->type == VFS_MOUNT_PACK && mount->pack.data) {
+        da_append(&state.retired, mount->pack);
+        mount->pack = (rl_file_map){0};
+    }
+}
+
+// Replaces an existing mount in place, keeping its position in the search order
+static vfs_mount *mount_acquire(VFS_MOUNT_TYPE type, const char *mount_point) {
+    u32 len = cstr_len(mount_point);
+    if (len >= VFS_MAX_PATH) {
+        RL_ERROR("VFS mount point '%s' is too long", mount_point);
+        return nullptr;
+    }
+
+    vfs_mount *mount = mount_find(mount_point);
+    if (mount) {
+        mount_release(mount);
+    } else if (state.mount_count == VFS_MAX_MOUNTS) {
+        RL_ERROR("VFS mount table is full, can't mount '%s'", mount_point);
+        return nullptr;
+    } else {
+        mount = &state.mounts[state.mount_count++];
+    }
+
+    *mount = (vfs_mount){.type = type, .point_len = len};
+    mem_copy((void *)mount_point, mount->point, len + 1);
+    cache_clear();
+    return mount;
+}
+
+b8 vfs_system_start() {
+    mem_zero(&state, sizeof(vfs_state));
+    da_init(&state.retired);
+    return true;
+}
+
+void vfs_system_shutdown() {
+    for (u32 i = 0; i < state.mount_count; i++) {
+        mount_release(&state.mounts[i]);
+    }
+    for (u64 i = 0; i < state.retired.count; i++) {
+        asset_pack_close(&state.retired.items[i]);
+    }
+    da_free(&state.retired);
+    state.mount_count = 0;
+    cache_clear();
+}
+
+b8 vfs_mount_dir(const char *mount_point, const char *dir) {
+    char root[VFS_MAX_PATH];
+    char exe_dir[VFS_MAX_PATH];
+    b8 absolute = dir[0] == '/' || dir[0] == '\\' || (dir[0] != '\0' && dir[1] == ':');
+    if (absolute || !platform_executable_dir(exe_dir, sizeof(exe_dir))) {
+        exe_dir[0] = '\0';
+    }
+
+    // Relative to the executable first, then to the working directory
+    u32 dir_len = cstr_len(dir);
+    const char *separator = dir_len > 0 && dir[dir_len - 1] != '/' && dir[dir_len - 1] != '\\' ? "/" : "";
+    snprintf(root, sizeof(root), "%s%s%s", exe_dir, dir, separator);
+    if (!platform_dir_exists(root)) {
+        snprintf(root, sizeof(root), "%s%s", dir, separator);
+        if (!platform_dir_exists(root)) {
+            RL_WARN("VFS: directory '%s' doesn't exist, not mounting it", dir);
+            return false;
+        }
+    }
+
+    vfs_mount *mount = mount_acquire(VFS_MOUNT_DIR, mount_point);
+    if (!mount) {
+        return false;
+    }
+    snprintf(mount->root, sizeof(mount->root), "%s", root);
+    RL_DEBUG("VFS: mounted '%s' at '%s'", mount->root, mount_point);
+    return true;
+}
+
+b8 vfs_mount_pack(const char *mount_point, const char *path) {
+    char real[VFS_MAX_PATH];
+    if (!vfs_real_path(path, real, sizeof(real))) {
+        return false;
+    }
+
+    vfs_mount *mount = mount_acquire(VFS_MOUNT_PACK, mount_point);
+    if (!mount) {
+        return false;
+    }
+    if (!asset_pack_open(real, &mount->pack)) {
+        mount->pack = (rl_file_map){0};
+        return false;
+    }
+
+    // Blobs are read on demand, vfs_prefetch queues the ones about to be needed
+    platform_file_map_advise(&mount->pack, 0, mount->pack.size, FILE_ACCESS_RANDOM);
+    return true;
+}
+
+b8 vfs_mount_memory(const char *path, const void *data, u64 size) {
+    vfs_mount *mount = mount_acquire(VFS_MOUNT_MEMORY, path);
+    if (!mount) {
+        return false;
+    }
+    mount->data = data;
+    mount->size = size;
+    return true;
+}
+
+void vfs_unmount(const char *mount_point) {
+    vfs_mount *mount = mount_find(mount_point);
+    if (!mount) {
+        return;
+    }
+
+    mount_release(mount);
+    u32 index = (u32)(mount - state.mounts);
+    for (u32 i = index; i + 1 < state.mount_count; i++) {
+        state.mounts[i] = state.mounts[i + 1];
+    }
+    state.mount_count--;
+    cache_clear();
+}
+
+b8 vfs_open(const char *path, FILE_ACCESS access, rl_vfs_file *out_file) {
+    *out_file = (rl_vfs_file){0};
+    vfs_query query = {.type = VFS_QUERY_OPEN, .access = access, .file = out_file};
+    return vfs_resolve(path, &query);
+}
+
+void vfs_close(rl_vfs_file *file) {
+    if (file->map.data) {
+        platform_file_map_close(&file->map, file->map.size);
+    }
+    *file = (rl_vfs_file){0};
+}
+
+b8 vfs_exists(const char *path) {
+    vfs_query query = {.type = VFS_QUERY_EXISTS};
+    return vfs_resolve(path, &query);
+}
+
+u64 vfs_mtime(const char *path) {
+    vfs_query query = {.type = VFS_QUERY_MTIME};
+    return vfs_resolve(path, &query) ? query.mtime : 0;
+}
+
+void vfs_prefetch(const char *path) {
+    // Closing a directory mapping doesn't cancel the page cache readahead it started
+    rl_vfs_file file;
+    if (vfs_open(path, FILE_ACCESS_WILLNEED, &file)) {
+        vfs_close(&file);
+    }
+}
+
+b8 vfs_real_path(const char *path, char *out, u64 size) {
+    const vfs_mount *fallback = nullptr;
+    for (u32 i = state.mount_count; i-- > 0;) {
+        const vfs_mount *mount = &state.mounts[i];
+        if (mount->type != VFS_MOUNT_DIR || !mount_covers(mount, path)) {
+            continue;
+        }
+        if (!fallback) {
+            fallback = mount;
+        }
+        vfs_query query = {.type = VFS_QUERY_EXISTS};
+        if (mount_query(mount, path, &query)) {
+            return mount_real_path(mount, path, out, size);
+        }
+    }
+    return fallback && mount_real_path(fallback, path, out, size);
+}
+
+const rl_file_map *vfs_pack(const char *mount_point) {
+    const vfs_mount *mount = mount_find(mount_point);
+    return mount && mount->type == VFS_MOUNT_PACK && mount->pack.data ? &mount->pack : nullptr;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "defines.h"
+
+#include "platform/io/file_io.h"
+
+/* Virtual file system
+ *  Asset code opens virtual paths ("textures/face.jpg"), resolved against an ordered mount table searched
+ *  newest first, so later mounts overlay earlier ones:
+ *  - Directory: loose files under a real directory. Relative roots hang off the executable's directory,
+ *    falling back to the working directory, so runs don't depend on where they were started from.
+ *  - Pack: an .rpak archive mapped once, its cooked blobs show up as "<mount point><asset filename>".
+ *  - Memory: one file backed by caller owned bytes, for generated or patched data.
+ *  Paths are hashed and the mount that answered is remembered, a repeat lookup goes straight to it
+ *  instead of probing every mount with a failing open.
+ *  Mounting is main thread only and must not race loads; lookups are safe from any thread.
+ */
+
+#define VFS_MAX_PATH 512
+
+typedef enum VFS_MOUNT_TYPE {
+    VFS_MOUNT_DIR,
+    VFS_MOUNT_PACK,
+    VFS_MOUNT_MEMORY,
+} VFS_MOUNT_TYPE;
+
+typedef struct rl_vfs_file {
+    const u8 *data;
+    u64 size;
+    rl_file_map map; // Directory mounts only, pack and memory files point into memory owned by the mount
+} rl_vfs_file;
+
+b8 vfs_system_start();
+void vfs_system_shutdown();
+
+// `mount_point` is "" or a prefix ending in '/'. Mounting an existing mount point again replaces it.
+b8 vfs_mount_dir(const char *mount_point, const char *dir);
+// `path` is virtual, resolved through the directory mounts. A replaced pack's mapping stays valid until
+// shutdown, resolved assets may still point into it.
+b8 vfs_mount_pack(const char *mount_point, const char *path);
+b8 vfs_mount_memory(const char *path, const void *data, u64 size);
+void vfs_unmount(const char *mount_point);
+
+// Maps the file and hints the OS how it's about to be read
+b8 vfs_open(const char *path, FILE_ACCESS access, rl_vfs_file *out_file);
+void vfs_close(rl_vfs_file *file);
+
+b8 vfs_exists(const char *path);
+u64 vfs_mtime(const char *path); // Last write time for directory mounts, 0 if missing or not on disk
+// Starts reading `path` in the background, doesn't wait for it
+void vfs_prefetch(const char *path);
+
+// Real path of `path` if it lives in a directory mount, otherwise where it would be created: the newest
+// directory mount covering it. For writers and tools that need an OS path (caches, file watching).
+b8 vfs_real_path(const char *path, char *out, u64 size);
+
+// Mapping of a pack mount, nullptr if it isn't mounted or failed to open
+const rl_file_map *vfs_pack(const char *mount_point);
@@ -1,17 +1,45 @@
 #include "core/event.h"
 
-#include "core/event.h"
 #include "core/logger.h"
-#include "memory/arena.h"
+#include "memory/containers/dynamic_array.h"
+#include "platform/thread.h"
+#include "profiler/profiler.h"
 #include "util/assert.h"
 
-#define MAX_EVENTS 100
+#include <stdatomic.h>
+
+#define EVENT_POST_CAPACITY 4096         // Posted events per frame
+#define EVENT_PAYLOAD_CAPACITY KiB(256)  // Posted payload bytes per frame
+#define EVENT_PAYLOAD_ALIGN 16
+
+DA_DEFINE(event_handlers, rl_event);
+
+typedef struct event_posted {
+    EVENT_TYPE type;
+    u32 size;
+    u64 offset; // Into the frame's payload buffer
+} event_posted;
+
+// Producers bump-allocate from the active frame while the other one is being dispatched
+typedef struct event_frame {
+    event_posted *events;
+    u8 *payload;
+    _Atomic u32 count;
+    _Atomic u64 payload_used;
+    _Atomic u32 writers; // Producers between picking this frame and finishing their copy
+} event_frame;
 
 typedef struct event_system_state {
-    rl_arena events_arena;
-    rl_event *registered_events[MAX_EVENTS];
-    u16 registered_count;
+    // Contiguous handlers per type, dispatch never looks at other types
+    event_handlers handlers[EVENT_TYPE_MAX];
+    u32 firing;                       // Nested event_fire depth
+    b8 needs_compact[EVENT_TYPE_MAX]; // Handlers removed mid-dispatch
     b8 initialized;
+
+    event_frame frames[2];
+    _Atomic u32 active;
+    _Atomic u32 dropped;
+    u32 order[EVENT_POST_CAPACITY]; // Dispatch order, grouped by type
 } event_system_state;
 
 static event_system_state *state;
@@ -23,49 +51,207 @@ u64 event_system_size() {
 b8 event_system_start(void *memory) {
     RL_ASSERT_MSG(!state, "Event system already started!");
     state = memory;
-    rl_arena_init(&state->events_arena, MiB(24), MiB(5), MEM_SUBSYSTEM_EVENT);
+
+    for (u32 i = 0; i < EVENT_TYPE_MAX; i++) {
+        da_init(&state->handlers[i]);
+        state->needs_compact[i] = false;
+    }
+    state->firing = 0;
+
+    for (u32 i = 0; i < 2; i++) {
+        event_frame *frame = &state->frames[i];
+        frame->events = mem_alloc(sizeof(event_posted) * EVENT_POST_CAPACITY, MEM_SUBSYSTEM_EVENT);
+        frame->payload = mem_alloc(EVENT_PAYLOAD_CAPACITY, MEM_SUBSYSTEM_EVENT);
+        atomic_store(&frame->count, 0);
+        atomic_store(&frame->payload_used, 0);
+        atomic_store(&frame->writers, 0);
+    }
+    atomic_store(&state->active, 0);
+    atomic_store(&state->dropped, 0);
+
     state->initialized = true;
-    state->registered_count = 0;
 
     RL_INFO("Event system started!");
     return true;
 }
+
 void event_system_shutdown() {
-    rl_arena_deinit(&state->events_arena);
+    for (u32 i = 0; i < EVENT_TYPE_MAX; i++) {
+        if (state->handlers[i].items) {
+            da_free(&state->handlers[i]);
+        }
+    }
+
+    for (u32 i = 0; i < 2; i++) {
+        mem_free(state->frames[i].events, sizeof(event_posted) * EVENT_POST_CAPACITY, MEM_SUBSYSTEM_EVENT);
+        mem_free(state->frames[i].payload, EVENT_PAYLOAD_CAPACITY, MEM_SUBSYSTEM_EVENT);
+    }
+    state->initialized = false;
     RL_INFO("Event system shutdown...");
 }
 
-void event_fire(EVENT_TYPE type, void *event_data) {
-    for (u16 i = 0; i < state->registered_count; i++) {
-        rl_event *event = state->registered_events[i];
-        if (!event) {
-            RL_WARN("Tried to fire an unregistered event");
-            continue;
+// Drops tombstones left by event_unregister while the list was being walked
+static void handlers_compact(event_handlers *list) {
+    u64 out = 0;
+    for (u64 i = 0; i < list->count; i++) {
+        if (list->items[i].event_callback) {
+            list->items[out++] = list->items[i];
         }
+    }
+    list->count = out;
+}
 
-        if (event->type != type) {
+void event_fire(EVENT_TYPE type, void *event_data) {
+    RL_ASSERT(type < EVENT_TYPE_MAX);
+    event_handlers *list = &state->handlers[type];
+
+    state->firing++;
+
+    // Handlers registered during dispatch start receiving on the next fire
+    u64 count = list->count;
+    for (u64 i = 0; i < count; i++) {
+        rl_event *handler = &list->items[i]; // Re-read, a handler may have grown the array
+        if (!handler->event_callback) {
             continue;
         }
 
-        if (!event->event_callback) {
-            RL_WARN("Tried to fire an unregistered callback");
-            continue;
+        if (handler->event_callback(event_data, handler->user_data)) {
+            break; // Consumed
         }
+    }
 
-        event->event_callback(event_data, event->user_data);
+    state->firing--;
+    if (state->firing == 0) {
+        for (u32 t = 0; t < EVENT_TYPE_MAX; t++) {
+            if (state->needs_compact[t]) {
+                handlers_compact(&state->handlers[t]);
+                state->needs_compact[t] = false;
+            }
+        }
     }
 }
 
-void event_register(EVENT_TYPE type, b8 (*callback)(void *data, void *user_data), void *user_data) {
+void event_register(EVENT_TYPE type, rl_event_callback callback, void *user_data) {
     RL_ASSERT(state->initialized);
-    RL_ASSERT(state->registered_count < MAX_EVENTS);
+    RL_ASSERT(type < EVENT_TYPE_MAX);
     RL_ASSERT(callback);
 
-    rl_event *event = rl_arena_push(&state->events_arena, sizeof(rl_event), alignof(rl_event));
-    event->event_callback = callback;
-    event->type = type;
-    event->user_data = user_data;
+    da_append(&state->handlers[type], ((rl_event){callback, user_data}));
+}
+
+b8 event_unregister(EVENT_TYPE type, rl_event_callback callback, void *user_data) {
+    RL_ASSERT(type < EVENT_TYPE_MAX);
+    event_handlers *list = &state->handlers[type];
+
+    for (u64 i = 0; i < list->count; i++) {
+        rl_event *handler = &list->items[i];
+        if (handler->event_callback != callback || handler->user_data != user_data) {
+            continue;
+        }
+
+        if (state->firing > 0) {
+            // Leave a hole so indices stay valid for the running dispatch
+            handler->event_callback = nullptr;
+            state->needs_compact[type] = true;
+        } else {
+            for (u64 j = i + 1; j < list->count; j++) {
+                list->items[j - 1] = list->items[j];
+            }
+            list->count--;
+        }
+        return true;
+    }
+
+    RL_WARN("Tried to unregister a handler that isn't registered");
+    return false;
+}
+
+b8 event_post(EVENT_TYPE type, const void *payload, u64 size) {
+    RL_ASSERT(type < EVENT_TYPE_MAX);
+
+    // Pin a frame. Re-checking after registering as a writer means the dispatcher either
+    // sees us in `writers` or we see its swap and move to the new frame.
+    event_frame *frame;
+    for (;;) {
+        u32 index = atomic_load(&state->active);
+        frame = &state->frames[index];
+        atomic_fetch_add(&frame->writers, 1);
+        if (atomic_load(&state->active) == index) {
+            break;
+        }
+        atomic_fetch_sub(&frame->writers, 1);
+    }
+
+    b8 ok = false;
+    u32 slot = atomic_fetch_add_explicit(&frame->count, 1, memory_order_relaxed);
+    if (slot < EVENT_POST_CAPACITY) {
+        u64 reserved = (size + EVENT_PAYLOAD_ALIGN - 1) & ~(u64)(EVENT_PAYLOAD_ALIGN - 1);
+        u64 offset = atomic_fetch_add_explicit(&frame->payload_used, reserved, memory_order_relaxed);
+        if (offset + reserved <= EVENT_PAYLOAD_CAPACITY) {
+            if (size > 0) {
+                mem_copy((void *)payload, frame->payload + offset, size);
+            }
+            frame->events[slot] = (event_posted){type, (u32)size, offset};
+            ok = true;
+        } else {
+            // Keep the slot, dispatch skips it
+            frame->events[slot] = (event_posted){EVENT_TYPE_MAX, 0, 0};
+        }
+    }
+
+    atomic_fetch_sub_explicit(&frame->writers, 1, memory_order_release);
+
+    if (!ok) {
+        atomic_fetch_add_explicit(&state->dropped, 1, memory_order_relaxed);
+    }
+    return ok;
+}
+
+void event_dispatch_posted() {
+    RL_PROFILE_ZONE(dispatch_zone, "event_dispatch_posted");
+
+    // New posts go to the other frame from here on
+    u32 index = atomic_load(&state->active);
+    atomic_store(&state->active, index ^ 1);
+
+    event_frame *frame = &state->frames[index];
+    while (atomic_load_explicit(&frame->writers, memory_order_acquire) > 0) {
+        platform_cpu_relax();
+    }
+
+    u32 count = RL_MIN(atomic_load_explicit(&frame->count, memory_order_relaxed), EVENT_POST_CAPACITY);
+
+    // Stable counting sort by type, so each handler list is walked for all of its events back to back
+    u32 offsets[EVENT_TYPE_MAX + 1] = {0};
+    for (u32 i = 0; i < count; i++) {
+        EVENT_TYPE type = frame->events[i].type;
+        if (type < EVENT_TYPE_MAX) {
+            offsets[type + 1]++;
+        }
+    }
+    for (u32 t = 0; t < EVENT_TYPE_MAX; t++) {
+        offsets[t + 1] += offsets[t];
+    }
+    u32 total = offsets[EVENT_TYPE_MAX];
+    for (u32 i = 0; i < count; i++) {
+        EVENT_TYPE type = frame->events[i].type;
+        if (type < EVENT_TYPE_MAX) {
+            state->order[offsets[type]++] = i;
+        }
+    }
+
+    for (u32 i = 0; i < total; i++) {
+        event_posted *e = &frame->events[state->order[i]];
+        event_fire(e->type, e->size ? frame->payload + e->offset : nullptr);
+    }
+
+    atomic_store_explicit(&frame->count, 0, memory_order_relaxed);
+    atomic_store_explicit(&frame->payload_used, 0, memory_order_relaxed);
+
+    u32 dropped = atomic_exchange_explicit(&state->dropped, 0, memory_order_relaxed);
+    if (dropped > 0) {
+        RL_WARN("Event queue full, dropped %u posted events", dropped);
+    }
 
-    state->registered_events[state->registered_count] = event;
-    state->registered_count++;
+    RL_PROFILE_ZONE_END(dispatch_zone);
 }
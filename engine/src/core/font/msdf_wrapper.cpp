@@ -1,15 +1,13 @@
 #include "core/font/msdf_wrapper.h"
 
 #include "core/logger.h"
-#include "memory/memory.h"
+#include "memory/arena.h"
 #include "msdf-atlas-gen/msdf-atlas-gen.h"
 
 using namespace msdf_atlas;
 
-#define PIXEL_RANGE 4.0f
-#define FONT_SCALE 48.0f
-
-b32 msdf_load_font_ascii(const char *path, rl_font *out_font) {
+b32 msdf_load_font_ascii(const u8 *data, u64 size, const char *name, u32 thread_count, rl_arena *arena,
+                         rl_font *out_font) {
     msdfgen::FreetypeHandle *ft_handle = msdfgen::initializeFreetype();
 
     if (ft_handle == nullptr) {
@@ -17,9 +15,10 @@ b32 msdf_load_font_ascii(const char *path, rl_font *out_font) {
         return false;
     }
 
-    auto font = msdfgen::loadFont(ft_handle, path);
+    // FreeType reads the caller's bytes, the file isn't opened a second time
+    auto font = msdfgen::loadFontData(ft_handle, data, (int)size);
     if (!font) {
-        RL_ERROR("failed to load font '%s'", path);
+        RL_ERROR("failed to load font '%s'", name);
         msdfgen::deinitializeFreetype(ft_handle);
         return false;
     }
@@ -39,9 +38,9 @@ b32 msdf_load_font_ascii(const char *path, rl_font *out_font) {
     // setDimensions or setDimensionsConstraint to find the best value
     packer.setDimensionsConstraint(DimensionsConstraint::SQUARE);
     // setScale for a fixed size or setMinimumScale to use the largest that fits
-    packer.setMinimumScale(FONT_SCALE);
+    packer.setMinimumScale(MSDF_FONT_SCALE);
     // setPixelRange or setUnitRange
-    packer.setPixelRange(PIXEL_RANGE);
+    packer.setPixelRange(MSDF_PIXEL_RANGE);
     packer.setMiterLimit(1.0);
     // Compute atlas layout - pack glyphs
     packer.pack(glyphs.data(), glyphs.size());
@@ -59,23 +58,24 @@ b32 msdf_load_font_ascii(const char *path, rl_font *out_font) {
     // GeneratorAttributes can be modified to change the generator's default settings.
     GeneratorAttributes attributes;
     generator.setAttributes(attributes);
-    generator.setThreadCount(4);
+    generator.setThreadCount(static_cast<int>(thread_count));
     // Generate atlas bitmap
     generator.generate(glyphs.data(), glyphs.size());
     // The atlas bitmap can now be retrieved via atlasStorage as a BitmapConstRef.
     // The glyphs array (or fontGeometry) contains positioning data for typesetting text.
 
     out_font->glyph_count = static_cast<u32>(glyphs.size());
-    out_font->glyphs = static_cast<rl_glyph *>(mem_alloc(
+    out_font->glyphs = static_cast<rl_glyph *>(rl_arena_push(
+        arena,
         sizeof(rl_glyph) * out_font->glyph_count,
-        MEM_SUBSYSTEM_ASSET
+        false
         ));
 
     out_font->ascender = static_cast<float>(fontGeometry.getMetrics().ascenderY);
     out_font->descender = static_cast<float>(fontGeometry.getMetrics().descenderY);
     out_font->line_height = fontGeometry.getMetrics().lineHeight;
-    out_font->pixel_range = PIXEL_RANGE;
-    out_font->scale = FONT_SCALE;
+    out_font->pixel_range = MSDF_PIXEL_RANGE;
+    out_font->scale = MSDF_FONT_SCALE;
 
     for (u32 i = 0; i < out_font->glyph_count; i++) {
         const GlyphGeometry &g = glyphs[i];
@@ -107,7 +107,7 @@ b32 msdf_load_font_ascii(const char *path, rl_font *out_font) {
 
     u64 size = static_cast<u64>(width) * height * 4;
     out_font->atlas.size = size;
-    out_font->atlas.data = static_cast<u8 *>(mem_alloc(size, MEM_SUBSYSTEM_ASSET));
+    out_font->atlas.data = static_cast<u8 *>(rl_arena_push(arena, size, false));
 
     // Create a *view* over our buffer
     msdfgen::BitmapRef<byte, 4> bitmap(
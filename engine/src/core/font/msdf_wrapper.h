@@ -7,7 +7,13 @@
 extern "C" {
 #endif
 
-b32 msdf_load_font_ascii(const char *path, rl_font *out_font);
+#define MSDF_PIXEL_RANGE 4.0f
+#define MSDF_FONT_SCALE 48.0f
+
+// Loads the font file in `data` (`name` is for logging). Glyphs and atlas are pushed into `arena`.
+// `thread_count` threads rasterize the atlas.
+b32 msdf_load_font_ascii(const u8 *data, u64 size, const char *name, u32 thread_count, rl_arena *arena,
+                         rl_font *out_font);
 
 #ifdef __cplusplus
 }
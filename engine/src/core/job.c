@@ -0,0 +1,332 @@
+#include "core/job.h"
+
+#include "core/logger.h"
+#include "memory/memory.h"
+#include "platform/platform.h"
+#include "platform/thread.h"
+#include "util/assert.h"
+
+#define JOB_MAX_WORKERS 64
+#define JOB_DEQUE_CAPACITY 4096 // Must be a power of two
+#define JOB_POOL_SIZE (JOB_DEQUE_CAPACITY * 2)
+#define JOB_SPIN_COUNT 64
+#define JOB_CACHE_LINE 64
+
+typedef struct job_slot {
+    rl_job job;
+    rl_job_counter *counter;
+    _Atomic b8 busy; // Set by the owner on push, cleared once the job has been copied out
+} job_slot;
+
+// Chase-Lev deque. Owner pushes/pops at bottom, thieves steal from top.
+typedef struct job_deque {
+    _Atomic i64 top;
+    u8 pad0[JOB_CACHE_LINE - sizeof(i64)];
+    _Atomic i64 bottom;
+    u8 pad1[JOB_CACHE_LINE - sizeof(i64)];
+    _Atomic(job_slot *) items[JOB_DEQUE_CAPACITY];
+} job_deque;
+
+typedef struct job_worker {
+    job_deque deque;
+
+    // Job storage, the owner hands out slots round robin and skips the ones still queued
+    job_slot pool[JOB_POOL_SIZE];
+    u64 pool_next;
+
+    u32 index;
+    u32 steal_seed;
+    rl_thread thread;
+} job_worker;
+
+typedef struct job_system_state {
+    job_worker *workers;
+    u32 worker_count;
+    u32 worker_capacity; // Allocated workers, worker_count shrinks if thread creation fails
+
+    rl_semaphore wake;
+    _Atomic i32 sleeping;
+    _Atomic b8 running;
+} job_system_state;
+
+static job_system_state *state;
+
+_Thread_local static i32 _worker_index = -1;
+
+// -- Deque
+
+static b8 deque_push(job_deque *d, job_slot *slot) {
+    i64 b = atomic_load_explicit(&d->bottom, memory_order_relaxed);
+    i64 t = atomic_load_explicit(&d->top, memory_order_acquire);
+    if (b - t >= JOB_DEQUE_CAPACITY) {
+        return false;
+    }
+
+    atomic_store_explicit(&d->items[b & (JOB_DEQUE_CAPACITY - 1)], slot, memory_order_relaxed);
+    atomic_store_explicit(&d->bottom, b + 1, memory_order_release);
+    return true;
+}
+
+static job_slot *deque_pop(job_deque *d) {
+    i64 b = atomic_load_explicit(&d->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&d->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    i64 t = atomic_load_explicit(&d->top, memory_order_relaxed);
+
+    if (t > b) {
+        // Empty
+        atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+        return nullptr;
+    }
+
+    job_slot *slot = atomic_load_explicit(&d->items[b & (JOB_DEQUE_CAPACITY - 1)], memory_order_relaxed);
+    if (t == b) {
+        // Last item, race against thieves
+        if (!atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed)) {
+            slot = nullptr;
+        }
+        atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+    }
+    return slot;
+}
+
+static job_slot *deque_steal(job_deque *d) {
+    i64 t = atomic_load_explicit(&d->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    i64 b = atomic_load_explicit(&d->bottom, memory_order_acquire);
+
+    if (t >= b) {
+        return nullptr;
+    }
+
+    job_slot *slot = atomic_load_explicit(&d->items[t & (JOB_DEQUE_CAPACITY - 1)], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed)) {
+        return nullptr;
+    }
+    return slot;
+}
+
+// -- Scheduling
+
+// At most JOB_DEQUE_CAPACITY slots are queued, plus one per worker being copied out, so a free slot is
+// normally found within a few probes
+static job_slot *pool_acquire(job_worker *self) {
+    for (u32 i = 0; i < JOB_POOL_SIZE; i++) {
+        job_slot *slot = &self->pool[self->pool_next++ & (JOB_POOL_SIZE - 1)];
+        if (!atomic_load_explicit(&slot->busy, memory_order_acquire)) {
+            atomic_store_explicit(&slot->busy, true, memory_order_relaxed);
+            return slot;
+        }
+    }
+    return nullptr;
+}
+
+static job_slot *job_next(job_worker *self) {
+    job_slot *slot = deque_pop(&self->deque);
+    if (slot) {
+        return slot;
+    }
+
+    // xorshift to spread victims across workers
+    u32 x = self->steal_seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    self->steal_seed = x;
+
+    u32 start = x % state->worker_count;
+    for (u32 i = 0; i < state->worker_count; i++) {
+        u32 victim = (start + i) % state->worker_count;
+        if (victim == self->index) {
+            continue;
+        }
+
+        slot = deque_steal(&state->workers[victim].deque);
+        if (slot) {
+            return slot;
+        }
+    }
+
+    return nullptr;
+}
+
+static void job_execute(job_slot *slot) {
+    // Copy out before running, the owner may recycle the slot once it is released
+    job_slot local = {.job = slot->job, .counter = slot->counter};
+    atomic_store_explicit(&slot->busy, false, memory_order_release);
+    local.job.entry(local.job.data);
+
+    if (local.counter) {
+        atomic_fetch_sub_explicit(&local.counter->pending, 1, memory_order_release);
+    }
+}
+
+static void job_worker_main(void *data) {
+    job_worker *self = data;
+    _worker_index = (i32)self->index;
+
+    while (atomic_load_explicit(&state->running, memory_order_acquire)) {
+        job_slot *slot = nullptr;
+        for (u32 spin = 0; spin < JOB_SPIN_COUNT && !slot; spin++) {
+            slot = job_next(self);
+            if (!slot) {
+                platform_cpu_relax();
+            }
+        }
+
+        if (slot) {
+            job_execute(slot);
+            continue;
+        }
+
+        // Announce before the final check so a concurrent job_run can't miss us
+        atomic_fetch_add_explicit(&state->sleeping, 1, memory_order_seq_cst);
+        slot = job_next(self);
+        if (slot) {
+            atomic_fetch_sub_explicit(&state->sleeping, 1, memory_order_relaxed);
+            job_execute(slot);
+            continue;
+        }
+
+        platform_semaphore_wait(&state->wake);
+        atomic_fetch_sub_explicit(&state->sleeping, 1, memory_order_relaxed);
+    }
+}
+
+u64 job_system_size() {
+    return sizeof(job_system_state);
+}
+
+b8 job_system_start(void *memory) {
+    RL_ASSERT_MSG(!state, "Job system already started!");
+    state = memory;
+
+    u32 cores = platform_get_info()->logical_processors;
+    state->worker_count = RL_CLAMP(cores, 2, JOB_MAX_WORKERS);
+    state->worker_capacity = state->worker_count;
+    state->workers = mem_alloc(sizeof(job_worker) * state->worker_capacity, MEM_SUBSYSTEM_JOB);
+    mem_zero(state->workers, sizeof(job_worker) * state->worker_capacity);
+
+    atomic_store(&state->sleeping, 0);
+    atomic_store(&state->running, true);
+    platform_semaphore_create(&state->wake, 0);
+
+    for (u32 i = 0; i < state->worker_count; i++) {
+        state->workers[i].index = i;
+        state->workers[i].steal_seed = 0x9E3779B9u * (i + 1);
+    }
+
+    // Worker 0 is the thread that started the system
+    _worker_index = 0;
+
+    for (u32 i = 1; i < state->worker_count; i++) {
+        if (!platform_thread_create(job_worker_main, &state->workers[i], &state->workers[i].thread)) {
+            RL_ERROR("Failed to create job worker #%u", i);
+            state->worker_count = i;
+            break;
+        }
+    }
+
+    RL_INFO("Job system started! workers=%u", state->worker_count);
+    return true;
+}
+
+void job_system_shutdown() {
+    if (!state) {
+        return;
+    }
+
+    atomic_store_explicit(&state->running, false, memory_order_release);
+    for (u32 i = 1; i < state->worker_count; i++) {
+        platform_semaphore_signal(&state->wake);
+    }
+
+    for (u32 i = 1; i < state->worker_count; i++) {
+        platform_thread_join(&state->workers[i].thread);
+    }
+
+    platform_semaphore_destroy(&state->wake);
+    mem_free(state->workers, sizeof(job_worker) * state->worker_capacity, MEM_SUBSYSTEM_JOB);
+
+    _worker_index = -1;
+    state = nullptr;
+    RL_INFO("Job system shutdown...");
+}
+
+void job_run(const rl_job *jobs, u32 count, rl_job_counter *counter) {
+    if (counter) {
+        atomic_fetch_add_explicit(&counter->pending, (i32)count, memory_order_relaxed);
+    }
+
+    if (!state || _worker_index < 0) {
+        for (u32 i = 0; i < count; i++) {
+            job_execute(&(job_slot){.job = jobs[i], .counter = counter});
+        }
+        return;
+    }
+
+    job_worker *self = &state->workers[_worker_index];
+    for (u32 i = 0; i < count; i++) {
+        job_slot *slot = pool_acquire(self);
+        if (!slot) {
+            job_execute(&(job_slot){.job = jobs[i], .counter = counter});
+            continue;
+        }
+        slot->job = jobs[i];
+        slot->counter = counter;
+
+        if (!deque_push(&self->deque, slot)) {
+            // Deque full, don't block the producer
+            job_execute(slot);
+        }
+    }
+
+    // Pairs with the fetch_add in job_worker_main
+    atomic_thread_fence(memory_order_seq_cst);
+    i32 sleeping = atomic_load_explicit(&state->sleeping, memory_order_relaxed);
+    for (i32 i = 0; i < RL_MIN(sleeping, (i32)count); i++) {
+        platform_semaphore_signal(&state->wake);
+    }
+}
+
+void job_wait(rl_job_counter *counter) {
+    if (!counter) {
+        return;
+    }
+
+    while (atomic_load_explicit(&counter->pending, memory_order_acquire) > 0) {
+        if (state && _worker_index >= 0) {
+            job_slot *slot = job_next(&state->workers[_worker_index]);
+            if (slot) {
+                job_execute(slot);
+                continue;
+            }
+        }
+        platform_cpu_relax();
+    }
+}
+
+b8 job_try_run_one() {
+    if (!state || _worker_index < 0) {
+        return false;
+    }
+
+    job_slot *slot = job_next(&state->workers[_worker_index]);
+    if (!slot) {
+        return false;
+    }
+    job_execute(slot);
+    return true;
+}
+
+b8 job_is_done(rl_job_counter *counter) {
+    return atomic_load_explicit(&counter->pending, memory_order_acquire) <= 0;
+}
+
+u32 job_worker_count() {
+    return state ? state->worker_count : 1;
+}
+
+i32 job_thread_index() {
+    return _worker_index;
+}
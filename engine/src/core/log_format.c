@@ -0,0 +1,385 @@
+#include "core/log_format.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+typedef enum LOG_ARG_LEN {
+    LEN_NONE,
+    LEN_HH,
+    LEN_H,
+    LEN_L,
+    LEN_LL,
+    LEN_Z,
+    LEN_J,
+    LEN_T,
+    LEN_LONG_DOUBLE,
+} LOG_ARG_LEN;
+
+typedef enum LOG_ARG_TYPE {
+    ARG_LITERAL, // "%%" or an unknown conversion, consumes nothing
+    ARG_INT,
+    ARG_DOUBLE,
+    ARG_LONG_DOUBLE,
+    ARG_STRING,
+    ARG_POINTER,
+    ARG_SKIP, // Consumes a pointer but prints nothing (%n, wide strings)
+} LOG_ARG_TYPE;
+
+typedef struct log_spec {
+    u32 len; // '%' up to and including the conversion character
+    u8 stars;
+    b8 star_precision; // Precision comes from the last '*'
+    i32 precision;     // -1 if not given as digits
+    LOG_ARG_LEN length;
+    LOG_ARG_TYPE type;
+} log_spec;
+
+static b8 is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// `p` points at '%', returns the first character after the spec
+static const char *parse_spec(const char *p, log_spec *s) {
+    const char *start = p++;
+    *s = (log_spec){.precision = -1};
+
+    while (*p && strchr("-+ #0'", *p)) {
+        p++;
+    }
+
+    if (*p == '*') {
+        s->stars++;
+        p++;
+    } else {
+        while (is_digit(*p)) {
+            p++;
+        }
+    }
+
+    if (*p == '.') {
+        p++;
+        if (*p == '*') {
+            s->stars++;
+            s->star_precision = true;
+            p++;
+        } else {
+            s->precision = 0;
+            while (is_digit(*p)) {
+                s->precision = s->precision * 10 + (*p++ - '0');
+            }
+        }
+    }
+
+    switch (*p) {
+    case 'h':
+        s->length = (p[1] == 'h') ? LEN_HH : LEN_H;
+        p += (s->length == LEN_HH) ? 2 : 1;
+        break;
+    case 'l':
+        s->length = (p[1] == 'l') ? LEN_LL : LEN_L;
+        p += (s->length == LEN_LL) ? 2 : 1;
+        break;
+    case 'z':
+        s->length = LEN_Z;
+        p++;
+        break;
+    case 'j':
+        s->length = LEN_J;
+        p++;
+        break;
+    case 't':
+        s->length = LEN_T;
+        p++;
+        break;
+    case 'L':
+        s->length = LEN_LONG_DOUBLE;
+        p++;
+        break;
+    default:
+        break;
+    }
+
+    switch (*p) {
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'o':
+    case 'c':
+        s->type = ARG_INT;
+        break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+        s->type = (s->length == LEN_LONG_DOUBLE) ? ARG_LONG_DOUBLE : ARG_DOUBLE;
+        break;
+    case 's':
+        s->type = (s->length == LEN_L) ? ARG_SKIP : ARG_STRING;
+        break;
+    case 'p':
+        s->type = ARG_POINTER;
+        break;
+    case 'n':
+        s->type = ARG_SKIP;
+        break;
+    default:
+        s->type = ARG_LITERAL;
+        break;
+    }
+
+    if (*p) {
+        p++;
+    }
+    s->len = (u32)(p - start);
+    return p;
+}
+
+static i64 read_int(va_list *args, LOG_ARG_LEN length) {
+    switch (length) {
+    case LEN_L:
+        return (i64)va_arg(*args, long);
+    case LEN_LL:
+    case LEN_LONG_DOUBLE:
+        return (i64)va_arg(*args, long long);
+    case LEN_Z:
+        return (i64)va_arg(*args, size_t);
+    case LEN_J:
+        return (i64)va_arg(*args, intmax_t);
+    case LEN_T:
+        return (i64)va_arg(*args, ptrdiff_t);
+    default:
+        return (i64)va_arg(*args, int);
+    }
+}
+
+static b8 pack(u8 *out, u32 capacity, u32 *size, const void *data, u32 len) {
+    if (*size + len > capacity) {
+        return false;
+    }
+    memcpy(out + *size, data, len);
+    *size += len;
+    return true;
+}
+
+u32 log_pack_args(u8 *out, u32 capacity, const char *fmt, va_list args) {
+    va_list list;
+    va_copy(list, args);
+
+    u32 size = 0;
+    b8 full = false;
+    for (const char *p = fmt; *p && !full;) {
+        if (*p != '%') {
+            p++;
+            continue;
+        }
+
+        log_spec s;
+        p = parse_spec(p, &s);
+
+        i32 star = -1;
+        for (u8 i = 0; i < s.stars && !full; i++) {
+            star = va_arg(list, int);
+            i64 v = star;
+            full = !pack(out, capacity, &size, &v, sizeof(v));
+        }
+        if (full) {
+            break;
+        }
+
+        switch (s.type) {
+        case ARG_INT: {
+            i64 v = read_int(&list, s.length);
+            full = !pack(out, capacity, &size, &v, sizeof(v));
+        } break;
+        case ARG_DOUBLE: {
+            f64 v = va_arg(list, double);
+            full = !pack(out, capacity, &size, &v, sizeof(v));
+        } break;
+        case ARG_LONG_DOUBLE: {
+            long double v = va_arg(list, long double);
+            full = !pack(out, capacity, &size, &v, sizeof(v));
+        } break;
+        case ARG_POINTER: {
+            u64 v = (u64)(uintptr_t)va_arg(list, void *);
+            full = !pack(out, capacity, &size, &v, sizeof(v));
+        } break;
+        case ARG_STRING: {
+            const char *str = va_arg(list, const char *);
+            if (!str) {
+                str = "(null)";
+            }
+
+            if (size + sizeof(u32) + 1 > capacity) {
+                full = true;
+                break;
+            }
+
+            // Only copy what printf would read, bounded by the space left
+            u32 limit = capacity - size - sizeof(u32) - 1;
+            i32 precision = s.star_precision ? star : s.precision;
+            if (precision >= 0 && (u32)precision < limit) {
+                limit = (u32)precision;
+            }
+            u32 len = (u32)strnlen(str, limit);
+
+            pack(out, capacity, &size, &len, sizeof(len));
+            pack(out, capacity, &size, str, len);
+            out[size++] = 0;
+        } break;
+        case ARG_SKIP:
+            (void)va_arg(list, void *);
+            break;
+        case ARG_LITERAL:
+            break;
+        }
+    }
+
+    va_end(list);
+    return size;
+}
+
+static b8 unpack(const u8 *args, u32 args_size, u32 *cursor, void *out, u32 len) {
+    if (*cursor + len > args_size) {
+        return false;
+    }
+    memcpy(out, args + *cursor, len);
+    *cursor += len;
+    return true;
+}
+
+#define LOG_EMIT(value)                                             \
+    (s.stars == 0   ? snprintf(dst, rem, spec, value)               \
+     : s.stars == 1 ? snprintf(dst, rem, spec, stars[0], value)     \
+                    : snprintf(dst, rem, spec, stars[0], stars[1], value))
+
+u32 log_format_packed(char *out, u32 capacity, const char *fmt, const u8 *args, u32 args_size) {
+    if (capacity == 0) {
+        return 0;
+    }
+
+    u32 n = 0;
+    u32 cursor = 0;
+    const char *p = fmt;
+
+    while (*p && n + 1 < capacity) {
+        if (*p != '%') {
+            out[n++] = *p++;
+            continue;
+        }
+
+        const char *start = p;
+        log_spec s;
+        p = parse_spec(p, &s);
+
+        if (s.type == ARG_LITERAL) {
+            if (s.len == 2 && start[1] == '%') {
+                out[n++] = '%';
+            } else {
+                for (u32 i = 0; i < s.len && n + 1 < capacity; i++) {
+                    out[n++] = start[i];
+                }
+            }
+            continue;
+        }
+
+        char spec[32];
+        if (s.len >= sizeof(spec)) {
+            break;
+        }
+        memcpy(spec, start, s.len);
+        spec[s.len] = 0;
+
+        int stars[2] = {0};
+        b8 ok = true;
+        for (u8 i = 0; i < s.stars && ok; i++) {
+            i64 v;
+            ok = unpack(args, args_size, &cursor, &v, sizeof(v));
+            stars[i] = (int)v;
+        }
+        if (!ok) {
+            break;
+        }
+
+        char *dst = out + n;
+        size_t rem = capacity - n;
+        int written = 0;
+
+        switch (s.type) {
+        case ARG_INT: {
+            i64 v;
+            if (!(ok = unpack(args, args_size, &cursor, &v, sizeof(v)))) {
+                break;
+            }
+            switch (s.length) {
+            case LEN_L:
+                written = LOG_EMIT((long)v);
+                break;
+            case LEN_LL:
+            case LEN_LONG_DOUBLE:
+                written = LOG_EMIT((long long)v);
+                break;
+            case LEN_Z:
+                written = LOG_EMIT((size_t)v);
+                break;
+            case LEN_J:
+                written = LOG_EMIT((intmax_t)v);
+                break;
+            case LEN_T:
+                written = LOG_EMIT((ptrdiff_t)v);
+                break;
+            default:
+                written = LOG_EMIT((int)v);
+                break;
+            }
+        } break;
+        case ARG_DOUBLE: {
+            f64 v;
+            if ((ok = unpack(args, args_size, &cursor, &v, sizeof(v)))) {
+                written = LOG_EMIT(v);
+            }
+        } break;
+        case ARG_LONG_DOUBLE: {
+            long double v;
+            if ((ok = unpack(args, args_size, &cursor, &v, sizeof(v)))) {
+                written = LOG_EMIT(v);
+            }
+        } break;
+        case ARG_POINTER: {
+            u64 v;
+            if ((ok = unpack(args, args_size, &cursor, &v, sizeof(v)))) {
+                written = LOG_EMIT((void *)(uintptr_t)v);
+            }
+        } break;
+        case ARG_STRING: {
+            u32 len;
+            if ((ok = unpack(args, args_size, &cursor, &len, sizeof(len)) && cursor + len + 1 <= args_size)) {
+                written = LOG_EMIT((const char *)(args + cursor));
+                cursor += len + 1;
+            }
+        } break;
+        case ARG_SKIP:
+        case ARG_LITERAL:
+            break;
+        }
+
+        // Ran out of packed arguments, the record was truncated at enqueue
+        if (!ok) {
+            break;
+        }
+
+        if (written > 0) {
+            n += ((u32)written < rem) ? (u32)written : (u32)(rem - 1);
+        }
+    }
+
+    out[n] = 0;
+    return n;
+}
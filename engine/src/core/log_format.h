@@ -0,0 +1,18 @@
+#pragma once
+
+#include "defines.h"
+
+#include <stdarg.h>
+
+/* Deferred printf for binary logging
+ *  The caller walks the format string and packs each argument as raw bytes (ints widened to 64 bits,
+ *  strings copied inline). The writer thread walks the same format string again and expands them.
+ */
+
+#define LOG_MAX_ARGS 512 // Packed argument bytes per record
+
+// Returns packed size. Arguments that don't fit are dropped, strings get truncated first.
+u32 log_pack_args(u8 *out, u32 capacity, const char *fmt, va_list args);
+
+// Expands packed arguments into `out`, always null terminated. Returns characters written.
+u32 log_format_packed(char *out, u32 capacity, const char *fmt, const u8 *args, u32 args_size);
@@ -1,6 +1,7 @@
 #include "core/logger.h"
 
-#include "core/logger.h"
+#include "core/log_format.h"
+#include "platform/io/file_io.h"
 #include "platform/platform.h"
 #include "platform/thread.h"
 
@@ -9,80 +10,444 @@
 #include "util/assert.h"
 #include "util/str.h"
 
-#define LOG_MAX_LINE 1024
-#define LOG_QUEUE_SIZE 1024
+#include <stdatomic.h>
+#include <string.h>
 
-typedef struct log_event {
+#define LOG_MAX_LINE 1024
+#define LOG_CELL_SIZE 64
+#define LOG_QUEUE_CELLS (16 * 1024) // Must be a power of two
+#define LOG_RING_SIZE ((u64)LOG_QUEUE_CELLS * LOG_CELL_SIZE)
+#define LOG_BATCH_SIZE (16 * 1024)
+#define LOG_CACHE_LINE 64
+
+#define LOG_DUMP_MAGIC 0x474F4C52 // "RLOG"
+#define LOG_DUMP_VERSION 1
+#define LOG_DUMP_BUFFER_SIZE (64 * 1024)
+#define LOG_DUMP_STRINGS 4096 // Must be a power of two
+
+#define LOG_FILE_MIN_SIZE (64 * 1024)
+
+// Record header, always starts on a cell boundary. The payload follows it and may wrap around the ring.
+typedef struct log_record {
+    u32 cells; // Cells spanned, including the header
+    u32 size;  // Payload bytes
     LOG_LEVEL level;
-    u16 len;
-    char text[LOG_MAX_LINE];
-} log_event;
+    b8 binary; // Payload is packed arguments for `fmt`, otherwise preformatted text
+    u64 thread_id;
+    i64 timestamp;
+    const char *fmt;
+    const char *func;
+} log_record;
 
+STATIC_ASSERT(sizeof(log_record) <= LOG_CELL_SIZE, "log_record must fit in a single cell");
+
+// Bounded MPSC ring of fixed cells, a record spans as many cells as it needs.
+// Producers reserve cells by bumping tail, the writer is the only consumer.
 typedef struct logger_queue {
-    log_event *events;
-    u32 capacity;
-    u32 head;
-    u32 tail;
+    u8 *cells;
+    // Per cell: == pos while free for position `pos`, == pos + 1 once a record starting there is published
+    _Atomic u64 *seqs;
 
-    rl_mutex mutex;
-    rl_thread_sync has_data;
+    _Atomic u64 tail;
+    u8 pad0[LOG_CACHE_LINE - sizeof(u64)];
+    u64 head; // Writer thread only
+    u8 pad1[LOG_CACHE_LINE - sizeof(u64)];
 
-    b8 running;
+    rl_thread_sync has_data;
+    _Atomic b8 writer_sleeping;
+    _Atomic b8 running;
 } logger_queue;
 
+typedef struct logger_dump {
+    char path[260];
+    rl_file file;
+    u8 buffer[LOG_DUMP_BUFFER_SIZE];
+    u32 len;
+    const char *strings[LOG_DUMP_STRINGS]; // Format/function strings already written
+} logger_dump;
+
+// Rotating memory-mapped log file, lines are appended with a memcpy and written back per drain
+typedef struct logger_file {
+    char path[260];
+    rl_file_map map;
+    u64 used;
+    u64 flushed;
+    u64 lines;
+
+    u64 max_size;
+    u64 max_lines; // 0 = unlimited
+    u32 max_files; // Rotated files kept next to the live one
+} logger_file;
+
 typedef struct logger_state {
     rl_thread writer_thread;
     logger_queue queue;
-    b8 warned_full; // To warn about queue being full
+    _Atomic b8 binary;
+    _Atomic u32 dropped;
+    _Atomic b8 warned_full; // To warn about queue being full
+
+    // Writer-side staging
+    u8 payload[LOG_MAX_LINE];
+    char line[LOG_MAX_LINE * 2];
+    char batch[LOG_BATCH_SIZE];
+    u32 batch_len;
+    LOG_LEVEL batch_level;
+
+    _Atomic b8 console;
+
+    // Sinks are swapped under the lock, the writer holds it for a whole drain
+    rl_mutex sink_lock;
+    logger_dump *dump;
+    logger_file *file;
 } logger_state;
 
 static logger_state *state;
 
+_Thread_local static u64 _thread_id;
+
 const char *level_strs[] = {
     "[INFO]: ", "[DEBU]: ", "[TRAC]: ", "[WARN]: ", "[ERRO]: ", "[FATA]: "};
 
-void logger_writer(void *data) {
-    while (state->queue.running) {
-        // Sleep until there's data or shutdown
-        platform_thread_sync_wait(&state->queue.has_data);
+// Indexed by LOG_LEVEL
+static const u8 level_severity[] = {
+    RL_LOG_SEVERITY_INFO, RL_LOG_SEVERITY_DEBUG, RL_LOG_SEVERITY_TRACE,
+    RL_LOG_SEVERITY_WARN, RL_LOG_SEVERITY_ERROR, RL_LOG_SEVERITY_FATAL};
+
+#define LOG_MASK_ALL 0x3F
+
+// Written rarely from the main thread, a stale read only lets a message or two through
+u8 log_category_masks[LOG_CAT_MAX] = {
+    [LOG_CAT_CORE] = LOG_MASK_ALL,
+    [LOG_CAT_RENDERER] = LOG_MASK_ALL,
+    [LOG_CAT_ASSET] = LOG_MASK_ALL,
+    [LOG_CAT_PLATFORM] = LOG_MASK_ALL,
+    [LOG_CAT_MEMORY] = LOG_MASK_ALL,
+    [LOG_CAT_APP] = LOG_MASK_ALL,
+};
+
+// -- Ring
+
+static log_record *ring_record(logger_queue *q, u64 pos) {
+    return (log_record *)(q->cells + (pos & (LOG_QUEUE_CELLS - 1)) * LOG_CELL_SIZE);
+}
+
+static void ring_write(logger_queue *q, u64 pos, const void *data, u32 len) {
+    u64 start = ((pos & (LOG_QUEUE_CELLS - 1)) * LOG_CELL_SIZE + sizeof(log_record)) & (LOG_RING_SIZE - 1);
+    u64 first = RL_MIN(len, LOG_RING_SIZE - start);
+    memcpy(q->cells + start, data, first);
+    memcpy(q->cells, (const u8 *)data + first, len - first);
+}
+
+static void ring_read(logger_queue *q, u64 pos, void *out, u32 len) {
+    u64 start = ((pos & (LOG_QUEUE_CELLS - 1)) * LOG_CELL_SIZE + sizeof(log_record)) & (LOG_RING_SIZE - 1);
+    u64 first = RL_MIN(len, LOG_RING_SIZE - start);
+    memcpy(out, q->cells + start, first);
+    memcpy((u8 *)out + first, q->cells, len - first);
+}
+
+// Reserves `cells` contiguous cells, returns nullptr when the ring is full
+static log_record *queue_reserve(logger_queue *q, u32 cells, u64 *out_pos) {
+    u64 pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    for (;;) {
+        // Cells are released in order, so if the last one is free for this lap they all are
+        u64 last = pos + cells - 1;
+        u64 seq = atomic_load_explicit(&q->seqs[last & (LOG_QUEUE_CELLS - 1)], memory_order_acquire);
+        i64 diff = (i64)(seq - last);
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&q->tail, &pos, pos + cells, memory_order_relaxed, memory_order_relaxed)) {
+                *out_pos = pos;
+                return ring_record(q, pos);
+            }
+        } else if (diff < 0) {
+            return nullptr; // Writer is a full lap behind
+        } else {
+            pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+        }
+    }
+}
 
-        if (!state->queue.running) {
+// -- Writer
+
+static void batch_flush() {
+    if (state->batch_len == 0) {
+        return;
+    }
+    state->batch[state->batch_len] = 0;
+    platform_console_write(state->batch, state->batch_level);
+    state->batch_len = 0;
+}
+
+static void batch_append(const char *text, u32 len, LOG_LEVEL level) {
+    // Console colour is per-call, so a level change starts a new batch
+    if (state->batch_len > 0 &&
+        (level != state->batch_level || state->batch_len + len >= LOG_BATCH_SIZE)) {
+        batch_flush();
+    }
+    memcpy(state->batch + state->batch_len, text, len);
+    state->batch_len += len;
+    state->batch_level = level;
+}
+
+static void dump_flush(logger_dump *dump) {
+    if (dump->len > 0) {
+        platform_file_write(&dump->file, dump->buffer, dump->len);
+        dump->len = 0;
+    }
+}
+
+static void dump_put(logger_dump *dump, const void *data, u32 len) {
+    if (dump->len + len > LOG_DUMP_BUFFER_SIZE) {
+        dump_flush(dump);
+    }
+    memcpy(dump->buffer + dump->len, data, len);
+    dump->len += len;
+}
+
+typedef enum LOG_DUMP_TAG {
+    LOG_DUMP_STRING = 1, // u64 id, u32 len, bytes
+    LOG_DUMP_RECORD = 2, // u64 thread_id, i64 timestamp, u64 fmt_id, u64 func_id, u8 level, u8 binary, u32 size, payload
+} LOG_DUMP_TAG;
+
+// Strings are written once and referenced by address afterwards
+static void dump_string(logger_dump *dump, const char *str) {
+    if (!str) {
+        return;
+    }
+
+    u32 index = (u32)(((u64)(uintptr_t)str * 0x9E3779B97F4A7C15ull) >> 52);
+    for (u32 i = 0; i < LOG_DUMP_STRINGS; i++) {
+        const char **entry = &dump->strings[(index + i) & (LOG_DUMP_STRINGS - 1)];
+        if (*entry == str) {
+            return;
+        }
+        if (!*entry) {
+            *entry = str;
             break;
         }
+    }
 
-        platform_mutex_lock(&state->queue.mutex);
-        while (state->queue.head != state->queue.tail) {
-            log_event e = state->queue.events[state->queue.head];
-            if (e.level == LOG_FATAL) {
-                platform_console_write(e.text, e.level);
-                platform_console_write("\n", e.level);
-                debugBreak();
-                return;
-            }
-            state->queue.head = (state->queue.head + 1) % state->queue.capacity;
-            platform_mutex_unlock(&state->queue.mutex);
+    // Table full: fall through and re-emit, the decoder just overwrites
+    u8 tag = LOG_DUMP_STRING;
+    u64 id = (u64)(uintptr_t)str;
+    u32 len = (u32)strlen(str);
+    dump_put(dump, &tag, sizeof(tag));
+    dump_put(dump, &id, sizeof(id));
+    dump_put(dump, &len, sizeof(len));
+    while (len > 0) {
+        u32 chunk = RL_MIN(len, LOG_DUMP_BUFFER_SIZE);
+        dump_put(dump, str, chunk);
+        str += chunk;
+        len -= chunk;
+    }
+}
+
+static void dump_record(logger_dump *dump, const log_record *r, const u8 *payload) {
+    // Text records carry their formatted payload, the format may not outlive the call
+    const char *fmt = r->binary ? r->fmt : nullptr;
+    dump_string(dump, fmt);
+    dump_string(dump, r->func);
+
+    u8 tag = LOG_DUMP_RECORD;
+    u64 fmt_id = (u64)(uintptr_t)fmt;
+    u64 func_id = (u64)(uintptr_t)r->func;
+    u8 level = (u8)r->level;
+    u8 binary = r->binary;
+    dump_put(dump, &tag, sizeof(tag));
+    dump_put(dump, &r->thread_id, sizeof(r->thread_id));
+    dump_put(dump, &r->timestamp, sizeof(r->timestamp));
+    dump_put(dump, &fmt_id, sizeof(fmt_id));
+    dump_put(dump, &func_id, sizeof(func_id));
+    dump_put(dump, &level, sizeof(level));
+    dump_put(dump, &binary, sizeof(binary));
+    dump_put(dump, &r->size, sizeof(r->size));
+    dump_put(dump, payload, r->size);
+}
+
+// Shifts `path` -> `path.1` -> ... -> `path.max_files`, dropping the oldest
+static void file_rotate_names(const char *path, u32 max_files) {
+    char from[280];
+    char to[280];
+
+    if (max_files == 0) {
+        platform_file_delete(path);
+        return;
+    }
+
+    snprintf(to, sizeof(to), "%s.%u", path, max_files);
+    if (platform_file_exists(to)) {
+        platform_file_delete(to);
+    }
+
+    for (u32 i = max_files - 1; i > 0; i--) {
+        snprintf(from, sizeof(from), "%s.%u", path, i);
+        snprintf(to, sizeof(to), "%s.%u", path, i + 1);
+        if (platform_file_exists(from)) {
+            platform_file_rename(from, to);
+        }
+    }
+
+    snprintf(to, sizeof(to), "%s.1", path);
+    if (platform_file_exists(path)) {
+        platform_file_rename(path, to);
+    }
+}
+
+static b8 file_map_fresh(logger_file *file) {
+    file->used = 0;
+    file->flushed = 0;
+    file->lines = 0;
+    return platform_file_map_create(file->path, file->max_size, &file->map);
+}
+
+static void file_flush(logger_file *file) {
+    platform_file_map_flush(&file->map, file->flushed, file->used - file->flushed);
+    file->flushed = file->used;
+}
+
+static void file_append(logger_file *file, const char *text, u32 len) {
+    if (file->used + len > file->map.size || (file->max_lines && file->lines >= file->max_lines)) {
+        file_flush(file);
+        platform_file_map_close(&file->map, file->used);
+        file_rotate_names(file->path, file->max_files);
+        if (!file_map_fresh(file)) {
+            return;
+        }
+    }
+
+    if (!file->map.data) {
+        return; // Lost the file on a failed rotation
+    }
+
+    memcpy(file->map.data + file->used, text, len);
+    file->used += len;
+    file->lines++;
+}
+
+static u32 format_line(const log_record *r, const u8 *payload) {
+    u32 cap = sizeof(state->line) - 1; // Room for '\n'
+    int prefix = snprintf(state->line, cap, "%s[%s]: ", level_strs[r->level], r->func);
+    u32 len = (u32)RL_CLAMP(prefix, 0, (int)cap - 1);
+
+    if (r->binary) {
+        len += log_format_packed(state->line + len, cap - len, r->fmt, payload, r->size);
+    } else {
+        u32 text = RL_MIN(r->size, cap - 1 - len);
+        memcpy(state->line + len, payload, text);
+        len += text;
+    }
+
+    state->line[len++] = '\n';
+    state->line[len] = 0;
+    return len;
+}
+
+// Drains every published record, returns false if a fatal message was hit
+static b8 logger_drain(u32 *out_count) {
+    logger_queue *q = &state->queue;
+    u32 count = 0;
+    b8 fatal = false;
+
+    platform_mutex_lock(&state->sink_lock);
+    logger_dump *dump = state->dump;
+    logger_file *file = state->file;
+    b8 console = atomic_load_explicit(&state->console, memory_order_relaxed);
+
+    for (;;) {
+        u64 head = q->head;
+        if (atomic_load_explicit(&q->seqs[head & (LOG_QUEUE_CELLS - 1)], memory_order_acquire) != head + 1) {
+            break; // Empty, or the next producer hasn't published yet
+        }
+
+        log_record r = *ring_record(q, head);
+        ring_read(q, head, state->payload, r.size);
+
+        // Hand the cells back to producers one lap ahead
+        for (u32 i = 0; i < r.cells; i++) {
+            atomic_store_explicit(&q->seqs[(head + i) & (LOG_QUEUE_CELLS - 1)], head + i + LOG_QUEUE_CELLS, memory_order_release);
+        }
+        q->head = head + r.cells;
+        count++;
+
+        if (dump) {
+            dump_record(dump, &r, state->payload);
+        }
+
+        u32 len = format_line(&r, state->payload);
+        if (file) {
+            file_append(file, state->line, len);
+        }
+
+        if (r.level == LOG_FATAL) {
+            batch_flush();
+            platform_console_write(state->line, r.level);
+            fatal = true;
+            break;
+        }
+
+        if (console) {
+            batch_append(state->line, len, r.level);
+        }
+    }
+
+    batch_flush();
+    if (dump) {
+        dump_flush(dump);
+    }
+    if (file) {
+        file_flush(file);
+    }
+    platform_mutex_unlock(&state->sink_lock);
 
-            platform_console_write(e.text, e.level);
+    if (fatal) {
+        debugBreak();
+        return false;
+    }
 
-            platform_mutex_lock(&state->queue.mutex);
+    if (count > 0) {
+        u32 dropped = atomic_exchange_explicit(&state->dropped, 0, memory_order_relaxed);
+        if (dropped > 0) {
+            char msg[96];
+            snprintf(msg, sizeof(msg), "[WARN]: Logger queue full, dropped %u messages!\n", dropped);
+            platform_console_write(msg, LOG_WARN);
         }
-        state->warned_full = false;
-        platform_mutex_unlock(&state->queue.mutex);
+        atomic_store_explicit(&state->warned_full, false, memory_order_relaxed);
     }
 
-    // final drain (optional but nice)
-    platform_mutex_lock(&state->queue.mutex);
-    while (state->queue.head != state->queue.tail) {
-        log_event e = state->queue.events[state->queue.head];
-        state->queue.head = (state->queue.head + 1) % state->queue.capacity;
-        platform_mutex_unlock(&state->queue.mutex);
+    *out_count = count;
+    return true;
+}
+
+void logger_writer(void *data) {
+    (void)data;
+    logger_queue *q = &state->queue;
+
+    while (atomic_load_explicit(&q->running, memory_order_acquire)) {
+        u32 drained = 0;
+        if (!logger_drain(&drained)) {
+            return;
+        }
+        if (drained > 0) {
+            continue;
+        }
 
-        platform_console_write(e.text, e.level);
+        // Announce before the final check so a concurrent producer can't miss us
+        atomic_store_explicit(&q->writer_sleeping, true, memory_order_seq_cst);
+        if (!logger_drain(&drained)) {
+            return;
+        }
+        if (drained > 0 || !atomic_load_explicit(&q->running, memory_order_acquire)) {
+            atomic_store_explicit(&q->writer_sleeping, false, memory_order_relaxed);
+            continue;
+        }
 
-        platform_mutex_lock(&state->queue.mutex);
+        // Sleep until there's data or shutdown
+        platform_thread_sync_wait(&q->has_data);
     }
-    state->warned_full = false;
-    platform_mutex_unlock(&state->queue.mutex);
+
+    // Final drain
+    u32 drained = 0;
+    logger_drain(&drained);
 }
 
 u64 logger_system_size() {
@@ -93,17 +458,28 @@ b8 logger_system_start(void *memory) {
     RL_ASSERT_MSG(!state, "Logger system already started!");
     state = memory;
 
-    state->queue.capacity = LOG_QUEUE_SIZE;
-    state->queue.head = 0;
-    state->queue.tail = 0;
-
-    state->queue.events =
-        mem_alloc(sizeof(log_event) * LOG_QUEUE_SIZE, MEM_SUBSYSTEM_LOGGER);
+    logger_queue *q = &state->queue;
+    q->head = 0;
+    atomic_store(&q->tail, 0);
 
-    platform_mutex_create(&state->queue.mutex);
-    platform_thread_sync_create(&state->queue.has_data);
+    q->cells = mem_alloc(LOG_RING_SIZE, MEM_SUBSYSTEM_LOGGER);
+    q->seqs = mem_alloc(sizeof(_Atomic u64) * LOG_QUEUE_CELLS, MEM_SUBSYSTEM_LOGGER);
+    for (u32 i = 0; i < LOG_QUEUE_CELLS; i++) {
+        atomic_store_explicit(&q->seqs[i], i, memory_order_relaxed);
+    }
 
-    state->queue.running = true;
+    state->batch_len = 0;
+    state->dump = nullptr;
+    state->file = nullptr;
+    atomic_store(&state->console, true);
+    atomic_store(&state->binary, false);
+    atomic_store(&state->dropped, 0);
+    atomic_store(&state->warned_full, false);
+    platform_mutex_create(&state->sink_lock);
+
+    platform_thread_sync_create(&q->has_data);
+    atomic_store(&q->writer_sleeping, false);
+    atomic_store(&q->running, true);
     platform_thread_create(logger_writer, nullptr, &state->writer_thread);
 
     RL_INFO("Logger system started!");
@@ -115,7 +491,7 @@ void logger_system_shutdown() {
         return;
 
     // Tell worker to exit
-    state->queue.running = false;
+    atomic_store_explicit(&state->queue.running, false, memory_order_release);
 
     // Wake it if it's sleeping
     platform_thread_sync_signal(&state->queue.has_data);
@@ -123,16 +499,171 @@ void logger_system_shutdown() {
     // Wait for it to finish
     platform_thread_join(&state->writer_thread);
 
-    platform_mutex_destroy(&state->queue.mutex);
+    logger_dump_close();
+    logger_file_close();
+    platform_mutex_destroy(&state->sink_lock);
 
-    mem_free(
-        state->queue.events,
-        sizeof(log_event) * LOG_QUEUE_SIZE,
-        MEM_SUBSYSTEM_LOGGER);
+    mem_free(state->queue.cells, LOG_RING_SIZE, MEM_SUBSYSTEM_LOGGER);
+    mem_free(state->queue.seqs, sizeof(_Atomic u64) * LOG_QUEUE_CELLS, MEM_SUBSYSTEM_LOGGER);
 
     state = nullptr;
 }
 
+void logger_set_category_mask(LOG_CATEGORY category, u8 mask) {
+    RL_ASSERT(category < LOG_CAT_MAX);
+    // Fatal always gets through
+    log_category_masks[category] = (mask & LOG_MASK_ALL) | (1u << LOG_FATAL);
+}
+
+void logger_set_category_level(LOG_CATEGORY category, LOG_LEVEL min_level) {
+    u8 mask = 0;
+    for (u32 level = 0; level <= LOG_FATAL; level++) {
+        if (level_severity[level] >= level_severity[min_level]) {
+            mask |= (u8)(1u << level);
+        }
+    }
+    logger_set_category_mask(category, mask);
+}
+
+void logger_set_console_enabled(b8 enabled) {
+    if (state) {
+        atomic_store_explicit(&state->console, enabled, memory_order_relaxed);
+    }
+}
+
+b8 logger_file_open(const char *path, u64 max_size, u64 max_lines, u32 max_files) {
+    if (!state) {
+        return false;
+    }
+
+    logger_file *file = mem_alloc(sizeof(logger_file), MEM_SUBSYSTEM_LOGGER);
+    mem_zero(file, sizeof(logger_file));
+    snprintf(file->path, sizeof(file->path), "%s", path);
+    file->max_size = RL_MAX(max_size, LOG_FILE_MIN_SIZE);
+    file->max_lines = max_lines;
+    file->max_files = max_files;
+
+    logger_file_close();
+
+    // Keep the previous run around as path.1
+    file_rotate_names(file->path, file->max_files);
+    if (!file_map_fresh(file)) {
+        mem_free(file, sizeof(logger_file), MEM_SUBSYSTEM_LOGGER);
+        return false;
+    }
+
+    platform_mutex_lock(&state->sink_lock);
+    state->file = file;
+    platform_mutex_unlock(&state->sink_lock);
+
+    RL_INFO("Logging to '%s' (max %llu KiB per file, keeping %u)", file->path, file->max_size / 1024, file->max_files);
+    return true;
+}
+
+void logger_file_close() {
+    if (!state) {
+        return;
+    }
+
+    platform_mutex_lock(&state->sink_lock);
+    logger_file *file = state->file;
+    state->file = nullptr;
+    platform_mutex_unlock(&state->sink_lock);
+
+    if (!file) {
+        return;
+    }
+
+    file_flush(file);
+    platform_file_map_close(&file->map, file->used);
+    mem_free(file, sizeof(logger_file), MEM_SUBSYSTEM_LOGGER);
+}
+
+void logger_set_binary_mode(b8 enabled) {
+    if (state) {
+        atomic_store_explicit(&state->binary, enabled, memory_order_relaxed);
+    }
+}
+
+b8 logger_dump_open(const char *path) {
+    if (!state) {
+        return false;
+    }
+
+    logger_dump *dump = mem_alloc(sizeof(logger_dump), MEM_SUBSYSTEM_LOGGER);
+    mem_zero(dump, sizeof(logger_dump));
+    snprintf(dump->path, sizeof(dump->path), "%s", path);
+
+    if (!platform_file_create(dump->path, &dump->file)) {
+        mem_free(dump, sizeof(logger_dump), MEM_SUBSYSTEM_LOGGER);
+        return false;
+    }
+
+    // Header: magic, version, counter frequency for timestamps
+    u32 magic = LOG_DUMP_MAGIC;
+    u32 version = LOG_DUMP_VERSION;
+    i64 clock_freq = platform_get_info()->clock_freq;
+    dump_put(dump, &magic, sizeof(magic));
+    dump_put(dump, &version, sizeof(version));
+    dump_put(dump, &clock_freq, sizeof(clock_freq));
+
+    logger_dump_close();
+
+    platform_mutex_lock(&state->sink_lock);
+    state->dump = dump;
+    platform_mutex_unlock(&state->sink_lock);
+
+    RL_INFO("Logging raw records to '%s'", dump->path);
+    return true;
+}
+
+void logger_flush() {
+    if (!state) {
+        return;
+    }
+
+    // The sink lock keeps the writer out while this thread drains
+    u64 tail = atomic_load_explicit(&state->queue.tail, memory_order_relaxed);
+    for (;;) {
+        u32 drained = 0;
+        if (!logger_drain(&drained)) {
+            return;
+        }
+
+        platform_mutex_lock(&state->sink_lock);
+        b8 done = state->queue.head >= tail;
+        if (done && state->dump) {
+            // A string at a recycled address must be emitted again, not matched against the old text
+            memset(state->dump->strings, 0, sizeof(state->dump->strings));
+        }
+        platform_mutex_unlock(&state->sink_lock);
+
+        if (done) {
+            return;
+        }
+        platform_sleep(1); // A producer reserved cells but hasn't published them yet
+    }
+}
+
+void logger_dump_close() {
+    if (!state) {
+        return;
+    }
+
+    platform_mutex_lock(&state->sink_lock);
+    logger_dump *dump = state->dump;
+    state->dump = nullptr;
+    platform_mutex_unlock(&state->sink_lock);
+
+    if (!dump) {
+        return;
+    }
+
+    dump_flush(dump);
+    platform_file_close(&dump->file);
+    mem_free(dump, sizeof(logger_dump), MEM_SUBSYSTEM_LOGGER);
+}
+
 void log_output(const char *fmt, LOG_LEVEL level, const char *func, ...) {
     // Fallback
     if (!state) {
@@ -143,61 +674,56 @@ void log_output(const char *fmt, LOG_LEVEL level, const char *func, ...) {
         return;
     }
 
-    log_event e = {0};
-    e.level = level;
+    if (!_thread_id) {
+        _thread_id = platform_get_current_thread_id();
+    }
 
-    // Write level prefix + function name
-    int offset = snprintf(
-        e.text,
-        LOG_MAX_LINE,
-        "%s[%s]: ",
-        level_strs[level],
-        func);
+    log_record r = {
+        .level = level,
+        .fmt = fmt,
+        .func = func,
+        .thread_id = _thread_id,
+        .timestamp = platform_get_clock_counter(),
+    };
 
+    // Text mode formats here, binary mode only copies the arguments
+    u8 payload[LOG_MAX_LINE];
     va_list args;
-    va_start(args, level);
-    int written = vsnprintf(
-        e.text + offset,
-        LOG_MAX_LINE - offset - 1,
-        fmt,
-        args);
-    va_end(args);
-
-    if (written < 0)
-        written = 0;
-
-    e.len = (u16)(offset + written);
-
-    if (e.len < LOG_MAX_LINE - 1) {
-        e.text[e.len++] = '\n';
+    va_start(args, func);
+    if (atomic_load_explicit(&state->binary, memory_order_relaxed)) {
+        r.binary = true;
+        r.size = log_pack_args(payload, LOG_MAX_ARGS, fmt, args);
+    } else {
+        int written = vsnprintf((char *)payload, LOG_MAX_LINE, fmt, args);
+        r.size = (u32)RL_CLAMP(written, 0, LOG_MAX_LINE - 1);
     }
-    e.text[e.len] = 0;
-
-    // enqueue (copy struct)
-
-    platform_mutex_lock(&state->queue.mutex);
-
-    u32 next_tail = (state->queue.tail + 1) % state->queue.capacity;
+    va_end(args);
 
-    // check full (drop oldest)
-    if (next_tail == state->queue.head) {
-        state->queue.head = (state->queue.head + 1) % state->queue.capacity;
+    r.cells = (u32)((sizeof(log_record) + r.size + LOG_CELL_SIZE - 1) / LOG_CELL_SIZE);
 
-        if (!state->warned_full) {
-            state->warned_full = true;
+    logger_queue *q = &state->queue;
+    u64 pos;
+    log_record *slot = queue_reserve(q, r.cells, &pos);
+    if (!slot) {
+        // Drop newest, producers must never wait on the writer
+        atomic_fetch_add_explicit(&state->dropped, 1, memory_order_relaxed);
+        if (!atomic_exchange_explicit(&state->warned_full, true, memory_order_relaxed)) {
             platform_console_write("[WARN]: Logger queue full, dropping messages!\n", LOG_WARN);
             debugBreak();
         }
+        return;
     }
 
-    b8 was_empty = (state->queue.head == state->queue.tail);
-
-    state->queue.events[state->queue.tail] = e;
-    state->queue.tail = next_tail;
+    *slot = r;
+    ring_write(q, pos, payload, r.size);
 
-    platform_mutex_unlock(&state->queue.mutex);
+    // Publish
+    atomic_store_explicit(&q->seqs[pos & (LOG_QUEUE_CELLS - 1)], pos + 1, memory_order_release);
 
-    if (was_empty) {
-        platform_thread_sync_signal(&state->queue.has_data);
+    // Pairs with the writer_sleeping store in logger_writer
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&q->writer_sleeping, memory_order_relaxed) &&
+        atomic_exchange_explicit(&q->writer_sleeping, false, memory_order_relaxed)) {
+        platform_thread_sync_signal(&q->has_data);
     }
 }
@@ -2,16 +2,26 @@
 
 #include "asset/asset_internal.h"
 #include "core/event.h"
+#include "core/job.h"
 #include "core/logger.h"
 #include "engine.h"
 #include "memory/arena.h"
 #include "memory/memory.h"
 #include "platform/input.h"
+#include "platform/io/file_io.h"
 #include "platform/platform.h"
 #include "profiler/profiler.h"
 #include "renderer/renderer_frontend.h"
 #include "util/clock.h"
 
+#include <stdio.h>
+
+// Log files go next to the executable
+#define ENGINE_LOG_FILE "realm.log"
+#define ENGINE_LOG_DUMP_FILE "realm.rlog" // Raw records, RL_LOG_BINARY builds only
+#define ENGINE_LOG_MAX_SIZE MiB(8)
+#define ENGINE_LOG_MAX_FILES 3
+
 typedef struct engine_state {
     b8 is_running;
     rl_arena frame_arena;
@@ -30,6 +40,34 @@ b8 on_key_press(void *event, void *data);
 b8 on_focus_gained(void *event, void *data);
 b8 on_focus_lost(void *event, void *data);
 
+// Sinks picked by the build: REALM_LOG_BINARY and REALM_LOG_CONSOLE in engine/CMakeLists.txt
+static void open_log_sinks() {
+    char dir[512];
+    char path[600];
+    if (!platform_executable_dir(dir, sizeof(dir))) {
+        dir[0] = '\0';
+    }
+
+    snprintf(path, sizeof(path), "%s%s", dir, ENGINE_LOG_FILE);
+    b8 file_open = logger_file_open(path, ENGINE_LOG_MAX_SIZE, 0, ENGINE_LOG_MAX_FILES);
+    if (!file_open) {
+        RL_WARN("Failed to open log file '%s', logging to the console only", path);
+    }
+
+#ifdef RL_LOG_BINARY
+    logger_set_binary_mode(true);
+    snprintf(path, sizeof(path), "%s%s", dir, ENGINE_LOG_DUMP_FILE);
+    logger_dump_open(path);
+#endif
+
+#ifdef RL_LOG_NO_CONSOLE
+    // Never silence everything
+    logger_set_console_enabled(!file_open);
+#else
+    (void)file_open;
+#endif
+}
+
 // Bootstrap all subsystems
 b8 rl_engine_create(void) {
     RL_INFO("--------------ENGINE_START--------------");
@@ -55,12 +93,19 @@ b8 rl_engine_create(void) {
         RL_FATAL("Failed to initialize logger sub-system, exiting...");
         return false;
     }
+    open_log_sinks();
 
     if (!platform_system_start()) {
         RL_FATAL("Failed to initialize platform sub-system, exiting...");
         return false;
     }
 
+    void *job_system = mem_alloc(job_system_size(), MEM_SUBSYSTEM_JOB);
+    if (!job_system_start(job_system)) {
+        RL_FATAL("Failed to initialize job sub-system, exiting...");
+        return false;
+    }
+
     input_system_init();
 
     event_register(EVENT_KEY_PRESS, on_key_press, nullptr);
@@ -68,7 +113,7 @@ b8 rl_engine_create(void) {
     event_register(EVENT_WINDOW_FOCUS_LOST, on_focus_lost, nullptr);
 
     void *asset_system = mem_alloc(asset_system_size(), MEM_SUBSYSTEM_ASSET);
-    if (!asset_system_start(asset_system) || !asset_system_load_all()) {
+    if (!asset_system_start(asset_system) || !asset_system_load_startup()) {
         RL_FATAL("Failed to initialize asset sub-system, exiting...");
     }
 
@@ -85,6 +130,9 @@ void rl_engine_destroy(void) {
     RL_DEBUG("Engine shutting down, cleaning up...");
     platform_system_shutdown();
     renderer_destroy();
+    // Waits for in-flight loads, so before the workers are joined
+    asset_system_shutdown();
+    job_system_shutdown();
     event_system_shutdown();
     logger_system_shutdown();
     mem_system_shutdown();
@@ -105,12 +153,17 @@ b8 rl_engine_begin_frame(f64 *out_dt) {
     state.last_frame_time = now;
 
     *out_dt = state.delta_time;
-    input_update(); // Process user input
     if (!platform_pump_messages()) {
         RL_DEBUG("Platform stopped event pump, breaking main loop...");
         state.is_running = false;
         return false;
     }
+    input_update(); // Publish this frame's input snapshot
+
+    // Events posted since last frame, from any thread
+    event_dispatch_posted();
+
+    asset_system_update(); // Finish async asset loads within the frame budget
 
     renderer_begin_frame(state.delta_time);
     RL_PROFILE_ZONE_END(begin_frame_zone);
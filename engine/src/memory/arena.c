@@ -101,7 +101,8 @@ void *rl_arena_push(rl_arena *arena, u64 size, b8 zero) {
         new_commit_pos -= new_commit_pos % arena->commit_size;
         new_commit_pos = RL_MIN(new_commit_pos, arena->reserve_size);
 
-        u8 *mem = (u8 *)arena + arena->commit_pos;
+        // Initialized arenas keep their metadata outside the reservation
+        u8 *mem = (arena->base ? arena->base : (u8 *)arena) + arena->commit_pos;
         u64 commit_size = new_commit_pos - arena->commit_pos;
 
         memory_track_arena_commit(commit_size, arena->mem_type);
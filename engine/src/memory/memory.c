@@ -7,6 +7,7 @@
 #include "profiler/profiler.h"
 #include "util/assert.h"
 
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -32,15 +33,28 @@ f64 to_mib(u64 bytes) {
     return (f64)bytes / (1024.0 * 1024.0);
 }
 
+// Updated from worker threads too (job arenas, decoders), only ever read as statistics
 typedef struct {
-    u64 reserved;
-    u64 committed;
-    u64 live_malloc; // malloc/realloc outstanding
-    u64 arena_reserved[MEM_TYPES_MAX];
-    u64 arena_committed[MEM_TYPES_MAX];
-    u64 malloc_live[MEM_TYPES_MAX];
+    _Atomic u64 reserved;
+    _Atomic u64 committed;
+    _Atomic u64 live_malloc; // malloc/realloc outstanding
+    _Atomic u64 arena_reserved[MEM_TYPES_MAX];
+    _Atomic u64 arena_committed[MEM_TYPES_MAX];
+    _Atomic u64 malloc_live[MEM_TYPES_MAX];
 } memory_system_state;
 
+static void counter_add(_Atomic u64 *counter, u64 delta) {
+    atomic_fetch_add_explicit(counter, delta, memory_order_relaxed);
+}
+
+static void counter_sub(_Atomic u64 *counter, u64 delta) {
+    atomic_fetch_sub_explicit(counter, delta, memory_order_relaxed);
+}
+
+static u64 counter_get(_Atomic u64 *counter) {
+    return atomic_load_explicit(counter, memory_order_relaxed);
+}
+
 static memory_system_state *state;
 
 u64 mem_system_size() {
@@ -50,12 +64,14 @@ u64 mem_system_size() {
 b8 mem_system_start(void *memory) {
     state = memory;
 
-    state->reserved = 0;
-    state->committed = 0;
-    state->live_malloc = 0;
-    mem_zero(state->arena_reserved, sizeof(state->arena_reserved));
-    mem_zero(state->arena_committed, sizeof(state->arena_committed));
-    mem_zero(state->malloc_live, sizeof(state->malloc_live));
+    atomic_init(&state->reserved, 0);
+    atomic_init(&state->committed, 0);
+    atomic_init(&state->live_malloc, 0);
+    for (u32 i = 0; i < MEM_TYPES_MAX; i++) {
+        atomic_init(&state->arena_reserved[i], 0);
+        atomic_init(&state->arena_committed[i], 0);
+        atomic_init(&state->malloc_live[i], 0);
+    }
 
     RL_INFO("Memory system started!");
     return true;
@@ -68,8 +84,8 @@ void mem_system_shutdown() {
 
 void *mem_alloc(u64 size, MEM_TYPE type) {
     if (state) {
-        state->live_malloc += size;
-        state->malloc_live[type] += size;
+        counter_add(&state->live_malloc, size);
+        counter_add(&state->malloc_live[type], size);
     }
 
     void *mem = malloc(size);
@@ -80,8 +96,9 @@ void *mem_realloc(void *old_ptr, u64 old_size, u64 new_size, MEM_TYPE type) {
     void *new_ptr = realloc(old_ptr, new_size);
 
     if (state) {
-        state->live_malloc += (new_size - old_size);
-        state->malloc_live[type] += (new_size - old_size);
+        // A shrink wraps around and subtracts
+        counter_add(&state->live_malloc, new_size - old_size);
+        counter_add(&state->malloc_live[type], new_size - old_size);
     }
 
     return new_ptr;
@@ -90,8 +107,8 @@ void *mem_realloc(void *old_ptr, u64 old_size, u64 new_size, MEM_TYPE type) {
 void mem_free(void *block, u64 size, MEM_TYPE type) {
     RL_ASSERT_MSG(state != nullptr, "Memory subsystem not initialized");
 
-    state->live_malloc -= size;
-    state->malloc_live[type] -= size;
+    counter_sub(&state->live_malloc, size);
+    counter_sub(&state->malloc_live[type], size);
     free(block);
 }
 
@@ -104,28 +121,28 @@ void *mem_zero(void *block, u64 size) {
 }
 
 void memory_track_arena_reserve(u64 size, MEM_TYPE type) {
-    state->reserved += size;
-    state->arena_reserved[type] += size;
+    counter_add(&state->reserved, size);
+    counter_add(&state->arena_reserved[type], size);
 }
 
 void memory_track_arena_commit(u64 size, MEM_TYPE type) {
-    state->committed += size;
-    state->arena_committed[type] += size;
+    counter_add(&state->committed, size);
+    counter_add(&state->arena_committed[type], size);
 }
 
 void memory_track_arena_release(u64 reserve_size, u64 commit_size, MEM_TYPE type) {
-    state->reserved -= reserve_size;
-    state->committed -= commit_size;
-    state->arena_reserved[type] -= reserve_size;
-    state->arena_committed[type] -= commit_size;
+    counter_sub(&state->reserved, reserve_size);
+    counter_sub(&state->committed, commit_size);
+    counter_sub(&state->arena_reserved[type], reserve_size);
+    counter_sub(&state->arena_committed[type], commit_size);
 }
 
 void mem_debug_usage() {
     RL_DEBUG("-------------- Memory Usage --------------");
 
-    mem_fmt r = format_bytes(state->reserved);
-    mem_fmt c = format_bytes(state->committed);
-    mem_fmt m = format_bytes(state->live_malloc);
+    mem_fmt r = format_bytes(counter_get(&state->reserved));
+    mem_fmt c = format_bytes(counter_get(&state->committed));
+    mem_fmt m = format_bytes(counter_get(&state->live_malloc));
 
     RL_DEBUG("Reserved:   %6.1f %s", r.value, r.unit);
     RL_DEBUG("Committed:  %6.1f %s", c.value, c.unit);
@@ -133,9 +150,9 @@ void mem_debug_usage() {
     RL_DEBUG("------------------------------------------");
 
     for (u32 i = 0; i < MEM_TYPES_MAX; i++) {
-        u64 ar = state->arena_reserved[i];
-        u64 ac = state->arena_committed[i];
-        u64 ml = state->malloc_live[i];
+        u64 ar = counter_get(&state->arena_reserved[i]);
+        u64 ac = counter_get(&state->arena_committed[i]);
+        u64 ml = counter_get(&state->malloc_live[i]);
 
         if (!ar && !ac && !ml)
             continue;
@@ -188,6 +205,8 @@ const char *mem_type_to_str(MEM_TYPE type) {
         return "Application";
     case MEM_SUBSYSTEM_GUI:
         return "(Sys) - GUI";
+    case MEM_SUBSYSTEM_JOB:
+        return "(Sys) - Jobs";
     case MEM_ARENA_SCRATCH:
         return "Scratch arena";
     default:
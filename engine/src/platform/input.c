@@ -1,113 +1,167 @@
 #include "platform/input.h"
 #include "core/event.h"
-#include "memory/memory.h"
 
-typedef struct mouse_state {
-    i16 x, y;
-    i16 dx, dy;
-    b8 pressed[MOUSE_MAX_BUTTONS];
-} mouse_state;
+#include <stdatomic.h>
 
-typedef struct keyboard_state {
-    b8 pressed[KEY_MAX_KEYS];
-} keyboard_state;
+#define INPUT_SNAPSHOT_COUNT 3 // Published, previous (may still be read), next
+
+// Written by whichever thread pumps OS messages, drained once per frame
+typedef struct input_pending {
+    _Atomic u32 position; // x in the low 16 bits, y in the high 16 bits
+    _Atomic i32 dx, dy;
+    _Atomic i32 scroll;
+    _Atomic u64 keys[INPUT_KEY_WORDS];
+    _Atomic u8 buttons;
+} input_pending;
 
 typedef struct input_state {
     INPUT_MODE input_mode;
-    mouse_state mouse_now;
-    mouse_state mouse_prev;
-    keyboard_state keyboard_now;
-    keyboard_state keyboard_prev;
+    input_pending pending;
+
+    input_snapshot snapshots[INPUT_SNAPSHOT_COUNT];
+    _Atomic u32 current;
 } input_state;
 
 static input_state state;
 
+static u32 pack_position(i32 x, i32 y) {
+    return (u32)(u16)x | ((u32)(u16)y << 16);
+}
+
 void input_system_init() {
     state.input_mode = INPUT_MODE_UI;
 }
 
 void input_update() {
-    mem_copy(&state.keyboard_now, &state.keyboard_prev, sizeof(keyboard_state));
-    mem_copy(&state.mouse_now, &state.mouse_prev, sizeof(mouse_state));
+    u32 index = atomic_load_explicit(&state.current, memory_order_relaxed);
+    const input_snapshot *prev = &state.snapshots[index];
+    index = (index + 1) % INPUT_SNAPSHOT_COUNT;
+    input_snapshot *next = &state.snapshots[index];
+
+    next->frame = prev->frame + 1;
+    next->timestamp = platform_get_clock_counter();
+
+    u32 position = atomic_load_explicit(&state.pending.position, memory_order_relaxed);
+    next->prev_mouse_x = prev->mouse_x;
+    next->prev_mouse_y = prev->mouse_y;
+    next->mouse_x = (i16)(position & 0xFFFF);
+    next->mouse_y = (i16)(position >> 16);
+    next->mouse_dx = atomic_exchange_explicit(&state.pending.dx, 0, memory_order_relaxed);
+    next->mouse_dy = atomic_exchange_explicit(&state.pending.dy, 0, memory_order_relaxed);
+    next->scroll = atomic_exchange_explicit(&state.pending.scroll, 0, memory_order_relaxed);
+
+    for (u32 i = 0; i < INPUT_KEY_WORDS; i++) {
+        next->prev_keys[i] = prev->keys[i];
+        next->keys[i] = atomic_load_explicit(&state.pending.keys[i], memory_order_relaxed);
+    }
+    next->prev_buttons = prev->buttons;
+    next->buttons = atomic_load_explicit(&state.pending.buttons, memory_order_relaxed);
+
+    atomic_store_explicit(&state.current, index, memory_order_release);
+
+    // At most one motion and one scroll event per frame
+    if (next->mouse_x != next->prev_mouse_x || next->mouse_y != next->prev_mouse_y) {
+        event_fire(EVENT_MOUSE_MOVE, &(input_mouse_move){next->mouse_x, next->mouse_y});
+    }
+    if (next->scroll != 0) {
+        event_fire(EVENT_MOUSE_SCROLL, &(input_mouse_scroll){(i16)RL_CLAMP(next->scroll, INT16_MIN, INT16_MAX)});
+    }
+}
 
-    state.mouse_now.dx = 0;
-    state.mouse_now.dy = 0;
+const input_snapshot *input_get_snapshot() {
+    return &state.snapshots[atomic_load_explicit(&state.current, memory_order_acquire)];
 }
 
 void input_process_key(KEYBOARD_KEY key, b8 is_pressed) {
-    if (state.keyboard_now.pressed[key] != is_pressed) {
-        state.keyboard_now.pressed[key] = is_pressed;
-
-        event_fire(EVENT_KEY_PRESS, &(input_key){key, is_pressed});
+    u64 bit = 1ull << (key % 64);
+    _Atomic u64 *word = &state.pending.keys[key / 64];
+    u64 old = is_pressed ? atomic_fetch_or_explicit(word, bit, memory_order_relaxed)
+                         : atomic_fetch_and_explicit(word, ~bit, memory_order_relaxed);
+
+    if (((old & bit) != 0) != is_pressed) {
+        input_key msg = {key, is_pressed, platform_get_clock_counter()};
+        event_post(EVENT_KEY_PRESS, &msg, sizeof(msg));
     }
 }
 
 void input_process_mouse_button(MOUSE_BUTTON button, b8 is_pressed) {
-    if (state.mouse_now.pressed[button] != is_pressed) {
-        state.mouse_now.pressed[button] = is_pressed;
+    u8 bit = (u8)(1u << button);
+    u8 old = is_pressed ? atomic_fetch_or_explicit(&state.pending.buttons, bit, memory_order_relaxed)
+                        : atomic_fetch_and_explicit(&state.pending.buttons, (u8)~bit, memory_order_relaxed);
 
-        event_fire(EVENT_MOUSE_CLICK, &(input_mouse_button){button, is_pressed});
+    if (((old & bit) != 0) != is_pressed) {
+        input_mouse_button msg = {button, is_pressed, platform_get_clock_counter()};
+        event_post(EVENT_MOUSE_CLICK, &msg, sizeof(msg));
     }
 }
 
 void input_process_mouse_move(i32 position_x, i32 position_y) {
-    if (state.mouse_now.x != position_x || state.mouse_now.y != position_y) {
-        state.mouse_now.dx += position_x - state.mouse_now.x;
-        state.mouse_now.dy += position_y - state.mouse_now.y;
+    u32 position = pack_position(position_x, position_y);
+    u32 old = atomic_exchange_explicit(&state.pending.position, position, memory_order_relaxed);
 
-        state.mouse_now.x = position_x;
-        state.mouse_now.y = position_y;
-
-        event_fire(EVENT_MOUSE_MOVE, &(input_mouse_move){position_x, position_y});
+    if (old != position) {
+        atomic_fetch_add_explicit(&state.pending.dx, (i16)position_x - (i16)(old & 0xFFFF), memory_order_relaxed);
+        atomic_fetch_add_explicit(&state.pending.dy, (i16)position_y - (i16)(old >> 16), memory_order_relaxed);
     }
 }
 
 void input_process_mouse_scroll(i32 delta) {
-    event_fire(EVENT_MOUSE_SCROLL, &(input_mouse_scroll){delta});
+    atomic_fetch_add_explicit(&state.pending.scroll, delta, memory_order_relaxed);
 }
 
 void input_process_mouse_raw(i32 dx, i32 dy) {
-    state.mouse_now.dx = dx;
-    state.mouse_now.dy = dy;
+    atomic_fetch_add_explicit(&state.pending.dx, dx, memory_order_relaxed);
+    atomic_fetch_add_explicit(&state.pending.dy, dy, memory_order_relaxed);
+}
+
+static b8 key_bit(const u64 *keys, KEYBOARD_KEY key) {
+    return (keys[key / 64] >> (key % 64)) & 1;
 }
 
 b8 input_is_key_down(KEYBOARD_KEY key) {
-    return state.keyboard_now.pressed[key];
+    return key_bit(input_get_snapshot()->keys, key);
 }
 
 b8 input_key_pressed(KEYBOARD_KEY key) {
-    return !state.keyboard_prev.pressed[key] && state.keyboard_now.pressed[key];
+    const input_snapshot *s = input_get_snapshot();
+    return !key_bit(s->prev_keys, key) && key_bit(s->keys, key);
 }
 
 b8 input_key_released(KEYBOARD_KEY key) {
-    return state.keyboard_prev.pressed[key] && !state.keyboard_now.pressed[key];
+    const input_snapshot *s = input_get_snapshot();
+    return key_bit(s->prev_keys, key) && !key_bit(s->keys, key);
 }
 
 b8 input_is_mouse_down(MOUSE_BUTTON button) {
-    return state.mouse_now.pressed[button];
+    return (input_get_snapshot()->buttons >> button) & 1;
 }
 
 b8 input_mouse_pressed(MOUSE_BUTTON button) {
-    return !state.mouse_prev.pressed[button] && state.mouse_now.pressed[button];
+    const input_snapshot *s = input_get_snapshot();
+    return !((s->prev_buttons >> button) & 1) && ((s->buttons >> button) & 1);
 }
 
 b8 input_mouse_released(MOUSE_BUTTON button) {
-    return state.mouse_prev.pressed[button] && !state.mouse_now.pressed[button];
+    const input_snapshot *s = input_get_snapshot();
+    return ((s->prev_buttons >> button) & 1) && !((s->buttons >> button) & 1);
 }
 
 void input_get_mouse_position(vec2 pos) {
-    pos[0] = (f32)state.mouse_now.x;
-    pos[1] = (f32)state.mouse_now.y;
+    const input_snapshot *s = input_get_snapshot();
+    pos[0] = (f32)s->mouse_x;
+    pos[1] = (f32)s->mouse_y;
 }
 
 void input_get_previous_mouse_position(vec2 pos) {
-    pos[0] = (f32)state.mouse_prev.x;
-    pos[1] = (f32)state.mouse_prev.y;
+    const input_snapshot *s = input_get_snapshot();
+    pos[0] = (f32)s->prev_mouse_x;
+    pos[1] = (f32)s->prev_mouse_y;
 }
 
 void input_get_mouse_delta(vec2 delta_pos) {
-    delta_pos[0] = (f32)state.mouse_prev.dx;
-    delta_pos[1] = (f32)state.mouse_prev.dy;
+    const input_snapshot *s = input_get_snapshot();
+    delta_pos[0] = (f32)s->mouse_dx;
+    delta_pos[1] = (f32)s->mouse_dy;
 }
 
 void input_set_mode(platform_window *window, INPUT_MODE mode) {
@@ -116,8 +170,9 @@ void input_set_mode(platform_window *window, INPUT_MODE mode) {
 
     state.input_mode = mode;
 
-    state.mouse_now.dx = 0;
-    state.mouse_now.dy = 0;
+    // Don't carry motion across the cursor mode switch
+    atomic_store_explicit(&state.pending.dx, 0, memory_order_relaxed);
+    atomic_store_explicit(&state.pending.dy, 0, memory_order_relaxed);
 
     switch (mode) {
     case INPUT_MODE_UI:
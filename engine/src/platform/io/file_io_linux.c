@@ -0,0 +1,446 @@
+#include "platform/io/file_io.h"
+
+#ifdef PLATFORM_LINUX
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/sendfile.h>
+#include <stdio.h>
+#include <sys/inotify.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "core/logger.h"
+#include "memory/memory.h"
+#include "util/assert.h"
+
+// fd 0 is a valid descriptor, handles hold fd + 1 so nullptr keeps meaning "not open"
+static void *fd_to_handle(int fd) {
+    return (void *)(intptr_t)(fd + 1);
+}
+
+static int handle_to_fd(void *handle) {
+    return (int)(intptr_t)handle - 1;
+}
+
+static int file_access_mode(const FILE_PERM *perms) {
+    switch (*perms) {
+    case P_FILE_READ:
+        return O_RDONLY;
+    case P_FILE_WRITE:
+        return O_WRONLY;
+    case P_FILE_EXECUTE:
+        return O_RDONLY;
+    case P_FILE_ALL:
+        return O_RDWR;
+    }
+    return O_RDONLY;
+}
+
+b8 platform_file_exists(const char *path) {
+    if (!path) {
+        return false;
+    }
+    struct stat st;
+    return stat(path, &st) == 0 && S_ISREG(st.st_mode);
+}
+
+b8 platform_dir_exists(const char *path) {
+    if (!path) {
+        return false;
+    }
+    struct stat st;
+    return stat(path, &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+b8 platform_dir_create(const char *path) {
+    if (mkdir(path, 0755) != 0 && errno != EEXIST) {
+        RL_ERROR("Failed to create directory='%s'. Error: %d", path, errno);
+        return false;
+    }
+    return true;
+}
+
+u64 platform_file_mtime(const char *path) {
+    struct stat st;
+    if (!path || stat(path, &st) != 0) {
+        return 0;
+    }
+    return (u64)st.st_mtim.tv_sec * 1000000000ull + (u64)st.st_mtim.tv_nsec;
+}
+
+b8 platform_executable_dir(char *out, u64 size) {
+    ssize_t len = readlink("/proc/self/exe", out, size - 1);
+    if (len <= 0 || (u64)len >= size - 1) {
+        return false;
+    }
+    out[len] = '\0';
+
+    char *slash = strrchr(out, '/');
+    if (!slash) {
+        return false;
+    }
+    slash[1] = '\0';
+    return true;
+}
+
+b8 platform_file_copy(const char *source_path, const char *dest_path, b8 overwrite) {
+    if (!source_path || !dest_path) {
+        RL_ERROR("Failed to copy file: invalid path(s)");
+        return false;
+    }
+
+    int src = open(source_path, O_RDONLY);
+    if (src < 0) {
+        RL_ERROR("Failed to copy file '%s' -> '%s'. Error: %d", source_path, dest_path, errno);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(src, &st) != 0) {
+        RL_ERROR("Failed to copy file '%s' -> '%s'. Error: %d", source_path, dest_path, errno);
+        close(src);
+        return false;
+    }
+
+    int flags = O_WRONLY | O_CREAT | O_TRUNC;
+    if (!overwrite) {
+        flags |= O_EXCL;
+    }
+
+    int dst = open(dest_path, flags, st.st_mode & 0777);
+    if (dst < 0) {
+        RL_ERROR("Failed to copy file '%s' -> '%s'. Error: %d", source_path, dest_path, errno);
+        close(src);
+        return false;
+    }
+
+    // In-kernel copy, no userspace buffer
+    off_t offset = 0;
+    while (offset < st.st_size) {
+        ssize_t sent = sendfile(dst, src, &offset, (size_t)(st.st_size - offset));
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            RL_ERROR("Failed to copy file '%s' -> '%s'. Error: %d", source_path, dest_path, errno);
+            close(src);
+            close(dst);
+            return false;
+        }
+    }
+
+    close(src);
+    close(dst);
+    return true;
+}
+
+b8 platform_file_delete(const char *path) {
+    if (!path) {
+        RL_ERROR("Failed to delete file: invalid path");
+        return false;
+    }
+
+    if (unlink(path) != 0) {
+        if (errno == ENOENT) {
+            return true;
+        }
+        RL_ERROR("Failed to delete file '%s'. Error: %d", path, errno);
+        return false;
+    }
+
+    return true;
+}
+
+b8 platform_file_rename(const char *source_path, const char *dest_path) {
+    if (rename(source_path, dest_path) != 0) {
+        RL_ERROR("Failed to rename file '%s' -> '%s'. Error: %d", source_path, dest_path, errno);
+        return false;
+    }
+    return true;
+}
+
+b8 platform_file_open(const char *path, FILE_PERM perms, rl_file *out_file) {
+    RL_ASSERT_MSG(out_file && !out_file->handle, "Trying to open a non-closed file");
+
+    out_file->buf_len = 0;
+    out_file->buf = nullptr;
+
+    int fd = open(path, file_access_mode(&perms) | O_CLOEXEC);
+    if (fd < 0) {
+        RL_ERROR("Failed to open file='%s'. Error: %d", path, errno);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        RL_ERROR("Failed to stat file='%s'. Error: %d", path, errno);
+        close(fd);
+        return false;
+    }
+
+    const char *name = strrchr(path, '/');
+    if (name) {
+        name += 1;
+    } else {
+        name = path;
+    }
+
+    out_file->path = path;
+    out_file->name = name;
+    out_file->handle = fd_to_handle(fd);
+    out_file->size = (u64)st.st_size;
+
+    return true;
+}
+
+b8 platform_file_read_all(rl_file *file) {
+    if (!file || !file->handle) {
+        return false;
+    }
+
+    int fd = handle_to_fd(file->handle);
+    if (file->size == 0) {
+        return true;
+    }
+    file->buf = mem_alloc(file->size, MEM_FILE_BUFFERS);
+    file->buf_len = file->size;
+
+    u64 total_read = 0;
+    while (total_read < file->size) {
+        ssize_t bytes = read(fd, (u8 *)file->buf + total_read, file->size - total_read);
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes <= 0) {
+            RL_ERROR("Failed to read file='%s'. Error: %d", file->name, errno);
+            mem_free(file->buf, file->buf_len, MEM_FILE_BUFFERS);
+            file->buf = nullptr;
+            file->buf_len = 0;
+            return false;
+        }
+        total_read += (u64)bytes;
+    }
+    return true;
+}
+
+void platform_file_close(rl_file *file) {
+    if (!file || !file->handle) {
+        return;
+    }
+
+    int fd = handle_to_fd(file->handle);
+    close(fd);
+
+    file->handle = nullptr;
+    if (file->buf) {
+        mem_free(file->buf, file->buf_len, MEM_FILE_BUFFERS);
+        file->buf = nullptr;
+        file->buf_len = 0;
+    }
+}
+
+b8 platform_file_create(const char *path, rl_file *out_file) {
+    RL_ASSERT_MSG(out_file && !out_file->handle, "Trying to create over a non-closed file");
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        RL_ERROR("Failed to create file='%s'. Error: %d", path, errno);
+        return false;
+    }
+
+    const char *name = strrchr(path, '/');
+
+    out_file->path = path;
+    out_file->name = name ? name + 1 : path;
+    out_file->handle = fd_to_handle(fd);
+    out_file->size = 0;
+    out_file->buf = nullptr;
+    out_file->buf_len = 0;
+    return true;
+}
+
+b8 platform_file_write(rl_file *file, const void *data, u64 size) {
+    int fd = handle_to_fd(file->handle);
+    const u8 *src = data;
+    while (size > 0) {
+        ssize_t bytes = write(fd, src, size);
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes <= 0) {
+            RL_ERROR("Failed to write file='%s'. Error: %d", file->name, errno);
+            return false;
+        }
+        src += bytes;
+        size -= (u64)bytes;
+        file->size += (u64)bytes;
+    }
+    return true;
+}
+
+b8 platform_file_map_open(const char *path, rl_file_map *out_map) {
+    RL_ASSERT_MSG(out_map && !out_map->data, "Trying to map over a non-closed mapping");
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    void *data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        RL_ERROR("Failed to map file='%s'. Error: %d", path, errno);
+        close(fd);
+        return false;
+    }
+
+    out_map->handle = fd_to_handle(fd);
+    out_map->mapping = nullptr;
+    out_map->data = data;
+    out_map->size = (u64)st.st_size;
+    return true;
+}
+
+b8 platform_file_map_create(const char *path, u64 size, rl_file_map *out_map) {
+    RL_ASSERT_MSG(out_map && !out_map->data, "Trying to map over a non-closed mapping");
+
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        RL_ERROR("Failed to create file='%s'. Error: %d", path, errno);
+        return false;
+    }
+
+    // Allocate the blocks now, a store into a sparse mapping on a full disk raises SIGBUS instead of failing
+    int err = posix_fallocate(fd, 0, (off_t)size);
+    if (err != 0) {
+        RL_ERROR("Failed to size file='%s' to %llu bytes. Error: %d", path, size, err);
+        close(fd);
+        unlink(path);
+        return false;
+    }
+
+    void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        RL_ERROR("Failed to map file='%s'. Error: %d", path, errno);
+        close(fd);
+        return false;
+    }
+
+    out_map->handle = fd_to_handle(fd);
+    out_map->mapping = nullptr;
+    out_map->data = data;
+    out_map->size = size;
+    return true;
+}
+
+void platform_file_map_flush(rl_file_map *map, u64 offset, u64 size) {
+    if (!map->data || size == 0) {
+        return;
+    }
+
+    // msync wants a page aligned start
+    u64 page = (u64)sysconf(_SC_PAGESIZE);
+    u64 start = offset & ~(page - 1);
+    msync(map->data + start, offset + size - start, MS_ASYNC);
+}
+
+void platform_file_map_close(rl_file_map *map, u64 used) {
+    if (!map->data) {
+        return;
+    }
+
+    int fd = handle_to_fd(map->handle);
+    munmap(map->data, map->size);
+    if (used < map->size && ftruncate(fd, (off_t)used) != 0) {
+        RL_ERROR("Failed to truncate mapped file. Error: %d", errno);
+    }
+    close(fd);
+
+    map->handle = nullptr;
+    map->data = nullptr;
+    map->size = 0;
+}
+
+void platform_file_map_advise(const rl_file_map *map, u64 offset, u64 size, FILE_ACCESS access) {
+    if (!map->data || offset >= map->size) {
+        return;
+    }
+    size = RL_MIN(size, map->size - offset);
+
+    // madvise wants a page aligned start
+    u64 page = (u64)sysconf(_SC_PAGESIZE);
+    u64 start = offset & ~(page - 1);
+    int advice = access == FILE_ACCESS_SEQUENTIAL ? MADV_SEQUENTIAL
+                 : access == FILE_ACCESS_RANDOM   ? MADV_RANDOM
+                                                  : MADV_WILLNEED;
+    madvise(map->data + start, size + (offset - start), advice);
+
+    // Readahead on the file too, so the pages are in flight before the first fault
+    int fadvice = access == FILE_ACCESS_SEQUENTIAL ? POSIX_FADV_SEQUENTIAL
+                  : access == FILE_ACCESS_RANDOM   ? POSIX_FADV_RANDOM
+                                                   : POSIX_FADV_WILLNEED;
+    posix_fadvise(handle_to_fd(map->handle), (off_t)offset, (off_t)size, fadvice);
+}
+
+b8 platform_file_watch_open(rl_file_watch *out_watch) {
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        RL_ERROR("Failed to create inotify instance. Error: %d", errno);
+        return false;
+    }
+    out_watch->handle = fd_to_handle(fd);
+    return true;
+}
+
+b8 platform_file_watch_add(rl_file_watch *watch, const char *dir) {
+    // Editors often save to a temp file and rename it over the original, hence IN_MOVED_TO
+    int fd = handle_to_fd(watch->handle);
+    if (inotify_add_watch(fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        RL_ERROR("Failed to watch directory='%s'. Error: %d", dir, errno);
+        return false;
+    }
+    return true;
+}
+
+void platform_file_watch_poll(rl_file_watch *watch, rl_file_watch_fn callback, void *user_data) {
+    if (!watch->handle) {
+        return;
+    }
+
+    int fd = handle_to_fd(watch->handle);
+    alignas(struct inotify_event) char buf[4096];
+
+    for (;;) {
+        ssize_t len = read(fd, buf, sizeof(buf));
+        if (len <= 0) {
+            return; // EAGAIN, nothing pending
+        }
+
+        for (char *ptr = buf; ptr < buf + len;) {
+            const struct inotify_event *event = (const struct inotify_event *)ptr;
+            if (event->len > 0 && !(event->mask & IN_ISDIR)) {
+                callback(event->name, user_data);
+            }
+            ptr += sizeof(struct inotify_event) + event->len;
+        }
+    }
+}
+
+void platform_file_watch_close(rl_file_watch *watch) {
+    if (!watch->handle) {
+        return;
+    }
+    close(handle_to_fd(watch->handle));
+    watch->handle = nullptr;
+}
+
+#endif // PLATFORM_LINUX
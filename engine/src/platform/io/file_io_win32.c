@@ -5,6 +5,8 @@
 #include "util/assert.h"
 #include "util/str.h"
 
+#include <string.h>
+
 typedef struct file_system_state {
     rl_arena file_arena;
 } file_system_state;
@@ -17,6 +19,38 @@ b8 platform_file_exists(const char *path) {
     return (attrs != INVALID_FILE_ATTRIBUTES) && !(attrs & FILE_ATTRIBUTE_DIRECTORY);
 }
 
+b8 platform_executable_dir(char *out, u64 size) {
+    DWORD len = GetModuleFileNameA(nullptr, out, (DWORD)size);
+    if (len == 0 || len >= size) {
+        return false;
+    }
+
+    char *slash = strrchr(out, '\\');
+    char *forward = strrchr(out, '/');
+    slash = forward > slash ? forward : slash;
+    if (!slash) {
+        return false;
+    }
+    slash[1] = '\0';
+    return true;
+}
+
+b8 platform_dir_create(const char *path) {
+    if (!CreateDirectoryA(path, nullptr) && GetLastError() != ERROR_ALREADY_EXISTS) {
+        RL_ERROR("Failed to create directory='%s'. Error: %d", path, GetLastError());
+        return false;
+    }
+    return true;
+}
+
+u64 platform_file_mtime(const char *path) {
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExA(path, GetFileExInfoStandard, &data)) {
+        return 0;
+    }
+    return ((u64)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+}
+
 b8 platform_dir_exists(const char *path) {
     DWORD attrs = GetFileAttributesA(path);
     return (attrs != INVALID_FILE_ATTRIBUTES) && (attrs & FILE_ATTRIBUTE_DIRECTORY);
@@ -55,6 +89,14 @@ b8 platform_file_delete(const char *path) {
     return true;
 }
 
+b8 platform_file_rename(const char *source_path, const char *dest_path) {
+    if (!MoveFileExA(source_path, dest_path, MOVEFILE_REPLACE_EXISTING)) {
+        RL_ERROR("Failed to rename file '%s' -> '%s'. Error: %lu", source_path, dest_path, GetLastError());
+        return false;
+    }
+    return true;
+}
+
 b8 platform_file_open(const char *path, FILE_PERM perms, rl_file *out_file) {
     RL_ASSERT_MSG(!out_file->handle, "Trying to open a non-closed file");
     rl_temp_arena scratch = rl_arena_scratch_get();
@@ -110,33 +152,228 @@ void platform_file_close(rl_file *file) {
 
     file->handle = nullptr;
     if (file->buf) {
-        if (file->buf_len > 0) {
-            mem_free(file->buf, file->buf_len, MEM_FILE_BUFFERS);
-        }
+        mem_free(file->buf, file->buf_len, MEM_FILE_BUFFERS);
         file->buf = nullptr;
+        file->buf_len = 0;
     }
 }
 
 b8 platform_file_read_all(rl_file *file) {
     DWORD bytes_read = 0;
 
+    if (file->size == 0) {
+        return true;
+    }
     file->buf = mem_alloc(file->size, MEM_FILE_BUFFERS);
+    file->buf_len = file->size;
 
     BOOL success = ReadFile(file->handle, file->buf, file->size, &bytes_read, nullptr);
-    if (!success) {
-        RL_ERROR("Failed to read file='%s'. Error: %d", file->name, GetLastError());
+    if (!success || bytes_read != file->size) {
+        if (!success) {
+            RL_ERROR("Failed to read file='%s'. Error: %d", file->name, GetLastError());
+        } else {
+            RL_ERROR("Failed to read file='%s'. Expected %llu bytes, got %llu", file->name, file->size, bytes_read);
+        }
+        mem_free(file->buf, file->buf_len, MEM_FILE_BUFFERS);
+        file->buf = nullptr;
+        file->buf_len = 0;
+        return false;
+    }
+    return true;
+}
+
+b8 platform_file_create(const char *path, rl_file *out_file) {
+    RL_ASSERT_MSG(!out_file->handle, "Trying to create over a non-closed file");
+
+    HANDLE h = CreateFileA(
+        path,
+        GENERIC_WRITE,
+        FILE_SHARE_READ,
+        nullptr,
+        CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr);
+
+    if (h == INVALID_HANDLE_VALUE) {
+        RL_ERROR("Failed to create file='%s'. Error: %d", path, GetLastError());
+        return false;
+    }
+
+    const char *name = strrchr(path, '/');
+    const char *name_bs = strrchr(path, '\\');
+    if (name_bs > name) {
+        name = name_bs;
+    }
+
+    out_file->path = path;
+    out_file->name = name ? name + 1 : path;
+    out_file->handle = h;
+    out_file->size = 0;
+    out_file->buf = nullptr;
+    out_file->buf_len = 0;
+    return true;
+}
+
+b8 platform_file_write(rl_file *file, const void *data, u64 size) {
+    const u8 *src = data;
+    while (size > 0) {
+        DWORD chunk = (DWORD)RL_MIN(size, 0x40000000ull);
+        DWORD written = 0;
+        if (!WriteFile(file->handle, src, chunk, &written, nullptr) || written == 0) {
+            RL_ERROR("Failed to write file='%s'. Error: %d", file->name, GetLastError());
+            return false;
+        }
+        src += written;
+        size -= written;
+        file->size += written;
+    }
+    return true;
+}
+
+b8 platform_file_map_open(const char *path, rl_file_map *out_map) {
+    RL_ASSERT_MSG(out_map && !out_map->data, "Trying to map over a non-closed mapping");
+
+    HANDLE h = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (h == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(h, &size) || size.QuadPart == 0) {
+        CloseHandle(h);
         return false;
     }
 
-    if (bytes_read != file->size) {
-        RL_ERROR("Failed to read file='%s'. Expected %llu bytes, got %llu", file->name, file->size, bytes_read);
+    HANDLE mapping = CreateFileMappingA(h, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        RL_ERROR("Failed to create mapping for file='%s'. Error: %d", path, GetLastError());
+        CloseHandle(h);
         return false;
     }
 
-    file->buf_len = bytes_read;
+    void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        RL_ERROR("Failed to map file='%s'. Error: %d", path, GetLastError());
+        CloseHandle(mapping);
+        CloseHandle(h);
+        return false;
+    }
+
+    out_map->handle = h;
+    out_map->mapping = mapping;
+    out_map->data = data;
+    out_map->size = (u64)size.QuadPart;
     return true;
 }
 
+b8 platform_file_map_create(const char *path, u64 size, rl_file_map *out_map) {
+    RL_ASSERT_MSG(out_map && !out_map->data, "Trying to map over a non-closed mapping");
+
+    HANDLE h = CreateFileA(
+        path,
+        GENERIC_READ | GENERIC_WRITE,
+        FILE_SHARE_READ,
+        nullptr,
+        CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr);
+
+    if (h == INVALID_HANDLE_VALUE) {
+        RL_ERROR("Failed to create file='%s'. Error: %d", path, GetLastError());
+        return false;
+    }
+
+    // Mapping a size larger than the file grows it
+    HANDLE mapping = CreateFileMappingA(h, nullptr, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)size, nullptr);
+    if (!mapping) {
+        RL_ERROR("Failed to create mapping for file='%s'. Error: %d", path, GetLastError());
+        CloseHandle(h);
+        return false;
+    }
+
+    void *data = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size);
+    if (!data) {
+        RL_ERROR("Failed to map file='%s'. Error: %d", path, GetLastError());
+        CloseHandle(mapping);
+        CloseHandle(h);
+        return false;
+    }
+
+    out_map->handle = h;
+    out_map->mapping = mapping;
+    out_map->data = data;
+    out_map->size = size;
+    return true;
+}
+
+void platform_file_map_flush(rl_file_map *map, u64 offset, u64 size) {
+    if (!map->data || size == 0) {
+        return;
+    }
+    FlushViewOfFile(map->data + offset, size);
+}
+
+void platform_file_map_close(rl_file_map *map, u64 used) {
+    if (!map->data) {
+        return;
+    }
+
+    UnmapViewOfFile(map->data);
+    CloseHandle(map->mapping);
+
+    if (used < map->size) {
+        LARGE_INTEGER end;
+        end.QuadPart = (LONGLONG)used;
+        if (!SetFilePointerEx(map->handle, end, nullptr, FILE_BEGIN) || !SetEndOfFile(map->handle)) {
+            RL_ERROR("Failed to truncate mapped file. Error: %d", GetLastError());
+        }
+    }
+    CloseHandle(map->handle);
+
+    map->handle = nullptr;
+    map->mapping = nullptr;
+    map->data = nullptr;
+    map->size = 0;
+}
+
+void platform_file_map_advise(const rl_file_map *map, u64 offset, u64 size, FILE_ACCESS access) {
+    if (!map->data || offset >= map->size) {
+        return;
+    }
+
+    // Sequential / random only exist as open flags here, prefetching works on any mapped range (Windows 8+)
+#if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0602
+    if (access == FILE_ACCESS_WILLNEED) {
+        WIN32_MEMORY_RANGE_ENTRY range = {map->data + offset, (SIZE_T)RL_MIN(size, map->size - offset)};
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+#else
+    (void)size;
+    (void)access;
+#endif
+}
+
+b8 platform_file_watch_open(rl_file_watch *out_watch) {
+    (void)out_watch;
+    return false;
+}
+
+b8 platform_file_watch_add(rl_file_watch *watch, const char *dir) {
+    (void)watch;
+    (void)dir;
+    return false;
+}
+
+void platform_file_watch_poll(rl_file_watch *watch, rl_file_watch_fn callback, void *user_data) {
+    (void)watch;
+    (void)callback;
+    (void)user_data;
+}
+
+void platform_file_watch_close(rl_file_watch *watch) {
+    (void)watch;
+}
+
 // Private
 DWORD access_perms(const FILE_PERM *perms) {
     switch (*perms) {
@@ -4,6 +4,9 @@
 
 #include "core/logger.h"
 #include <stdio.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
 
 b8 platform_system_start() {
     RL_INFO("Initializing linux platform");
@@ -22,7 +25,21 @@ void platform_console_write(const char *message, LOG_LEVEL level) {
     printf("%s", message);
 }
 
-i64 platform_get_absolute_time() { return 0; }
+// Nanoseconds on CLOCK_MONOTONIC
+i64 platform_get_clock_counter() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (i64)ts.tv_sec * 1000000000ll + ts.tv_nsec;
+}
+
+void platform_sleep(u32 milliseconds) {
+    struct timespec ts = {milliseconds / 1000, (milliseconds % 1000) * 1000000l};
+    nanosleep(&ts, nullptr);
+}
+
+u64 platform_get_current_thread_id() {
+    return (u64)syscall(SYS_gettid);
+}
 
 b8 platform_pump_messages() {
     return true;
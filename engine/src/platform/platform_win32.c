@@ -1206,8 +1206,9 @@ static LRESULT CALLBACK DisplayWndProc(HWND Window, UINT Message, WPARAM WParam,
             }
         }
 
+        // Runs on the message thread, hand a copy to the main thread
         if (pw) {
-            event_fire(EVENT_WINDOW_FOCUS_GAINED, pw);
+            event_post(EVENT_WINDOW_FOCUS_GAINED, pw, sizeof(platform_window));
         }
     } break;
 
@@ -1220,8 +1221,9 @@ static LRESULT CALLBACK DisplayWndProc(HWND Window, UINT Message, WPARAM WParam,
             }
         }
 
+        // Runs on the message thread, hand a copy to the main thread
         if (pw) {
-            event_fire(EVENT_WINDOW_FOCUS_LOST, pw);
+            event_post(EVENT_WINDOW_FOCUS_LOST, pw, sizeof(platform_window));
         }
     } break;
 
@@ -1,6 +1,5 @@
 #include "platform/splash/splash.h"
 
-#include "asset/asset_table.h"
 #include "core/event.h"
 #include "core/logger.h"
 #include "memory/memory.h"
@@ -10,6 +9,7 @@ typedef struct splash_screen {
     u32 pixels_size;
     u8 *pixels;
     u32 progress_step;
+    u32 progress_total;
 } splash_screen;
 
 typedef struct rgba {
@@ -56,12 +56,13 @@ static void splash_fill_rect(u32 x, u32 y, u32 w, u32 h, rgba color) {
 // Splash lifecycle
 // -------------------------------
 
-b8 splash_show() {
+b8 splash_show(u32 total_steps) {
     if (!progress_registered) {
         event_register(EVENT_SPLASH_INCREMENT, on_progress_increment, nullptr);
         progress_registered = true;
     }
     state.progress_step = 0;
+    state.progress_total = total_steps ? total_steps : 1;
     state.pixels_size = SPLASH_WIDTH * SPLASH_HEIGHT * 4;
     state.pixels = mem_alloc(state.pixels_size, MEM_SUBSYSTEM_SPLASH);
 
@@ -103,7 +104,7 @@ void splash_update() {
     u32 inner_w = border_w - bar_inner_padding * 2;
 
     // Compute progress width safely
-    u32 progress_w = (inner_w * state.progress_step) / ASSET_TABLE_TOTAL;
+    u32 progress_w = (inner_w * RL_MIN(state.progress_step, state.progress_total)) / state.progress_total;
 
     // Fill progress
     splash_fill_rect(inner_x, inner_y, progress_w, bar_h, bar_fill_color);
@@ -117,14 +118,13 @@ void splash_hide() {
 }
 
 void splash_run(void *data) {
-    (void)data;
     RL_DEBUG("Splash window spawned on thread: %d", platform_get_current_thread_id());
-    if (!splash_show()) {
+    if (!splash_show(*(u32 *)data)) {
         RL_DEBUG("Failed to show splash window");
         return;
     }
 
-    while (state.progress_step < ASSET_TABLE_TOTAL) {
+    while (state.progress_step < state.progress_total) {
         splash_update();
     }
 
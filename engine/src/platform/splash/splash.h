@@ -6,7 +6,7 @@
 #define SPLASH_WIDTH 620
 #define SPLASH_HEIGHT 300
 
-b8 splash_show();
+b8 splash_show(u32 total_steps); // One step per EVENT_SPLASH_INCREMENT
 void splash_update();
 void splash_hide();
 
@@ -14,4 +14,4 @@ b8 platform_splash_create();
 b8 platform_splash_update(u8 *pixels);
 void platform_splash_destroy();
 
-void splash_run(void *data);
\ No newline at end of file
+void splash_run(void *data); // `data` is a u32 * with the step count
\ No newline at end of file
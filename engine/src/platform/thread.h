@@ -2,6 +2,8 @@
 
 #include "defines.h"
 
+#include <stdatomic.h>
+
 // Threading and synchronization primitives (Mutex, Semaphore, Event)
 
 typedef void (*rl_thread_entry)(void *);
@@ -18,25 +20,53 @@ typedef struct rl_thread_ctx {
     void *data;
 } rl_thread_ctx;
 
+// Linux backend keeps the futex words inline instead of behind an OS handle,
+// so primitives must not be moved or copied once created.
+
 // Used to signal "Events" between threads
 typedef struct rl_thread_sync {
-    void *handle;
+    union {
+        void *handle;
+        struct {
+            _Atomic u32 signaled;
+            _Atomic u32 waiters;
+        } futex;
+    };
 } rl_thread_sync;
 
 // For locking/unlocking data between threads
 typedef struct rl_mutex {
-    void *handle;
+    union {
+        void *handle;
+        _Atomic u32 futex; // 0 = unlocked, 1 = locked, 2 = locked with waiters
+    };
 } rl_mutex;
 
 //
 typedef struct rl_semaphore {
-    void *handle;
+    union {
+        void *handle;
+        struct {
+            _Atomic u32 count;
+            _Atomic u32 waiters;
+        } futex;
+    };
 } rl_semaphore;
 
+// Spin-wait hint for busy loops
+RL_INLINE void platform_cpu_relax() {
+#if defined(__x86_64__) || defined(_M_X64)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ volatile("yield");
+#endif
+}
+
 // Semaphore
 void platform_semaphore_create(rl_semaphore *, int initial);
 void platform_semaphore_wait(rl_semaphore *);
 void platform_semaphore_signal(rl_semaphore *);
+void platform_semaphore_destroy(rl_semaphore *);
 
 // Thread
 b8 platform_thread_create(rl_thread_entry entry, void *data, rl_thread *out_thread);
@@ -0,0 +1,177 @@
+#include "platform/thread.h"
+
+#ifdef PLATFORM_LINUX
+
+#include <errno.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "core/logger.h"
+#include "memory/memory.h"
+#include "platform.h"
+
+// Spin this many times before parking in the kernel
+#define FUTEX_SPIN_COUNT 128
+
+static void futex_wait(_Atomic u32 *addr, u32 expected) {
+    // Returns immediately with EAGAIN if *addr != expected, callers re-check in a loop
+    syscall(SYS_futex, (u32 *)addr, FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+}
+
+static void futex_wake(_Atomic u32 *addr, i32 count) {
+    syscall(SYS_futex, (u32 *)addr, FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+}
+
+static void *thread_proc_wrapper(void *data) {
+    RL_TRACE("Thread %llu created.", platform_get_current_thread_id());
+    rl_thread_ctx *ctx = data;
+    ctx->entry(ctx->data);
+    mem_free(ctx, sizeof(rl_thread_ctx), MEM_SUBSYSTEM_PLATFORM);
+    RL_TRACE("Thread %llu finished work.", platform_get_current_thread_id());
+    return nullptr;
+}
+
+b8 platform_thread_create(rl_thread_entry entry, void *data, rl_thread *out_thread) {
+    rl_thread_ctx *ctx = mem_alloc(sizeof(rl_thread_ctx), MEM_SUBSYSTEM_PLATFORM);
+    ctx->entry = entry;
+    ctx->data = data;
+
+    pthread_t thread;
+    if (pthread_create(&thread, nullptr, thread_proc_wrapper, ctx) != 0) {
+        RL_ERROR("platform_thread_create() failed: pthread_create error");
+        mem_free(ctx, sizeof(rl_thread_ctx), MEM_SUBSYSTEM_PLATFORM);
+        return false;
+    }
+
+    out_thread->handle = (void *)thread;
+    out_thread->entry = entry;
+    out_thread->data = data;
+    out_thread->id = 0;
+    return true;
+}
+
+void platform_thread_join(rl_thread *thread) {
+    if (!thread || !thread->handle) {
+        return;
+    }
+    pthread_join((pthread_t)thread->handle, nullptr);
+}
+
+// Auto-reset event: one signal releases one waiter
+void platform_thread_sync_create(rl_thread_sync *out_sync) {
+    atomic_store(&out_sync->futex.signaled, 0);
+    atomic_store(&out_sync->futex.waiters, 0);
+}
+
+void platform_thread_sync_wait(rl_thread_sync *sync) {
+    for (u32 spin = 0; spin < FUTEX_SPIN_COUNT; spin++) {
+        u32 expected = 1;
+        if (atomic_compare_exchange_weak(&sync->futex.signaled, &expected, 0)) {
+            return;
+        }
+        platform_cpu_relax();
+    }
+
+    atomic_fetch_add(&sync->futex.waiters, 1);
+    for (;;) {
+        u32 expected = 1;
+        if (atomic_compare_exchange_strong(&sync->futex.signaled, &expected, 0)) {
+            break;
+        }
+        futex_wait(&sync->futex.signaled, 0);
+    }
+    atomic_fetch_sub(&sync->futex.waiters, 1);
+}
+
+void platform_thread_sync_signal(rl_thread_sync *sync) {
+    atomic_store(&sync->futex.signaled, 1);
+    if (atomic_load(&sync->futex.waiters) > 0) {
+        futex_wake(&sync->futex.signaled, 1);
+    }
+}
+
+void platform_mutex_create(rl_mutex *out_mutex) {
+    atomic_store(&out_mutex->futex, 0);
+}
+
+void platform_mutex_lock(rl_mutex *mutex) {
+    u32 c = 0;
+    if (atomic_compare_exchange_strong(&mutex->futex, &c, 1)) {
+        return;
+    }
+
+    for (u32 spin = 0; spin < FUTEX_SPIN_COUNT; spin++) {
+        c = 0;
+        if (atomic_load_explicit(&mutex->futex, memory_order_relaxed) == 0 &&
+            atomic_compare_exchange_weak(&mutex->futex, &c, 1)) {
+            return;
+        }
+        platform_cpu_relax();
+    }
+
+    // Contended, mark as "locked with waiters" and park
+    c = atomic_exchange(&mutex->futex, 2);
+    while (c != 0) {
+        futex_wait(&mutex->futex, 2);
+        c = atomic_exchange(&mutex->futex, 2);
+    }
+}
+
+void platform_mutex_unlock(rl_mutex *mutex) {
+    // Only take the syscall when someone may be parked
+    if (atomic_fetch_sub(&mutex->futex, 1) != 1) {
+        atomic_store(&mutex->futex, 0);
+        futex_wake(&mutex->futex, 1);
+    }
+}
+
+void platform_mutex_destroy(rl_mutex *mutex) {
+    atomic_store(&mutex->futex, 0);
+}
+
+void platform_semaphore_create(rl_semaphore *out_semaphore, int initial) {
+    atomic_store(&out_semaphore->futex.count, (u32)initial);
+    atomic_store(&out_semaphore->futex.waiters, 0);
+}
+
+static b8 semaphore_try_take(rl_semaphore *semaphore) {
+    u32 count = atomic_load_explicit(&semaphore->futex.count, memory_order_relaxed);
+    while (count > 0) {
+        if (atomic_compare_exchange_weak(&semaphore->futex.count, &count, count - 1)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void platform_semaphore_wait(rl_semaphore *semaphore) {
+    for (u32 spin = 0; spin < FUTEX_SPIN_COUNT; spin++) {
+        if (semaphore_try_take(semaphore)) {
+            return;
+        }
+        platform_cpu_relax();
+    }
+
+    atomic_fetch_add(&semaphore->futex.waiters, 1);
+    while (!semaphore_try_take(semaphore)) {
+        futex_wait(&semaphore->futex.count, 0);
+    }
+    atomic_fetch_sub(&semaphore->futex.waiters, 1);
+}
+
+void platform_semaphore_signal(rl_semaphore *semaphore) {
+    atomic_fetch_add(&semaphore->futex.count, 1);
+    if (atomic_load(&semaphore->futex.waiters) > 0) {
+        futex_wake(&semaphore->futex.count, 1);
+    }
+}
+
+void platform_semaphore_destroy(rl_semaphore *semaphore) {
+    atomic_store(&semaphore->futex.count, 0);
+    atomic_store(&semaphore->futex.waiters, 0);
+}
+
+#endif // PLATFORM_LINUX
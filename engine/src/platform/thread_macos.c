@@ -139,4 +139,14 @@ void platform_semaphore_signal(rl_semaphore *semaphore) {
     sem_post(&sem->sem);
 }
 
+void platform_semaphore_destroy(rl_semaphore *semaphore) {
+    mac_semaphore *sem = semaphore ? semaphore->handle : nullptr;
+    if (!sem) {
+        return;
+    }
+    sem_destroy(&sem->sem);
+    mem_free(sem, sizeof(mac_semaphore), MEM_SUBSYSTEM_PLATFORM);
+    semaphore->handle = nullptr;
+}
+
 #endif // PLATFORM_MACOS
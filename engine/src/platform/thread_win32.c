@@ -92,4 +92,22 @@ void platform_mutex_destroy(rl_mutex *mutex) {
     mutex->handle = NULL;
 }
 
+void platform_semaphore_create(rl_semaphore *out_semaphore, int initial) {
+    out_semaphore->handle = CreateSemaphoreExA(nullptr, initial, LONG_MAX, nullptr, 0, SEMAPHORE_ALL_ACCESS);
+    RL_ASSERT_MSG(out_semaphore->handle, "Failed to create semaphore");
+}
+
+void platform_semaphore_wait(rl_semaphore *semaphore) {
+    WaitForSingleObject(semaphore->handle, INFINITE);
+}
+
+void platform_semaphore_signal(rl_semaphore *semaphore) {
+    ReleaseSemaphore(semaphore->handle, 1, nullptr);
+}
+
+void platform_semaphore_destroy(rl_semaphore *semaphore) {
+    CloseHandle(semaphore->handle);
+    semaphore->handle = NULL;
+}
+
 #endif
\ No newline at end of file
@@ -1,80 +1,84 @@
 #include "gl_mesh.h"
 
+#include "asset/asset.h"
+
+#include <stddef.h>
+#include <string.h>
+
 void gl_mesh_destroy(GL_Mesh *mesh) {
     glDeleteBuffers(1, &mesh->vbo);
+    glDeleteBuffers(1, &mesh->ebo);
     glDeleteVertexArrays(1, &mesh->vao);
     mesh = nullptr;
 }
 
 void gl_mesh_draw(GL_Mesh *mesh) {
+    gl_mesh_draw_lod(mesh, 0);
+}
+
+void gl_mesh_draw_lod(GL_Mesh *mesh, u32 lod) {
+    const rl_mesh_lod *range = &mesh->lods[RL_MIN(lod, mesh->lod_count - 1)];
     glBindVertexArray(mesh->vao);
-    glDrawArrays(GL_TRIANGLES, 0, mesh->vertex_count);
+    glDrawElements(GL_TRIANGLES, (i32)range->index_count, mesh->index_type,
+                   (void *)((u64)range->index_offset * mesh->index_size));
 }
 
-GL_Mesh gl_mesh_create_cube() {
-    f32 vertices[] = {
-        -0.5f, -0.5f, -0.5f, 0.0f, 0.0f, -1.0f,
-        0.5f, -0.5f, -0.5f, 0.0f, 0.0f, -1.0f,
-        0.5f, 0.5f, -0.5f, 0.0f, 0.0f, -1.0f,
-        0.5f, 0.5f, -0.5f, 0.0f, 0.0f, -1.0f,
-        -0.5f, 0.5f, -0.5f, 0.0f, 0.0f, -1.0f,
-        -0.5f, -0.5f, -0.5f, 0.0f, 0.0f, -1.0f,
-
-        -0.5f, -0.5f, 0.5f, 0.0f, 0.0f, 1.0f,
-        0.5f, -0.5f, 0.5f, 0.0f, 0.0f, 1.0f,
-        0.5f, 0.5f, 0.5f, 0.0f, 0.0f, 1.0f,
-        0.5f, 0.5f, 0.5f, 0.0f, 0.0f, 1.0f,
-        -0.5f, 0.5f, 0.5f, 0.0f, 0.0f, 1.0f,
-        -0.5f, -0.5f, 0.5f, 0.0f, 0.0f, 1.0f,
-
-        -0.5f, 0.5f, 0.5f, -1.0f, 0.0f, 0.0f,
-        -0.5f, 0.5f, -0.5f, -1.0f, 0.0f, 0.0f,
-        -0.5f, -0.5f, -0.5f, -1.0f, 0.0f, 0.0f,
-        -0.5f, -0.5f, -0.5f, -1.0f, 0.0f, 0.0f,
-        -0.5f, -0.5f, 0.5f, -1.0f, 0.0f, 0.0f,
-        -0.5f, 0.5f, 0.5f, -1.0f, 0.0f, 0.0f,
-
-        0.5f, 0.5f, 0.5f, 1.0f, 0.0f, 0.0f,
-        0.5f, 0.5f, -0.5f, 1.0f, 0.0f, 0.0f,
-        0.5f, -0.5f, -0.5f, 1.0f, 0.0f, 0.0f,
-        0.5f, -0.5f, -0.5f, 1.0f, 0.0f, 0.0f,
-        0.5f, -0.5f, 0.5f, 1.0f, 0.0f, 0.0f,
-        0.5f, 0.5f, 0.5f, 1.0f, 0.0f, 0.0f,
-
-        -0.5f, -0.5f, -0.5f, 0.0f, -1.0f, 0.0f,
-        0.5f, -0.5f, -0.5f, 0.0f, -1.0f, 0.0f,
-        0.5f, -0.5f, 0.5f, 0.0f, -1.0f, 0.0f,
-        0.5f, -0.5f, 0.5f, 0.0f, -1.0f, 0.0f,
-        -0.5f, -0.5f, 0.5f, 0.0f, -1.0f, 0.0f,
-        -0.5f, -0.5f, -0.5f, 0.0f, -1.0f, 0.0f,
-
-        -0.5f, 0.5f, -0.5f, 0.0f, 1.0f, 0.0f,
-        0.5f, 0.5f, -0.5f, 0.0f, 1.0f, 0.0f,
-        0.5f, 0.5f, 0.5f, 0.0f, 1.0f, 0.0f,
-        0.5f, 0.5f, 0.5f, 0.0f, 1.0f, 0.0f,
-        -0.5f, 0.5f, 0.5f, 0.0f, 1.0f, 0.0f,
-        -0.5f, 0.5f, -0.5f, 0.0f, 1.0f, 0.0f
-    };
+u32 gl_mesh_select_lod(const GL_Mesh *mesh, mat4 model, vec3 eye, f32 projection_scale, f32 threshold_px) {
+    return mesh_lod_select(mesh->lods, mesh->lod_count, mesh->bounds_min, mesh->bounds_max, model, eye,
+                           projection_scale, threshold_px);
+}
+
+b8 gl_mesh_create(const char *filename, GL_Mesh *out_mesh) {
+    return gl_mesh_upload(get_asset(filename), out_mesh);
+}
 
-    u32 vbo, vao;
+b8 gl_mesh_upload(const rl_asset *asset, GL_Mesh *out_mesh) {
+    const rl_mesh *mesh = asset->handle;
 
-    // Create vao & bind
+    u32 vao, buffers[2];
     glGenVertexArrays(1, &vao);
-    glGenBuffers(1, &vbo);
+    glGenBuffers(2, buffers);
     glBindVertexArray(vao);
 
-    // Create vbo & bind
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+    glBufferData(GL_ARRAY_BUFFER, mesh->vertex_count * sizeof(rl_mesh_vertex), mesh->vertices, GL_STATIC_DRAW);
+
+    // The element buffer binding is VAO state
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[1]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (u64)mesh->index_count * mesh_index_size(mesh->index_type), mesh->indices, GL_STATIC_DRAW);
 
     // Attributes
-    // position
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void *)0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(rl_mesh_vertex), (void *)offsetof(rl_mesh_vertex, position));
     glEnableVertexAttribArray(0);
-
-    // normal
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void *)(3 * sizeof(float)));
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(rl_mesh_vertex), (void *)offsetof(rl_mesh_vertex, normal));
     glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(rl_mesh_vertex), (void *)offsetof(rl_mesh_vertex, uv));
+    glEnableVertexAttribArray(2);
+
+    glBindVertexArray(0);
+
+    *out_mesh = (GL_Mesh){
+        .vao = vao,
+        .vbo = buffers[0],
+        .ebo = buffers[1],
+        .index_type = mesh->index_type == MESH_INDEX_U16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT,
+        .index_size = mesh_index_size(mesh->index_type),
+        .lod_count = RL_MIN(mesh->lod_count, (u32)MESH_MAX_LODS),
+        .name = asset->filename,
+    };
+    memcpy(out_mesh->lods, mesh->lods, out_mesh->lod_count * sizeof(rl_mesh_lod));
+    memcpy(out_mesh->bounds_min, mesh->bounds_min, sizeof(out_mesh->bounds_min));
+    memcpy(out_mesh->bounds_max, mesh->bounds_max, sizeof(out_mesh->bounds_max));
+    asset_set_gpu_size(asset_find(asset->filename), mesh->vertex_count * sizeof(rl_mesh_vertex) +
+                                                 (u64)mesh->index_count * mesh_index_size(mesh->index_type));
+    return true;
+}
 
-    return (GL_Mesh){.vao = vao, .vbo = vbo, .vertex_count = 36};
-}
\ No newline at end of file
+b8 gl_mesh_reload(GL_Mesh *mesh, const char *filename) {
+    if (strcmp(mesh->name, filename) != 0) {
+        return false;
+    }
+
+    gl_mesh_destroy(mesh);
+    return gl_mesh_create(filename, mesh);
+}
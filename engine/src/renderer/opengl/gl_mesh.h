@@ -1,15 +1,31 @@
 #pragma once
 
 #include "defines.h"
+#include "asset/asset.h"
+#include "asset/mesh.h"
 #include "glad.h"
 
 typedef struct GL_Mesh {
     u32 vao;
     u32 vbo;
-    u32 vertex_count;
+    u32 ebo;
+    u32 index_type; // GL_UNSIGNED_SHORT / GL_UNSIGNED_INT
+    u32 index_size;
+    u32 lod_count;
+    rl_mesh_lod lods[MESH_MAX_LODS]; // Ranges of the element buffer, kept for selection
+    f32 bounds_min[3];
+    f32 bounds_max[3];
+    const char *name;
 } GL_Mesh;
 
 void gl_mesh_destroy(GL_Mesh *mesh);
 void gl_mesh_draw(GL_Mesh *mesh);
+void gl_mesh_draw_lod(GL_Mesh *mesh, u32 lod);
 
-GL_Mesh gl_mesh_create_cube(void);
\ No newline at end of file
+// LOD for `model` seen from `eye`, `projection_scale` in pixels per unit at distance 1, see mesh_lod_select
+u32 gl_mesh_select_lod(const GL_Mesh *mesh, mat4 model, vec3 eye, f32 projection_scale, f32 threshold_px);
+
+// Uploads the cooked vertex / index buffers as they are
+b8 gl_mesh_create(const char *filename, GL_Mesh *out_mesh);
+b8 gl_mesh_upload(const rl_asset *asset, GL_Mesh *out_mesh); // Ready mesh asset, reports its GPU size
+b8 gl_mesh_reload(GL_Mesh *mesh, const char *filename);
@@ -10,14 +10,167 @@
 #include "renderer/opengl/gl_types.h"
 #include "core/camera.h"
 
+#include <string.h>
+
+#define GL_UPLOAD_BUDGET_US 2000 // Frame time spent uploading streamed assets, at least one per frame
+
 static GL_Context context;
 
 static f32 angle;
 
+static GL_StreamedAsset *find_streamed(rl_asset_handle handle) {
+    for (u64 i = 0; i < context.streamed.count; i++) {
+        GL_StreamedAsset *streamed = &context.streamed.items[i];
+        if (streamed->handle.index == handle.index && streamed->handle.generation == handle.generation) {
+            return streamed;
+        }
+    }
+    return nullptr;
+}
+
+static void destroy_streamed(GL_StreamedAsset *streamed) {
+    if (streamed->type == ASSET_TEXTURE) {
+        opengl_texture_destroy(&streamed->texture);
+    } else {
+        gl_mesh_destroy(&streamed->mesh);
+    }
+}
+
+static void upload_streamed(rl_asset_handle handle) {
+    rl_asset *asset = asset_get(handle);
+    if (!asset || find_streamed(handle)) {
+        return; // Evicted before its turn, or already uploaded
+    }
+
+    GL_StreamedAsset streamed = {.handle = handle, .type = asset->type};
+    b8 success = asset->type == ASSET_TEXTURE ? opengl_texture_upload(asset, &streamed.texture)
+                                              : gl_mesh_upload(asset, &streamed.mesh);
+    if (!success) {
+        RL_WARN("Failed to upload streamed asset '%s'", asset->filename);
+        return;
+    }
+    da_append(&context.streamed, streamed);
+}
+
+// Drains the upload queue until the frame budget is spent
+static void upload_pending() {
+    if (context.pending_uploads.count == 0) {
+        return;
+    }
+
+    i64 freq = platform_get_info()->clock_freq;
+    i64 budget = GL_UPLOAD_BUDGET_US * freq / 1000000;
+    i64 start = platform_get_clock_counter();
+
+    u64 done = 0;
+    while (done < context.pending_uploads.count) {
+        upload_streamed(context.pending_uploads.items[done++]);
+        if (platform_get_clock_counter() - start >= budget) {
+            break;
+        }
+    }
+
+    u64 left = context.pending_uploads.count - done;
+    memmove(context.pending_uploads.items, context.pending_uploads.items + done, left * sizeof(rl_asset_handle));
+    context.pending_uploads.count = left;
+}
+
+// Queues the GPU copy of a texture or mesh that finished loading after startup
+static b8 on_asset_loaded(void *event, void *data) {
+    (void)data;
+    rl_asset_handle handle = *(rl_asset_handle *)event;
+    rl_asset *asset = asset_get(handle);
+    if (asset && (asset->type == ASSET_TEXTURE || asset->type == ASSET_MESH)) {
+        da_append(&context.pending_uploads, handle);
+    }
+    return false;
+}
+
+// Releases the GPU copy of an evicted asset, it's queued again by on_asset_loaded when the asset comes back
+static b8 on_asset_evicted(void *event, void *data) {
+    (void)data;
+    rl_asset_handle handle = *(rl_asset_handle *)event;
+
+    for (u64 i = 0; i < context.pending_uploads.count;) {
+        rl_asset_handle pending = context.pending_uploads.items[i];
+        if (pending.index == handle.index && pending.generation == handle.generation) {
+            memmove(context.pending_uploads.items + i, context.pending_uploads.items + i + 1,
+                    (context.pending_uploads.count - i - 1) * sizeof(rl_asset_handle));
+            context.pending_uploads.count--;
+        } else {
+            i++;
+        }
+    }
+
+    GL_StreamedAsset *streamed = find_streamed(handle);
+    if (streamed) {
+        destroy_streamed(streamed);
+        *streamed = context.streamed.items[--context.streamed.count];
+        asset_set_gpu_size(handle, 0);
+    }
+    return false;
+}
+
+// Swaps in GPU resources for assets that changed on disk, runs at the frame boundary
+static b8 on_asset_reloaded(void *event, void *data) {
+    (void)data;
+    rl_asset *asset = asset_get(*(rl_asset_handle *)event);
+    if (!asset) {
+        return false;
+    }
+
+    switch (asset->type) {
+    case ASSET_SHADER:
+        opengl_shader_reload(&context.default_shader, asset->filename);
+        opengl_shader_reload(&context.light_shader, asset->filename);
+        opengl_shader_reload(&context.text_pipeline.shader, asset->filename);
+        break;
+    case ASSET_TEXTURE:
+        opengl_texture_reload(&context.wood_texture, asset->filename);
+        break;
+    case ASSET_FONT:
+        gl_font_reload(asset->handle, &context);
+        break;
+    case ASSET_MESH:
+        gl_mesh_reload(&context.cube_mesh, asset->filename);
+        break;
+    }
+
+    // Streamed copies are replaced like a fresh load
+    GL_StreamedAsset *streamed = find_streamed(*(rl_asset_handle *)event);
+    if (streamed) {
+        destroy_streamed(streamed);
+        *streamed = context.streamed.items[--context.streamed.count];
+        upload_streamed(*(rl_asset_handle *)event);
+    }
+    return false;
+}
+
 GL_Context *opengl_get_context(void) {
     return &context;
 }
 
+const GL_Texture *opengl_get_streamed_texture(rl_asset_handle handle) {
+    GL_StreamedAsset *streamed = find_streamed(handle);
+    return streamed && streamed->type == ASSET_TEXTURE ? &streamed->texture : nullptr;
+}
+
+const GL_Mesh *opengl_get_streamed_mesh(rl_asset_handle handle) {
+    GL_StreamedAsset *streamed = find_streamed(handle);
+    return streamed && streamed->type == ASSET_MESH ? &streamed->mesh : nullptr;
+}
+
+b8 opengl_has_extension(const char *name) {
+    i32 count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (i32 i = 0; i < count; i++) {
+        if (strcmp((const char *)glGetStringi(GL_EXTENSIONS, i), name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void opengl_resize_framebuffer(i32 w, i32 h) {
     glViewport(0, 0, w, h);
 }
@@ -28,10 +181,17 @@ void opengl_set_view_projection(mat4 view, mat4 projection, vec3 pos) {
     glm_vec3_copy(pos, context.pos);
 }
 
+void opengl_set_lod_threshold(f32 threshold_px) {
+    context.lod_threshold = threshold_px;
+}
+
 b8 opengl_initialize(platform_window *platform_window, b8 vsync) {
     context.window = platform_window;
+    context.lod_threshold = MESH_LOD_PIXEL_THRESHOLD;
 
     da_init(&context.fonts);
+    da_init(&context.streamed);
+    da_init(&context.pending_uploads);
     rl_arena_init(&context.arena, MiB(100), MiB(25), MEM_SUBSYSTEM_RENDERER);
 
     RL_INFO("Initializing Renderer: OpenGL");
@@ -64,12 +224,27 @@ b8 opengl_initialize(platform_window *platform_window, b8 vsync) {
 
     glEnable(GL_DEPTH_TEST);
 
-    context.cube_mesh = gl_mesh_create_cube();
+    if (!gl_mesh_create("cube.gltf", &context.cube_mesh)) {
+        RL_ERROR("gl_mesh_create() failed");
+        return false;
+    }
+
+    event_register(EVENT_ASSET_LOADED, on_asset_loaded, nullptr);
+    event_register(EVENT_ASSET_EVICTED, on_asset_evicted, nullptr);
+    event_register(EVENT_ASSET_RELOADED, on_asset_reloaded, nullptr);
 
     return true;
 }
 
 void opengl_destroy() {
+    event_unregister(EVENT_ASSET_LOADED, on_asset_loaded, nullptr);
+    event_unregister(EVENT_ASSET_EVICTED, on_asset_evicted, nullptr);
+    event_unregister(EVENT_ASSET_RELOADED, on_asset_reloaded, nullptr);
+    for (u64 i = 0; i < context.streamed.count; i++) {
+        destroy_streamed(&context.streamed.items[i]);
+    }
+    da_free(&context.streamed);
+    da_free(&context.pending_uploads);
     gl_mesh_destroy(&context.cube_mesh);
     rl_arena_deinit(&context.arena);
 }
@@ -77,6 +252,8 @@ void opengl_destroy() {
 void opengl_begin_frame(f64 delta_time) {
     (void)delta_time;
 
+    upload_pending();
+
     if (angle > 360)
         angle = 0.0f;
     angle += 100.0f * delta_time;
@@ -102,7 +279,8 @@ void opengl_begin_frame(f64 delta_time) {
 
     gl_mesh_draw(&context.cube_mesh);
 
-    // Draw floor
+    // Draw floor, LODs picked by projected error: projection[1][1] is 1 / tan(fov / 2)
+    f32 projection_scale = (f32)context.window->settings.height * 0.5f * context.projection[1][1];
     for (i32 x = -5; x <= 5; x++) {
         for (i32 z = -5; z <= 5; z++) {
             mat4 floor_model;
@@ -111,7 +289,8 @@ void opengl_begin_frame(f64 delta_time) {
             glm_translate(floor_model, (vec3){(f32)x, -2.0f, (f32)z});
             opengl_shader_set_mat4(&context.default_shader, "model", floor_model);
             glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-            gl_mesh_draw(&context.cube_mesh);
+            u32 lod = gl_mesh_select_lod(&context.cube_mesh, floor_model, context.pos, projection_scale, context.lod_threshold);
+            gl_mesh_draw_lod(&context.cube_mesh, lod);
             glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
         }
     }
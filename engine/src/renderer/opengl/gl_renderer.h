@@ -10,9 +10,16 @@ void opengl_begin_frame(f64 delta_time);
 void opengl_end_frame();
 void opengl_swap_buffers();
 void opengl_set_view_projection(mat4 view, mat4 projection, vec3 pos);
+void opengl_set_lod_threshold(f32 threshold_px);
 
 GL_Context *opengl_get_context(void);
 
+// GPU copies of textures / meshes loaded after startup, nullptr until their upload ran
+const GL_Texture *opengl_get_streamed_texture(rl_asset_handle handle);
+const GL_Mesh *opengl_get_streamed_mesh(rl_asset_handle handle);
+
+b8 opengl_has_extension(const char *name);
+
 platform_window *opengl_get_active_window();
 void opengl_set_active_window(platform_window *window);
 void opengl_resize_framebuffer(i32 w, i32 h);
\ No newline at end of file
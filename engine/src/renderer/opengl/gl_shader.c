@@ -3,17 +3,170 @@
 #include "gl_renderer.h"
 #include "asset/shader.h"
 #include "glad.h"
+#include "platform/io/file_io.h"
+#include "util/hash.h"
+#include "util/str.h"
+
+#include <stdio.h>
+#include <string.h>
 
 // Forward decl.
 b8 opengl_compile_vertex_shader(const char *source, i32 *out_id);
 b8 opengl_compile_fragment_shader(const char *source, i32 *out_id);
 b8 opengl_create_shader_program(i32 vertex_id, i32 fragment_id, i32 *out_prog_id);
 
-// TODO: Add cache of compiled shaders to reuse
+/* Program binary cache
+ *  Linked programs are stored in the cache dir as "<key>.glbin" when GL_ARB_get_program_binary is
+ *  available. The key hashes both sources and the vendor / renderer / version strings, the driver can
+ *  still reject a binary (e.g. after an update that kept the version string) and then we link from source.
+ */
+
+#define PROGRAM_CACHE_MAGIC 0x50474C52 // "RLGP"
+#define PROGRAM_CACHE_VERSION 1
+
+typedef struct program_cache_header {
+    u32 magic;
+    u32 version;
+    u64 key;
+    u32 binary_format;
+    u32 binary_size;
+    u64 binary_hash;
+} program_cache_header;
+
+typedef enum program_binary_support {
+    PROGRAM_BINARY_UNKNOWN,
+    PROGRAM_BINARY_AVAILABLE,
+    PROGRAM_BINARY_UNAVAILABLE,
+} program_binary_support;
+
+static program_binary_support binary_support;
+
+static b8 program_binary_available() {
+    if (binary_support == PROGRAM_BINARY_UNKNOWN) {
+        // Core since 4.1. GLAD only resolves the entry points for a 4.1+ context, so an ARB-only
+        // driver without them loaded just compiles from source.
+        b8 available = (GLAD_GL_VERSION_4_1 || opengl_has_extension("GL_ARB_get_program_binary")) &&
+                       glGetProgramBinary && glProgramBinary && glProgramParameteri;
+
+        i32 format_count = 0;
+        if (available) {
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+        }
+
+        binary_support = format_count > 0 ? PROGRAM_BINARY_AVAILABLE : PROGRAM_BINARY_UNAVAILABLE;
+        RL_DEBUG("OpenGL program binary cache %s", format_count > 0 ? "enabled" : "unavailable");
+    }
+    return binary_support == PROGRAM_BINARY_AVAILABLE;
+}
+
+static u64 hash_gl_string(GLenum name, u64 seed) {
+    const char *str = (const char *)glGetString(name);
+    return str ? hash_bytes(str, cstr_len(str), seed) : seed;
+}
+
+static u64 program_cache_key(const rl_asset_shader *vert, const rl_asset_shader *frag) {
+    u32 version = PROGRAM_CACHE_VERSION;
+    u64 key = hash_bytes(vert->source, cstr_len(vert->source), HASH_SEED);
+    key = hash_bytes(frag->source, cstr_len(frag->source), key);
+    key = hash_gl_string(GL_VENDOR, key);
+    key = hash_gl_string(GL_RENDERER, key);
+    key = hash_gl_string(GL_VERSION, key);
+    return hash_bytes(&version, sizeof(version), key);
+}
+
+static b8 program_cache_load(const char *cache_path, u64 key, i32 *out_prog_id) {
+    rl_file_map map = {0};
+    if (!platform_file_map_open(cache_path, &map)) {
+        return false;
+    }
+
+    const program_cache_header *header = (const program_cache_header *)map.data;
+    const u8 *binary = map.data + sizeof(program_cache_header);
+    b8 valid = map.size >= sizeof(program_cache_header) &&
+               header->magic == PROGRAM_CACHE_MAGIC &&
+               header->version == PROGRAM_CACHE_VERSION &&
+               header->key == key &&
+               sizeof(program_cache_header) + header->binary_size == map.size &&
+               hash_bytes(binary, header->binary_size, HASH_SEED) == header->binary_hash;
+
+    if (!valid) {
+        platform_file_map_close(&map, map.size);
+        return false;
+    }
+
+    i32 program_id = glCreateProgram();
+    glProgramBinary(program_id, header->binary_format, binary, (GLsizei)header->binary_size);
+    platform_file_map_close(&map, map.size);
+
+    i32 success;
+    glGetProgramiv(program_id, GL_LINK_STATUS, &success);
+    if (!success) {
+        glDeleteProgram(program_id);
+        return false;
+    }
+
+    *out_prog_id = program_id;
+    return true;
+}
+
+static void program_cache_write(const char *cache_path, u64 key, i32 program_id) {
+    i32 length = 0;
+    glGetProgramiv(program_id, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+
+    char tmp_path[272];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", cache_path);
+
+    u64 size = sizeof(program_cache_header) + (u64)length;
+    rl_file_map map = {0};
+    if (!platform_file_map_create(tmp_path, size, &map)) {
+        return;
+    }
+
+    u8 *binary = map.data + sizeof(program_cache_header);
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program_id, length, &written, &format, binary);
+
+    *(program_cache_header *)map.data = (program_cache_header){
+        .magic = PROGRAM_CACHE_MAGIC,
+        .version = PROGRAM_CACHE_VERSION,
+        .key = key,
+        .binary_format = format,
+        .binary_size = (u32)written,
+        .binary_hash = hash_bytes(binary, (u64)written, HASH_SEED),
+    };
+
+    platform_file_map_close(&map, size);
+    if (written == length) {
+        platform_file_rename(tmp_path, cache_path);
+    } else {
+        platform_file_delete(tmp_path);
+    }
+}
+
 b8 opengl_shader_setup(const char *vertex, const char *frag, GL_Shader *out_shader) {
     rl_asset_shader *default_vert = get_asset(vertex)->handle;
     rl_asset_shader *default_frag = get_asset(frag)->handle;
 
+    b8 use_cache = program_binary_available();
+    u64 key = 0;
+    char cache_path[256];
+
+    if (use_cache) {
+        key = program_cache_key(default_vert, default_frag);
+        snprintf(cache_path, sizeof(cache_path), "%s%016llx.glbin", get_cache_dir(), (unsigned long long)key);
+
+        i32 program_id;
+        if (program_cache_load(cache_path, key, &program_id)) {
+            RL_DEBUG("Shader program '%s' + '%s' loaded from binary cache", vertex, frag);
+            *out_shader = (GL_Shader){.program_id = program_id, .vertex_name = vertex, .fragment_name = frag};
+            return true;
+        }
+    }
+
     i32 vert_id, frag_id, program_id;
     if (!opengl_compile_vertex_shader(default_vert->source, &vert_id)) {
         return false;
@@ -27,10 +180,32 @@ b8 opengl_shader_setup(const char *vertex, const char *frag, GL_Shader *out_shad
         return false;
     }
 
+    if (use_cache) {
+        program_cache_write(cache_path, key, program_id);
+    }
+
     out_shader->fragment_id = frag_id;
     out_shader->vertex_id = vert_id;
     out_shader->program_id = program_id;
+    out_shader->vertex_name = vertex;
+    out_shader->fragment_name = frag;
+
+    return true;
+}
+
+b8 opengl_shader_reload(GL_Shader *shader, const char *filename) {
+    if (strcmp(shader->vertex_name, filename) != 0 && strcmp(shader->fragment_name, filename) != 0) {
+        return false;
+    }
+
+    GL_Shader reloaded;
+    if (!opengl_shader_setup(shader->vertex_name, shader->fragment_name, &reloaded)) {
+        RL_WARN("Failed to relink '%s' + '%s', keeping the previous program", shader->vertex_name, shader->fragment_name);
+        return false;
+    }
 
+    glDeleteProgram(shader->program_id);
+    *shader = reloaded;
     return true;
 }
 
@@ -75,6 +250,9 @@ b8 opengl_create_shader_program(i32 vertex_id, i32 fragment_id, i32 *out_prog_id
     i32 program_id = glCreateProgram();
     glAttachShader(program_id, vertex_id);
     glAttachShader(program_id, fragment_id);
+    if (binary_support == PROGRAM_BINARY_AVAILABLE) {
+        glProgramParameteri(program_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
     glLinkProgram(program_id);
 
     // Delete after linking to program
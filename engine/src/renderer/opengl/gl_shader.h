@@ -7,9 +7,13 @@ typedef struct GL_Shader {
     i32 program_id;
     i32 vertex_id;
     i32 fragment_id;
+    const char *vertex_name;
+    const char *fragment_name;
 } GL_Shader;
 
 b8 opengl_shader_setup(const char *vertex, const char *frag, GL_Shader *out_shader);
+// Relinks `shader` if it was built from `filename`, the old program stays in use if the new one fails
+b8 opengl_shader_reload(GL_Shader *shader, const char *filename);
 void opengl_shader_use(GL_Shader *shader);
 
 void opengl_shader_set_bool(GL_Shader *shader, const char *name, b8 value);
@@ -50,10 +50,10 @@ b8 opengl_text_pipeline_init(GL_Context *ctx) {
     glEnableVertexAttribArray(1);
 
     // Load all font assets to GPU :)
-    Assets *assets = get_assets();
-    for (u32 i = 0; i < assets->count; i++) {
-        rl_asset *asset = &assets->items[i];
-        if (asset->type == ASSET_FONT) {
+    u32 asset_count = get_asset_count();
+    for (u32 i = 0; i < asset_count; i++) {
+        rl_asset *asset = get_asset_at(i);
+        if (asset->type == ASSET_FONT && asset->handle) { // Fonts of groups that aren't loaded have none
             rl_font *font = (rl_font *)asset->handle;
             RL_DEBUG("loading gl font %s", font->name);
             if (!gl_font_create(font, ctx)) {
@@ -73,14 +73,9 @@ b8 opengl_text_pipeline_init(GL_Context *ctx) {
     return true;
 }
 
-b8 gl_font_create(rl_font *font, GL_Context *ctx) {
-    GL_Font *gl_font = rl_arena_push(&ctx->arena, sizeof(GL_Font), alignof(GL_Font));
-
-    if (gl_font == nullptr)
-        return false;
-
-    glGenTextures(1, &gl_font->texture_id);
-    glBindTexture(GL_TEXTURE_2D, gl_font->texture_id);
+static void upload_atlas(const rl_font *font, u32 *out_texture_id) {
+    glGenTextures(1, out_texture_id);
+    glBindTexture(GL_TEXTURE_2D, *out_texture_id);
 
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
@@ -95,13 +90,38 @@ b8 gl_font_create(rl_font *font, GL_Context *ctx) {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+b8 gl_font_create(rl_font *font, GL_Context *ctx) {
+    GL_Font *gl_font = rl_arena_push(&ctx->arena, sizeof(GL_Font), alignof(GL_Font));
 
+    if (gl_font == nullptr)
+        return false;
+
+    upload_atlas(font, &gl_font->texture_id);
     gl_font->font = font;
     da_append(&ctx->fonts, *gl_font);
 
     return true;
 }
 
+void gl_font_reload(rl_font *font, GL_Context *ctx) {
+    for (u32 i = 0; i < ctx->fonts.count; i++) {
+        GL_Font *gl_font = &ctx->fonts.items[i];
+        if (strcmp(gl_font->font->name, font->name) != 0) {
+            continue;
+        }
+
+        glDeleteTextures(1, &gl_font->texture_id);
+        upload_atlas(font, &gl_font->texture_id);
+        if (ctx->active_font == gl_font->font) {
+            ctx->active_font = font;
+        }
+        gl_font->font = font;
+        return;
+    }
+}
+
 void opengl_render_text(const char *text, f32 size_px, f32 x, f32 y, vec4 color) {
     GL_Context *ctx = opengl_get_context();
     GL_Font *gl_font = find_gl_font(ctx, ctx->active_font);
@@ -6,6 +6,8 @@
 
 b8 opengl_text_pipeline_init(GL_Context *ctx);
 b8 gl_font_create(rl_font *font, GL_Context *ctx);
+// Swaps the atlas of the GL font created from a previous version of `font`
+void gl_font_reload(rl_font *font, GL_Context *ctx);
 
 void opengl_set_active_font(rl_font *font);
 void opengl_render_text(const char *text, f32 size_px, f32 x, f32 y, vec4 color);
\ No newline at end of file
@@ -2,10 +2,40 @@
 
 #include "asset/asset.h"
 #include "asset/texture.h"
+#include "asset/texture_compress.h"
+#include "gl_renderer.h"
 #include "glad.h"
+#include "memory/memory.h"
+
+#include <string.h>
+
+// GL_EXT_texture_compression_s3tc, never promoted to core so GLAD doesn't carry it
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+
+// Linear like the uncompressed GL_RGB path
+static u32 compressed_internal_format(TEXTURE_FORMAT format) {
+    switch (format) {
+    case TEXTURE_FORMAT_RGBA8:
+        return 0;
+    case TEXTURE_FORMAT_BC1:
+        return opengl_has_extension("GL_EXT_texture_compression_s3tc") ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT : 0;
+    case TEXTURE_FORMAT_BC3:
+        return opengl_has_extension("GL_EXT_texture_compression_s3tc") ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : 0;
+    case TEXTURE_FORMAT_BC5:
+        return GL_COMPRESSED_RG_RGTC2; // Core since 3.0
+    case TEXTURE_FORMAT_BC7:
+        return (GLAD_GL_VERSION_4_2 || opengl_has_extension("GL_ARB_texture_compression_bptc")) ? GL_COMPRESSED_RGBA_BPTC_UNORM : 0;
+    }
+    return 0;
+}
 
 b8 opengl_texture_generate(const char *filename, GL_Texture *out_texture) {
-    rl_asset *asset = get_asset(filename);
+    return opengl_texture_upload(get_asset(filename), out_texture);
+}
+
+b8 opengl_texture_upload(const rl_asset *asset, GL_Texture *out_texture) {
+    const char *filename = asset->filename;
     rl_texture *texture = asset->handle;
 
     u32 texture_id;
@@ -19,14 +49,67 @@ b8 opengl_texture_generate(const char *filename, GL_Texture *out_texture) {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, texture->width, texture->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, texture->data);
-    glGenerateMipmap(GL_TEXTURE_2D);
+    // Everything but cooked chains ends up as full RGBA8 mips on the driver side
+    u64 gpu_size = texture_level_offset(TEXTURE_FORMAT_RGBA8, texture->width, texture->height,
+                                        texture_format_is_compressed(texture->format) ? texture->mip_count : texture_mip_count_full(texture->width, texture->height));
+
+    u32 internal_format = compressed_internal_format(texture->format);
+    if (internal_format != 0) {
+        gpu_size = texture_level_offset(texture->format, texture->width, texture->height, texture->mip_count);
+        // Cooked chain, every level uploads as stored
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (i32)texture->mip_count - 1);
+        for (u32 level = 0; level < texture->mip_count; level++) {
+            glCompressedTexImage2D(GL_TEXTURE_2D, (i32)level, internal_format,
+                                   texture_level_extent(texture->width, level),
+                                   texture_level_extent(texture->height, level), 0,
+                                   (i32)texture_level_size(texture->format, texture->width, texture->height, level),
+                                   texture->data + texture_level_offset(texture->format, texture->width, texture->height, level));
+        }
+    } else if (texture_format_is_compressed(texture->format)) {
+        RL_WARN("Texture '%s': compressed format not supported by the driver, decompressing", filename);
+
+        u64 size = texture_level_offset(TEXTURE_FORMAT_RGBA8, texture->width, texture->height, texture->mip_count);
+        u8 *pixels = mem_alloc(size, MEM_SUBSYSTEM_RENDERER);
+        if (!texture_decompress(texture, pixels)) {
+            mem_free(pixels, size, MEM_SUBSYSTEM_RENDERER);
+            glDeleteTextures(1, &texture_id);
+            return false;
+        }
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (i32)texture->mip_count - 1);
+        for (u32 level = 0; level < texture->mip_count; level++) {
+            glTexImage2D(GL_TEXTURE_2D, (i32)level, GL_RGB,
+                         texture_level_extent(texture->width, level),
+                         texture_level_extent(texture->height, level), 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                         pixels + texture_level_offset(TEXTURE_FORMAT_RGBA8, texture->width, texture->height, level));
+        }
+        mem_free(pixels, size, MEM_SUBSYSTEM_RENDERER);
+    } else {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, texture->width, texture->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, texture->data);
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
 
     out_texture->id = texture_id;
+    out_texture->name = filename;
+    asset_set_gpu_size(asset_find(filename), gpu_size);
 
     // NOTE: Potentially free the asset, since its already generated a gl texture
     // But we might want to keep the texture asset loaded in case we want to generate the texture again ?
     // However, currently asset system uses arena allocator, so i can't free specific assets :/
 
     return true;
+}
+
+void opengl_texture_destroy(GL_Texture *texture) {
+    glDeleteTextures(1, &texture->id);
+    texture->id = 0;
+}
+
+b8 opengl_texture_reload(GL_Texture *texture, const char *filename) {
+    if (strcmp(texture->name, filename) != 0) {
+        return false;
+    }
+
+    glDeleteTextures(1, &texture->id);
+    return opengl_texture_generate(filename, texture);
 }
\ No newline at end of file
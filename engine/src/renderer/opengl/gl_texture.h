@@ -1,9 +1,16 @@
 #pragma once
 
 #include "defines.h"
+#include "asset/asset.h"
 
 typedef struct GL_Texture {
     u32 id;
+    const char *name;
 } GL_Texture;
 
-b8 opengl_texture_generate(const char *filename, GL_Texture *out_texture);
\ No newline at end of file
+b8 opengl_texture_generate(const char *filename, GL_Texture *out_texture);
+// Uploads a ready texture asset and reports its GPU size
+b8 opengl_texture_upload(const rl_asset *asset, GL_Texture *out_texture);
+void opengl_texture_destroy(GL_Texture *texture);
+// Re-uploads `texture` if it was generated from `filename`
+b8 opengl_texture_reload(GL_Texture *texture, const char *filename);
\ No newline at end of file
@@ -17,6 +17,19 @@ typedef struct {
 
 DA_DEFINE(GL_Fonts, GL_Font);
 
+// GPU copy of a texture or mesh loaded after startup (asset_load_async), keyed by its asset handle
+typedef struct GL_StreamedAsset {
+    rl_asset_handle handle;
+    ASSET_TYPE type;
+    union {
+        GL_Texture texture;
+        GL_Mesh mesh;
+    };
+} GL_StreamedAsset;
+
+DA_DEFINE(GL_StreamedAssets, GL_StreamedAsset);
+DA_DEFINE(GL_AssetHandles, rl_asset_handle);
+
 typedef struct GL_TextPipeline {
     u32 vao;
     u32 vbo;
@@ -43,8 +56,13 @@ typedef struct GL_Context {
     GL_Texture wood_texture;
     GL_Mesh cube_mesh;
 
+    // Streaming, uploads are spread over frames
+    GL_StreamedAssets streamed;
+    GL_AssetHandles pending_uploads;
+
     // Mat
     mat4 view;
     mat4 projection;
     vec3 pos;
+    f32 lod_threshold; // Pixels, see renderer_set_lod_threshold
 } GL_Context;
\ No newline at end of file
@@ -69,6 +69,12 @@ void renderer_set_view_projection(mat4 view, mat4 projection, vec3 pos) {
     interface.set_view_projection(view, projection, pos);
 }
 
+void renderer_set_lod_threshold(f32 threshold_px) {
+    if (!state.initialized)
+        return;
+    interface.set_lod_threshold(threshold_px);
+}
+
 platform_window *renderer_get_active_window() {
     if (!state.initialized)
         return nullptr;
@@ -98,6 +104,7 @@ void prepare_interface(RENDERER_BACKEND backend) {
         interface.render_text = &opengl_render_text;
         interface.set_active_font = &opengl_set_active_font;
         interface.set_view_projection = &opengl_set_view_projection;
+        interface.set_lod_threshold = &opengl_set_lod_threshold;
         interface.get_active_window = &opengl_get_active_window;
         interface.set_active_window = &opengl_set_active_window;
         interface.resize_framebuffer = &opengl_resize_framebuffer;
@@ -111,6 +118,7 @@ void prepare_interface(RENDERER_BACKEND backend) {
         interface.render_text = &vulkan_render_text;         //&vulkan_render_text;
         interface.set_active_font = &vulkan_set_active_font; //&vulkan_set_active_font;
         interface.set_view_projection = &vulkan_set_view_projection;
+        interface.set_lod_threshold = &vulkan_set_lod_threshold;
         interface.get_active_window = &vulkan_get_active_window;
         interface.set_active_window = &vulkan_set_active_window;
         interface.resize_framebuffer = &vulkan_resize_framebuffer;
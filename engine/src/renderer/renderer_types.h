@@ -47,6 +47,7 @@ typedef struct renderer_interface {
     void (*render_text)(const char *text, f32 size_px, f32 x, f32 y, vec4 color);
     void (*set_active_font)(rl_font *font);
     void (*set_view_projection)(mat4 view, mat4 projection, vec3 pos);
+    void (*set_lod_threshold)(f32 threshold_px);
 
     platform_window *(*get_active_window)();
     void (*set_active_window)(platform_window *window);
@@ -270,27 +270,28 @@ void vk_buffers_destroy_uniform(VK_Context *context) {
 
 // ----------------------------
 
-void vk_buffer_copy_to_image(VK_Context *ctx, VkBuffer buffer, VkImage image, u32 w, u32 h) {
-    VkCommandBuffer cmd_buf = vk_buffer_begin_single_use(ctx, ctx->graphics_pool);
-
-    VkBufferImageCopy region = {0};
-    region.bufferOffset = 0;
-    region.bufferRowLength = 0;
-    region.bufferImageHeight = 0;
-
-    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.mipLevel = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    region.imageSubresource.layerCount = 1;
-
-    region.imageOffset = (VkOffset3D){0, 0, 0};
-    region.imageExtent = (VkExtent3D){
-        w,
-        h,
-        1
-    };
-
-    vkCmdCopyBufferToImage(cmd_buf, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+void vk_buffer_copy_to_image(VkCommandBuffer cmd_buf, VkBuffer buffer, VkImage image, u32 w, u32 h, u32 mip_levels, const VkDeviceSize *level_offsets) {
+    VkBufferImageCopy regions[VK_TEXTURE_MAX_MIP_LEVELS] = {0};
+    mip_levels = RL_MIN(mip_levels, VK_TEXTURE_MAX_MIP_LEVELS);
+    for (u32 level = 0; level < mip_levels; level++) {
+        VkBufferImageCopy *region = &regions[level];
+        region->bufferOffset = level_offsets[level];
+        region->bufferRowLength = 0;
+        region->bufferImageHeight = 0;
+
+        region->imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region->imageSubresource.mipLevel = level;
+        region->imageSubresource.baseArrayLayer = 0;
+        region->imageSubresource.layerCount = 1;
+
+        // Block compressed levels below 4x4 still copy their real extent
+        region->imageOffset = (VkOffset3D){0, 0, 0};
+        region->imageExtent = (VkExtent3D){
+            RL_MAX(w >> level, 1u),
+            RL_MAX(h >> level, 1u),
+            1
+        };
+    }
 
-    vk_buffer_end_single_use(ctx, ctx->graphics_pool, cmd_buf, ctx->graphics_queue);
+    vkCmdCopyBufferToImage(cmd_buf, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mip_levels, regions);
 }
\ No newline at end of file
@@ -21,7 +21,8 @@ VkCommandBuffer vk_buffer_begin_single_use(VK_Context *ctx, VkCommandPool cmd_po
 // Submit single use command buffer to passed queue
 void vk_buffer_end_single_use(VK_Context *ctx, VkCommandPool cmd_pool, VkCommandBuffer cmd_buffer, VkQueue q);
 
-void vk_buffer_copy_to_image(VK_Context *ctx, VkBuffer buffer, VkImage image, u32 w, u32 h);
+// Recorded into `cmd_buf`, one region per mip level, `level_offsets` into the buffer, level extents halve from w x h
+void vk_buffer_copy_to_image(VkCommandBuffer cmd_buf, VkBuffer buffer, VkImage image, u32 w, u32 h, u32 mip_levels, const VkDeviceSize *level_offsets);
 
 b8 vk_buffer_create_vertex(VK_Context *context, Vertices *vertices);
 void vk_buffer_destroy_vertex(VK_Context *context);
@@ -1,5 +1,6 @@
 #include "vk_device.h"
 
+#include "vk_pipeline_cache.h"
 #include "vk_swapchain.h"
 
 #include <string.h>
@@ -450,6 +451,9 @@ b8 vk_device_init(VK_Context *context) {
         .features = best.feats.features
     };
 
+    // Not fatal, pipelines just build without a cache
+    vk_pipeline_cache_create(context);
+
     RL_INFO("Successfully created vulkan device");
 
     ARENA_SCRATCH_RELEASE();
@@ -457,6 +461,6 @@ b8 vk_device_init(VK_Context *context) {
 }
 
 void vk_device_destroy(VK_Context *context) {
-    (void)context;
+    vk_pipeline_cache_destroy(context);
     vkDestroyDevice(context->device, nullptr);
 }
\ No newline at end of file
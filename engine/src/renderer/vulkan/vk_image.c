@@ -2,7 +2,7 @@
 
 #include "vk_buffer.h"
 
-b8 vk_image_create(VK_Context *ctx, u32 w, u32 h, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags mem_props, VkImage *out_img, VkDeviceMemory *out_mem) {
+b8 vk_image_create(VK_Context *ctx, u32 w, u32 h, u32 mip_levels, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags mem_props, VkImage *out_img, VkDeviceMemory *out_mem) {
     VkImageCreateInfo image_create_info = {
         .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
         .imageType = VK_IMAGE_TYPE_2D,
@@ -12,7 +12,7 @@ b8 vk_image_create(VK_Context *ctx, u32 w, u32 h, VkFormat format, VkImageTiling
             .height = h,
             .depth = 1
         },
-        .mipLevels = 1,
+        .mipLevels = mip_levels,
         .arrayLayers = 1,
         .samples = VK_SAMPLE_COUNT_1_BIT,
         .tiling = tiling,
@@ -41,7 +41,7 @@ b8 vk_image_create(VK_Context *ctx, u32 w, u32 h, VkFormat format, VkImageTiling
     return true;
 }
 
-b8 vk_image_view_create(VK_Context *ctx, VkImage img, VkFormat format, VkImageView *out_view) {
+b8 vk_image_view_create(VK_Context *ctx, VkImage img, VkFormat format, u32 mip_levels, VkImageView *out_view) {
     VkImageViewCreateInfo view_info = {0};
     view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
     view_info.image = img;
@@ -49,7 +49,7 @@ b8 vk_image_view_create(VK_Context *ctx, VkImage img, VkFormat format, VkImageVi
     view_info.format = format;
     view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     view_info.subresourceRange.baseMipLevel = 0;
-    view_info.subresourceRange.levelCount = 1;
+    view_info.subresourceRange.levelCount = mip_levels;
     view_info.subresourceRange.baseArrayLayer = 0;
     view_info.subresourceRange.layerCount = 1;
 
@@ -62,9 +62,8 @@ void vk_image_view_destroy(VK_Context *ctx, VkImageView view) {
     vkDestroyImageView(ctx->device, view, nullptr);
 }
 
-void vk_image_transition_layout(VK_Context *ctx, VkImage image, VkFormat format, VkImageLayout old_layout, VkImageLayout new_layout) {
-    VkCommandBuffer cmd_buf = vk_buffer_begin_single_use(ctx, ctx->graphics_pool);
-
+// Records a transition of levels [base_level, base_level + level_count)
+void vk_image_transition_layout(VkCommandBuffer cmd_buf, VkImage image, u32 base_level, u32 level_count, VkImageLayout old_layout, VkImageLayout new_layout) {
     VkImageMemoryBarrier barrier = {0};
     barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
     barrier.oldLayout = old_layout;
@@ -73,8 +72,8 @@ void vk_image_transition_layout(VK_Context *ctx, VkImage image, VkFormat format,
     barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     barrier.image = image;
     barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.baseMipLevel = base_level;
+    barrier.subresourceRange.levelCount = level_count;
     barrier.subresourceRange.baseArrayLayer = 0;
     barrier.subresourceRange.layerCount = 1;
 
@@ -91,6 +90,18 @@ void vk_image_transition_layout(VK_Context *ctx, VkImage image, VkFormat format,
         barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
         barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
+        src_stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        dst_stage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    } else if (old_layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && new_layout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL) {
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+        src_stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        dst_stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    } else if (old_layout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL && new_layout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
         src_stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
         dst_stage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
     } else {
@@ -104,6 +115,43 @@ void vk_image_transition_layout(VK_Context *ctx, VkImage image, VkFormat format,
         0, nullptr,
         0, nullptr,
         1, &barrier);
+}
 
-    vk_buffer_end_single_use(ctx, ctx->graphics_pool, cmd_buf, ctx->graphics_queue);
-}
\ No newline at end of file
+b8 vk_image_supports_linear_blit(VK_Context *ctx, VkFormat format) {
+    VkFormatProperties props;
+    vkGetPhysicalDeviceFormatProperties(ctx->physical_device, format, &props);
+    VkFormatFeatureFlags needed = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT |
+                                  VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+    return (props.optimalTilingFeatures & needed) == needed;
+}
+
+void vk_image_generate_mips(VkCommandBuffer cmd_buf, VkImage image, u32 w, u32 h, u32 mip_levels) {
+    i32 src_w = (i32)w;
+    i32 src_h = (i32)h;
+
+    // Each level is blitted from the one above it, which is then done and handed to the shaders
+    for (u32 level = 1; level < mip_levels; level++) {
+        i32 dst_w = RL_MAX(src_w / 2, 1);
+        i32 dst_h = RL_MAX(src_h / 2, 1);
+
+        vk_image_transition_layout(cmd_buf, image, level - 1, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+
+        VkImageBlit blit = {
+            .srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - 1, 0, 1},
+            .srcOffsets = {{0, 0, 0}, {src_w, src_h, 1}},
+            .dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1},
+            .dstOffsets = {{0, 0, 0}, {dst_w, dst_h, 1}},
+        };
+        vkCmdBlitImage(cmd_buf,
+                       image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                       image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                       1, &blit, VK_FILTER_LINEAR);
+
+        vk_image_transition_layout(cmd_buf, image, level - 1, 1, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+        src_w = dst_w;
+        src_h = dst_h;
+    }
+
+    vk_image_transition_layout(cmd_buf, image, mip_levels - 1, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+}
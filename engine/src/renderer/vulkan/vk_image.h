@@ -3,9 +3,15 @@
 #include "defines.h"
 #include "vk_types.h"
 
-b8 vk_image_create(VK_Context *ctx, u32 w, u32 h, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags mem_props, VkImage *out_img, VkDeviceMemory *out_mem);
+b8 vk_image_create(VK_Context *ctx, u32 w, u32 h, u32 mip_levels, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags mem_props, VkImage *out_img, VkDeviceMemory *out_mem);
 
-b8 vk_image_view_create(VK_Context *ctx, VkImage img, VkFormat format, VkImageView *out_view);
+b8 vk_image_view_create(VK_Context *ctx, VkImage img, VkFormat format, u32 mip_levels, VkImageView *out_view);
 void vk_image_view_destroy(VK_Context *ctx, VkImageView view);
 
-void vk_image_transition_layout(VK_Context *ctx, VkImage image, VkFormat format, VkImageLayout old_layout, VkImageLayout new_layout);
\ No newline at end of file
+// Recorded into `cmd_buf`, covers levels [base_level, base_level + level_count)
+void vk_image_transition_layout(VkCommandBuffer cmd_buf, VkImage image, u32 base_level, u32 level_count, VkImageLayout old_layout, VkImageLayout new_layout);
+
+// True if `format` can be downsampled with linear vkCmdBlitImage
+b8 vk_image_supports_linear_blit(VK_Context *ctx, VkFormat format);
+// Fills levels 1.. by blitting down from level 0 (all levels in TRANSFER_DST), leaves the chain SHADER_READ_ONLY
+void vk_image_generate_mips(VkCommandBuffer cmd_buf, VkImage image, u32 w, u32 h, u32 mip_levels);
\ No newline at end of file
@@ -2,16 +2,22 @@
 
 #include "vk_shader.h"
 
+#include "profiler/profiler.h"
+
+#include <string.h>
+
+static const char *pipeline_shaders[] = {"vulkan_triangle.vert", "vulkan_triangle.frag"};
+
 b8 create_shader_stages(VK_Context *context);
 VkVertexInputBindingDescription vk_vertex_get_binding_desc();
 void vk_vertex_get_attr_desc(VkVertexInputAttributeDescription *out_attrs);
 
 b8 vk_pipeline_create(VK_Context *context) {
-    if (!vk_shader_module_compile(context, "vulkan_triangle.vert")) {
-        return false;
-    }
+    RL_PROFILE_ZONE(pipeline_zone, "vk_pipeline_create");
 
-    if (!vk_shader_module_compile(context, "vulkan_triangle.frag")) {
+    if (!vk_shader_modules_compile(context, pipeline_shaders, sizeof(pipeline_shaders) / sizeof(pipeline_shaders[0]))) {
+        vk_shader_modules_destroy(context); // Whatever compiled before the failure
+        RL_PROFILE_ZONE_END(pipeline_zone);
         return false;
     }
 
@@ -121,6 +127,7 @@ b8 vk_pipeline_create(VK_Context *context) {
     if (vkCreatePipelineLayout(context->device, &pipeline_layout_create_info, nullptr, &context->graphics_pipeline.layout) != VK_SUCCESS) {
         RL_ERROR("Failed to create pipeline layout");
         vk_shader_modules_destroy(context);
+        RL_PROFILE_ZONE_END(pipeline_zone);
         return false;
     }
 
@@ -144,17 +151,31 @@ b8 vk_pipeline_create(VK_Context *context) {
         .basePipelineIndex = -1 // Optional
     };
 
-    if (VK_SUCCESS != vkCreateGraphicsPipelines(context->device, VK_NULL_HANDLE, 1, &pipeline_create_info, nullptr, &context->graphics_pipeline.handle)) {
+    RL_PROFILE_ZONE(create_zone, "vkCreateGraphicsPipelines");
+    VkResult res = vkCreateGraphicsPipelines(context->device, context->pipeline_cache, 1, &pipeline_create_info, nullptr, &context->graphics_pipeline.handle);
+    RL_PROFILE_ZONE_END(create_zone);
+
+    vk_shader_modules_destroy(context);
+    RL_PROFILE_ZONE_END(pipeline_zone);
+
+    if (res != VK_SUCCESS) {
         RL_ERROR("Failed to create graphics pipeline");
-        vk_shader_modules_destroy(context);
         return false;
     }
 
     RL_TRACE("Successfully created pipeline");
-    vk_shader_modules_destroy(context);
     return true;
 }
 
+b8 vk_pipeline_uses_shader(const char *filename) {
+    for (u32 i = 0; i < sizeof(pipeline_shaders) / sizeof(pipeline_shaders[0]); i++) {
+        if (strcmp(pipeline_shaders[i], filename) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void vk_pipeline_destroy(VK_Context *context) {
     vkDestroyPipeline(context->device, context->graphics_pipeline.handle, nullptr);
     vkDestroyPipelineLayout(context->device, context->graphics_pipeline.layout, nullptr);
@@ -4,4 +4,5 @@
 #include "vk_types.h"
 
 b8 vk_pipeline_create(VK_Context *context);
+b8 vk_pipeline_uses_shader(const char *filename);
 void vk_pipeline_destroy(VK_Context *context);
\ No newline at end of file
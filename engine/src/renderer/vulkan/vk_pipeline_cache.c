@@ -0,0 +1,149 @@
+#include "vk_pipeline_cache.h"
+
+#include "platform/io/file_io.h"
+#include "profiler/profiler.h"
+#include "util/hash.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define PIPELINE_CACHE_MAGIC 0x43505652 // "RVPC"
+#define PIPELINE_CACHE_VERSION 1
+#define PIPELINE_CACHE_FILE "pipeline_cache.bin"
+
+// Prepended to the driver's blob. The driver's own header doesn't carry the driver version.
+typedef struct pipeline_cache_header {
+    u32 magic;
+    u32 version;
+    u32 vendor_id;
+    u32 device_id;
+    u32 driver_version;
+    u32 reserved;
+    u8 uuid[VK_UUID_SIZE];
+    u64 data_size;
+    u64 data_hash;
+} pipeline_cache_header;
+
+static void cache_path(char *out, u64 size) {
+    snprintf(out, size, "%s%s", get_cache_dir(), PIPELINE_CACHE_FILE);
+}
+
+static b8 header_matches(const VkPhysicalDeviceProperties *props, const u8 *data, u64 size) {
+    const pipeline_cache_header *header = (const pipeline_cache_header *)data;
+    if (size < sizeof(pipeline_cache_header) ||
+        header->magic != PIPELINE_CACHE_MAGIC ||
+        header->version != PIPELINE_CACHE_VERSION ||
+        header->vendor_id != props->vendorID ||
+        header->device_id != props->deviceID ||
+        header->driver_version != props->driverVersion ||
+        memcmp(header->uuid, props->pipelineCacheUUID, VK_UUID_SIZE) != 0 ||
+        sizeof(pipeline_cache_header) + header->data_size != size) {
+        return false;
+    }
+
+    // The driver validates its blob too, but a truncated or corrupted file is cheaper to catch here
+    const u8 *blob = data + sizeof(pipeline_cache_header);
+    if (hash_bytes(blob, header->data_size, HASH_SEED) != header->data_hash) {
+        return false;
+    }
+
+    // Vulkan's own header leads the blob: length, version, vendor, device, UUID
+    const VkPipelineCacheHeaderVersionOne *vk_header = (const VkPipelineCacheHeaderVersionOne *)blob;
+    return header->data_size >= sizeof(VkPipelineCacheHeaderVersionOne) &&
+           vk_header->headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           vk_header->vendorID == props->vendorID &&
+           vk_header->deviceID == props->deviceID &&
+           memcmp(vk_header->pipelineCacheUUID, props->pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+b8 vk_pipeline_cache_create(VK_Context *context) {
+    RL_PROFILE_ZONE(cache_zone, "vk_pipeline_cache_create");
+    const VkPhysicalDeviceProperties *props = &context->device_properties.properties;
+
+    char path[256];
+    cache_path(path, sizeof(path));
+
+    VkPipelineCacheCreateInfo create_info = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+    };
+
+    rl_file_map map = {0};
+    if (platform_file_map_open(path, &map)) {
+        if (header_matches(props, map.data, map.size)) {
+            create_info.initialDataSize = map.size - sizeof(pipeline_cache_header);
+            create_info.pInitialData = map.data + sizeof(pipeline_cache_header);
+        } else {
+            RL_INFO("Pipeline cache '%s' belongs to another device or driver, starting empty", path);
+        }
+    }
+
+    VkResult res = vkCreatePipelineCache(context->device, &create_info, nullptr, &context->pipeline_cache);
+    if (res != VK_SUCCESS && create_info.initialDataSize > 0) {
+        // Rejected by the driver, an empty cache still works
+        RL_WARN("Driver rejected pipeline cache (VkResult=%s), starting empty", string_VkResult(res));
+        create_info.initialDataSize = 0;
+        create_info.pInitialData = nullptr;
+        res = vkCreatePipelineCache(context->device, &create_info, nullptr, &context->pipeline_cache);
+    }
+
+    if (map.data) {
+        platform_file_map_close(&map, map.size);
+    }
+
+    RL_PROFILE_ZONE_END(cache_zone);
+    if (res != VK_SUCCESS) {
+        RL_ERROR("Failed to create pipeline cache (VkResult=%s)", string_VkResult(res));
+        context->pipeline_cache = VK_NULL_HANDLE;
+        return false;
+    }
+
+    RL_DEBUG("Pipeline cache created (seeded with %llu bytes)", (u64)create_info.initialDataSize);
+    return true;
+}
+
+void vk_pipeline_cache_destroy(VK_Context *context) {
+    if (context->pipeline_cache == VK_NULL_HANDLE) {
+        return;
+    }
+
+    const VkPhysicalDeviceProperties *props = &context->device_properties.properties;
+
+    size_t data_size = 0;
+    if (vkGetPipelineCacheData(context->device, context->pipeline_cache, &data_size, nullptr) == VK_SUCCESS && data_size > 0) {
+        char path[256];
+        char tmp_path[264];
+        cache_path(path, sizeof(path));
+        snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+
+        u64 size = sizeof(pipeline_cache_header) + data_size;
+        rl_file_map map = {0};
+        if (platform_file_map_create(tmp_path, size, &map)) {
+            u8 *blob = map.data + sizeof(pipeline_cache_header);
+            VkResult res = vkGetPipelineCacheData(context->device, context->pipeline_cache, &data_size, blob);
+
+            pipeline_cache_header *header = (pipeline_cache_header *)map.data;
+            *header = (pipeline_cache_header){
+                .magic = PIPELINE_CACHE_MAGIC,
+                .version = PIPELINE_CACHE_VERSION,
+                .vendor_id = props->vendorID,
+                .device_id = props->deviceID,
+                .driver_version = props->driverVersion,
+                .data_size = data_size,
+                .data_hash = hash_bytes(blob, data_size, HASH_SEED),
+            };
+            memcpy(header->uuid, props->pipelineCacheUUID, VK_UUID_SIZE);
+
+            size = sizeof(pipeline_cache_header) + data_size;
+            platform_file_map_close(&map, size);
+
+            if (res == VK_SUCCESS && platform_file_rename(tmp_path, path)) {
+                RL_DEBUG("Saved pipeline cache (%llu bytes)", (u64)data_size);
+            } else {
+                platform_file_delete(tmp_path);
+            }
+        }
+    }
+
+    vkDestroyPipelineCache(context->device, context->pipeline_cache, nullptr);
+    context->pipeline_cache = VK_NULL_HANDLE;
+}
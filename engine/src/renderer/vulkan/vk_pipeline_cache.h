@@ -0,0 +1,9 @@
+#pragma once
+
+#include "defines.h"
+#include "vk_types.h"
+
+// Creates context->pipeline_cache, seeded from disk when the file matches this device and driver
+b8 vk_pipeline_cache_create(VK_Context *context);
+// Writes the cache back to disk and destroys it
+void vk_pipeline_cache_destroy(VK_Context *context);
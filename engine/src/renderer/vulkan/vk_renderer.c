@@ -17,10 +17,147 @@
 
 #include "profiler/profiler.h"
 
+#include <string.h>
+
+#define VK_UPLOAD_BUDGET_US 2000 // Frame time spent uploading streamed textures, at least one per frame
+
 static VK_Context context;
 
 static f64 angle;
 
+static VK_StreamedTexture *find_streamed(rl_asset_handle handle) {
+    for (u64 i = 0; i < context.streamed_textures.count; i++) {
+        VK_StreamedTexture *streamed = &context.streamed_textures.items[i];
+        if (streamed->handle.index == handle.index && streamed->handle.generation == handle.generation) {
+            return streamed;
+        }
+    }
+    return nullptr;
+}
+
+// A recorded frame may still sample it, destroyed by destroy_retired once that frame is done
+static void retire_streamed(VK_StreamedTexture *streamed) {
+    da_append(&context.retired_textures, ((VK_RetiredTexture){streamed->texture, context.frame_number}));
+    *streamed = context.streamed_textures.items[--context.streamed_textures.count];
+}
+
+// Called after the in-flight fence wait, every frame older than max_frames_in_flight has finished
+static void destroy_retired() {
+    for (u64 i = 0; i < context.retired_textures.count;) {
+        VK_RetiredTexture *retired = &context.retired_textures.items[i];
+        if (retired->frame + context.max_frames_in_flight > context.frame_number) {
+            i++;
+            continue;
+        }
+        vk_texture_destroy(&context, &retired->texture);
+        *retired = context.retired_textures.items[--context.retired_textures.count];
+    }
+}
+
+static void upload_streamed(rl_asset_handle handle) {
+    rl_asset *asset = asset_get(handle);
+    if (!asset || find_streamed(handle)) {
+        return; // Evicted before its turn, or already uploaded
+    }
+
+    VK_StreamedTexture streamed = {.handle = handle};
+    if (!vk_texture_create(&context, asset, &streamed.texture)) {
+        RL_WARN("Failed to upload streamed texture '%s'", asset->filename);
+        return;
+    }
+    da_append(&context.streamed_textures, streamed);
+}
+
+// Drains the upload queue until the frame budget is spent
+static void upload_pending() {
+    if (context.pending_uploads.count == 0) {
+        return;
+    }
+
+    i64 freq = platform_get_info()->clock_freq;
+    i64 budget = VK_UPLOAD_BUDGET_US * freq / 1000000;
+    i64 start = platform_get_clock_counter();
+
+    u64 done = 0;
+    while (done < context.pending_uploads.count) {
+        upload_streamed(context.pending_uploads.items[done++]);
+        if (platform_get_clock_counter() - start >= budget) {
+            break;
+        }
+    }
+
+    u64 left = context.pending_uploads.count - done;
+    memmove(context.pending_uploads.items, context.pending_uploads.items + done, left * sizeof(rl_asset_handle));
+    context.pending_uploads.count = left;
+}
+
+// Queues the GPU copy of a texture that finished loading after startup. Meshes aren't drawn by this backend.
+static b8 on_asset_loaded(void *event, void *data) {
+    (void)data;
+    rl_asset_handle handle = *(rl_asset_handle *)event;
+    rl_asset *asset = asset_get(handle);
+    if (asset && asset->type == ASSET_TEXTURE) {
+        da_append(&context.pending_uploads, handle);
+    }
+    return false;
+}
+
+// Retires the GPU copy of an evicted texture, it's queued again by on_asset_loaded when the asset comes back
+static b8 on_asset_evicted(void *event, void *data) {
+    (void)data;
+    rl_asset_handle handle = *(rl_asset_handle *)event;
+
+    for (u64 i = 0; i < context.pending_uploads.count;) {
+        rl_asset_handle pending = context.pending_uploads.items[i];
+        if (pending.index == handle.index && pending.generation == handle.generation) {
+            memmove(context.pending_uploads.items + i, context.pending_uploads.items + i + 1,
+                    (context.pending_uploads.count - i - 1) * sizeof(rl_asset_handle));
+            context.pending_uploads.count--;
+        } else {
+            i++;
+        }
+    }
+
+    VK_StreamedTexture *streamed = find_streamed(handle);
+    if (streamed) {
+        retire_streamed(streamed);
+        asset_set_gpu_size(handle, 0);
+    }
+    return false;
+}
+
+// Rebuilds the pipeline when one of its shaders changed on disk, runs at the frame boundary before recording
+static b8 on_asset_reloaded(void *event, void *data) {
+    (void)data;
+    rl_asset_handle handle = *(rl_asset_handle *)event;
+
+    // Streamed copies are replaced like a fresh load
+    VK_StreamedTexture *streamed = find_streamed(handle);
+    if (streamed) {
+        retire_streamed(streamed);
+        upload_streamed(handle);
+        return false;
+    }
+
+    rl_asset *asset = asset_get(handle);
+    if (!asset || asset->type != ASSET_SHADER || !vk_pipeline_uses_shader(asset->filename)) {
+        return false;
+    }
+
+    vkDeviceWaitIdle(context.device);
+
+    VK_Pipeline previous = context.graphics_pipeline;
+    if (!vk_pipeline_create(&context)) {
+        RL_WARN("Failed to rebuild the pipeline after '%s' changed, keeping the previous one", asset->filename);
+        context.graphics_pipeline = previous;
+        return false;
+    }
+
+    vkDestroyPipeline(context.device, previous.handle, nullptr);
+    vkDestroyPipelineLayout(context.device, previous.layout, nullptr);
+    return false;
+}
+
 void vulkan_resize_framebuffer(i32 w, i32 h) {
     /*
     RL_DEBUG("Window #%d resized | POS: %d;%d | Size: %dx%d",
@@ -41,17 +178,18 @@ b8 vulkan_initialize(platform_window *window, b8 vsync) {
 
     context.window = window;
 
+    // Texture rows are top to bottom (as decoded), so v = 0 is the top of the image
     // Rec 1
-    da_append(&context.vertices, ((vertex){{-0.5f, -0.5f, 0.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 0.0f}}));
-    da_append(&context.vertices, ((vertex){{0.5f, -0.5f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f}}));
-    da_append(&context.vertices, ((vertex){{0.5f, 0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f}}));
-    da_append(&context.vertices, ((vertex){{-0.5f, 0.5f, 0.0f}, {1.0f, 1.0f, 1.0f}, {1.0f, 1.0f}}));
+    da_append(&context.vertices, ((vertex){{-0.5f, -0.5f, 0.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 1.0f}}));
+    da_append(&context.vertices, ((vertex){{0.5f, -0.5f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f}}));
+    da_append(&context.vertices, ((vertex){{0.5f, 0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f}}));
+    da_append(&context.vertices, ((vertex){{-0.5f, 0.5f, 0.0f}, {1.0f, 1.0f, 1.0f}, {1.0f, 0.0f}}));
 
     // Rec 2
-    da_append(&context.vertices, ((vertex){{-0.5f, -0.5f, -0.5f}, {1.0f, 0.0f, 0.0f}, {1.0f, 0.0f}}));
-    da_append(&context.vertices, ((vertex){{0.5f, -0.5f, -0.5f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f}}));
-    da_append(&context.vertices, ((vertex){{0.5f, 0.5f, -0.5f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f}}));
-    da_append(&context.vertices, ((vertex){{-0.5f, 0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}, {1.0f, 1.0f}}));
+    da_append(&context.vertices, ((vertex){{-0.5f, -0.5f, -0.5f}, {1.0f, 0.0f, 0.0f}, {1.0f, 1.0f}}));
+    da_append(&context.vertices, ((vertex){{0.5f, -0.5f, -0.5f}, {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f}}));
+    da_append(&context.vertices, ((vertex){{0.5f, 0.5f, -0.5f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f}}));
+    da_append(&context.vertices, ((vertex){{-0.5f, 0.5f, -0.5f}, {1.0f, 1.0f, 1.0f}, {1.0f, 0.0f}}));
 
     da_append(&context.indices, 0);
     da_append(&context.indices, 1);
@@ -127,7 +265,7 @@ b8 vulkan_initialize(platform_window *window, b8 vsync) {
         return false;
     }
 
-    if (!vk_texture_create(&context, &context.texture_wood)) {
+    if (!vk_texture_create(&context, get_asset("face.jpg"), &context.texture_wood)) {
         RL_ERROR("failed to create wood texture");
         return false;
     }
@@ -171,13 +309,34 @@ b8 vulkan_initialize(platform_window *window, b8 vsync) {
         return false;
     }
 
+    da_init(&context.streamed_textures);
+    da_init(&context.retired_textures);
+    da_init(&context.pending_uploads);
+    event_register(EVENT_ASSET_LOADED, on_asset_loaded, nullptr);
+    event_register(EVENT_ASSET_EVICTED, on_asset_evicted, nullptr);
+    event_register(EVENT_ASSET_RELOADED, on_asset_reloaded, nullptr);
+
     return true;
 }
 
 void vulkan_destroy() {
+    event_unregister(EVENT_ASSET_LOADED, on_asset_loaded, nullptr);
+    event_unregister(EVENT_ASSET_EVICTED, on_asset_evicted, nullptr);
+    event_unregister(EVENT_ASSET_RELOADED, on_asset_reloaded, nullptr);
+
     // Wait for logical device to finish operations
     vkDeviceWaitIdle(context.device);
 
+    for (u64 i = 0; i < context.streamed_textures.count; i++) {
+        vk_texture_destroy(&context, &context.streamed_textures.items[i].texture);
+    }
+    for (u64 i = 0; i < context.retired_textures.count; i++) {
+        vk_texture_destroy(&context, &context.retired_textures.items[i].texture);
+    }
+    da_free(&context.streamed_textures);
+    da_free(&context.retired_textures);
+    da_free(&context.pending_uploads);
+
     vk_sync_destroy_frame(&context);
     vk_descriptor_destroy_pool(&context);
     vk_buffers_destroy_uniform(&context);
@@ -232,9 +391,13 @@ void vulkan_begin_frame(f64 delta_time) {
     RL_PROFILE_ZONE(fence_zone, "vkWaitForFences");
     // Wait for previous frame to finish
     vkWaitForFences(context.device, 1, &context.in_flight_fences[context.current_frame], VK_TRUE, UINT64_MAX);
+    context.frame_number++;
 
     RL_PROFILE_ZONE_END(fence_zone);
 
+    destroy_retired();
+    upload_pending();
+
     // Get image from swapchain and pass image_available semaphore
     u32 image_index;
     RL_PROFILE_ZONE(acquire_zone, "vkAcquireNextImageKHR");
@@ -320,6 +483,10 @@ void vulkan_set_view_projection(mat4 view, mat4 projection, vec3 pos) {
     glm_mat4_copy(projection, context.proj);
 }
 
+void vulkan_set_lod_threshold(f32 threshold_px) {
+    (void)threshold_px; // No meshes are drawn by this backend yet
+}
+
 platform_window *vulkan_get_active_window() {
     return context.window;
 }
@@ -11,6 +11,7 @@ void vulkan_begin_frame(f64 delta_time);
 void vulkan_end_frame();
 void vulkan_swap_buffers();
 void vulkan_set_view_projection(mat4 view, mat4 projection, vec3 pos);
+void vulkan_set_lod_threshold(f32 threshold_px);
 
 platform_window* vulkan_get_active_window();
 void vulkan_set_active_window(platform_window* window);
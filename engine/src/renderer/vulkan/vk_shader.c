@@ -1,8 +1,14 @@
 #include "renderer/vulkan/vk_shader.h"
 
 #include "asset/shader.h"
+#include "core/job.h"
+#include "platform/io/file_io.h"
+#include "profiler/profiler.h"
+#include "util/hash.h"
+#include "util/str.h"
 
 #include <shaderc/shaderc.h>
+#include <stdio.h>
 
 b8 vk_shader_init_compiler(VK_Context *context) {
     if (context->shader_compiler.initialized) {
@@ -40,74 +46,230 @@ void vk_shader_destroy_compiler(VK_Context *context) {
     RL_DEBUG("Shader compiler destroyed");
 }
 
-b8 vk_shader_module_compile(VK_Context *context, const char *filename) {
-    if (!context->shader_compiler.initialized) {
-        RL_ERROR("Shader compiler not initialized before compile!");
+/* SPIR-V cache
+ *  Compiled modules are stored in the cache dir as "<key>.spv", where the key hashes the GLSL source,
+ *  shader kind, compile options and the SPIR-V version shaderc targets. Hits are mapped and handed
+ *  to vkCreateShaderModule directly, misses are compiled in parallel on the job system.
+ */
+
+#define SPIRV_CACHE_MAGIC 0x56505352 // "RSPV"
+#define SPIRV_CACHE_VERSION 1
+
+typedef struct spirv_cache_header {
+    u32 magic;
+    u32 version;
+    u64 key;
+    u64 code_size;
+} spirv_cache_header;
+
+typedef struct vk_shader_job {
+    const char *filename;
+    rl_asset_shader *asset;
+    shaderc_shader_kind kind;
+    shaderc_compiler_t compiler;
+    shaderc_compile_options_t options;
+    u64 key;
+    char cache_path[256];
+
+    rl_file_map cached; // Hit
+    u8 *code;           // Miss, mem_alloc'd
+    u64 code_size;
+} vk_shader_job;
+
+static u64 spirv_cache_key(const rl_asset_shader *shader, shaderc_shader_kind kind) {
+    u32 spv_version = 0;
+    u32 spv_revision = 0;
+    shaderc_get_spv_version(&spv_version, &spv_revision);
+
+    struct {
+        u32 kind;
+        u32 optimization;
+        u32 spv_version, spv_revision;
+        u32 cache_version;
+    } params = {kind, shaderc_optimization_level_performance, spv_version, spv_revision, SPIRV_CACHE_VERSION};
+
+    u64 key = hash_bytes(shader->source, cstr_len(shader->source), HASH_SEED);
+    return hash_bytes(&params, sizeof(params), key);
+}
+
+static b8 spirv_cache_open(vk_shader_job *job) {
+    if (!platform_file_map_open(job->cache_path, &job->cached)) {
         return false;
     }
 
-    rl_asset_shader *asset_shader = get_asset(filename)->handle;
+    const spirv_cache_header *header = (const spirv_cache_header *)job->cached.data;
+    b8 valid = job->cached.size >= sizeof(spirv_cache_header) &&
+               header->magic == SPIRV_CACHE_MAGIC &&
+               header->version == SPIRV_CACHE_VERSION &&
+               header->key == job->key &&
+               header->code_size % sizeof(u32) == 0 &&
+               sizeof(spirv_cache_header) + header->code_size == job->cached.size;
 
-    shaderc_shader_kind kind;
-    switch (asset_shader->type) {
+    if (!valid) {
+        platform_file_map_close(&job->cached, job->cached.size);
+        return false;
+    }
+
+    job->code = job->cached.data + sizeof(spirv_cache_header);
+    job->code_size = header->code_size;
+    return true;
+}
+
+static void spirv_cache_write(const vk_shader_job *job) {
+    char tmp_path[264];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", job->cache_path);
+
+    u64 size = sizeof(spirv_cache_header) + job->code_size;
+    rl_file_map map = {0};
+    if (!platform_file_map_create(tmp_path, size, &map)) {
+        return;
+    }
+
+    *(spirv_cache_header *)map.data = (spirv_cache_header){
+        .magic = SPIRV_CACHE_MAGIC,
+        .version = SPIRV_CACHE_VERSION,
+        .key = job->key,
+        .code_size = job->code_size,
+    };
+    mem_copy(job->code, map.data + sizeof(spirv_cache_header), job->code_size);
+
+    platform_file_map_close(&map, size);
+    platform_file_rename(tmp_path, job->cache_path);
+}
+
+// Runs on a job worker, the shaderc compiler is safe to share between threads
+static void shader_compile_job(void *data) {
+    vk_shader_job *job = data;
+
+    shaderc_compilation_result_t result = shaderc_compile_into_spv(
+        job->compiler,
+        job->asset->source,
+        cstr_len(job->asset->source),
+        job->kind,
+        job->filename,
+        "main",
+        job->options);
+
+    if (shaderc_result_get_compilation_status(result) != shaderc_compilation_status_success) {
+        RL_ERROR("Shader compile failed for '%s':\n%s",
+                 job->filename,
+                 shaderc_result_get_error_message(result));
+        shaderc_result_release(result);
+        return;
+    }
+
+    job->code_size = shaderc_result_get_length(result);
+    job->code = mem_alloc(job->code_size, MEM_SUBSYSTEM_RENDERER);
+    mem_copy((void *)shaderc_result_get_bytes(result), job->code, job->code_size);
+    shaderc_result_release(result);
+
+    spirv_cache_write(job);
+}
+
+static b8 shader_job_prepare(VK_Context *context, const char *filename, vk_shader_job *job) {
+    *job = (vk_shader_job){
+        .filename = filename,
+        .asset = get_asset(filename)->handle,
+        .compiler = context->shader_compiler.compiler,
+        .options = context->shader_compiler.options,
+    };
+
+    switch (job->asset->type) {
     case SHADER_TYPE_VERTEX:
-        kind = shaderc_glsl_vertex_shader;
+        job->kind = shaderc_glsl_vertex_shader;
         break;
     case SHADER_TYPE_FRAGMENT:
-        kind = shaderc_glsl_fragment_shader;
+        job->kind = shaderc_glsl_fragment_shader;
         break;
     case SHADER_TYPE_COMPUTE:
-        kind = shaderc_glsl_compute_shader;
+        job->kind = shaderc_glsl_compute_shader;
         break;
     default:
         RL_ERROR("Unknown shader type for '%s'", filename);
         return false;
     }
 
-    shaderc_compilation_result_t result = shaderc_compile_into_spv(
-        context->shader_compiler.compiler,
-        asset_shader->source,
-        cstr_len(asset_shader->source),
-        kind,
-        filename,
-        "main",
-        context->shader_compiler.options);
+    job->key = spirv_cache_key(job->asset, job->kind);
+    snprintf(job->cache_path, sizeof(job->cache_path), "%s%016llx.spv", get_cache_dir(), (unsigned long long)job->key);
+    return true;
+}
 
-    if (shaderc_result_get_compilation_status(result) != shaderc_compilation_status_success) {
-        RL_ERROR("Shader compile failed for '%s':\n%s",
-                 filename,
-                 shaderc_result_get_error_message(result));
-        shaderc_result_release(result);
+b8 vk_shader_modules_compile(VK_Context *context, const char **filenames, u32 count) {
+    if (!context->shader_compiler.initialized) {
+        RL_ERROR("Shader compiler not initialized before compile!");
         return false;
     }
 
-    size_t codeSize = shaderc_result_get_length(result);
-    const uint32_t *codePtr = (const uint32_t *)shaderc_result_get_bytes(result);
+    RL_PROFILE_ZONE(compile_zone, "vk_shader_modules_compile");
 
-    VkShaderModuleCreateInfo createInfo = {
-        .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
-        .codeSize = codeSize,
-        .pCode = codePtr
-    };
+    vk_shader_job *jobs = mem_alloc(count * sizeof(vk_shader_job), MEM_SUBSYSTEM_RENDERER);
+    rl_job *work = mem_alloc(count * sizeof(rl_job), MEM_SUBSYSTEM_RENDERER);
 
-    VK_Shader *vk_shader = rl_arena_push(&context->arena, sizeof(VK_Shader), true);
-    vk_shader->asset = asset_shader;
-    if (vkCreateShaderModule(context->device, &createInfo, nullptr, &vk_shader->module) != VK_SUCCESS) {
-        RL_ERROR("Failed to create VkShaderModule for '%s'", filename);
-        shaderc_result_release(result);
-        return false;
+    // `jobs` isn't zeroed, cleanup only touches the `prepared` ones (a failed prepare still clears its own)
+    b8 success = true;
+    u32 miss_count = 0;
+    u32 prepared = 0;
+    for (u32 i = 0; i < count && success; i++) {
+        success = shader_job_prepare(context, filenames[i], &jobs[i]);
+        prepared++;
+        if (success && !spirv_cache_open(&jobs[i])) {
+            work[miss_count++] = (rl_job){shader_compile_job, &jobs[i]};
+        }
     }
 
-    da_append(&context->shaders, *vk_shader);
+    if (success && miss_count > 0) {
+        RL_DEBUG("Compiling %u of %u shaders, the rest come from the SPIR-V cache", miss_count, count);
+        rl_job_counter counter = {0};
+        job_run(work, miss_count, &counter);
+        job_wait(&counter);
+    }
 
-    shaderc_result_release(result);
+    // Modules are created in request order so pipeline stages stay in the order they were asked for
+    for (u32 i = 0; i < count && success; i++) {
+        vk_shader_job *job = &jobs[i];
+        if (!job->code) {
+            success = false;
+            break;
+        }
 
-    RL_TRACE("Successfully compiled shader module '%s'. shaders_loaded_count=%d", filename, context->shaders.count);
-    return true;
+        VkShaderModuleCreateInfo create_info = {
+            .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+            .codeSize = job->code_size,
+            .pCode = (const u32 *)job->code,
+        };
+
+        VK_Shader vk_shader = {.asset = job->asset};
+        if (vkCreateShaderModule(context->device, &create_info, nullptr, &vk_shader.module) != VK_SUCCESS) {
+            RL_ERROR("Failed to create VkShaderModule for '%s'", job->filename);
+            success = false;
+            break;
+        }
+
+        da_append(&context->shaders, vk_shader);
+        RL_TRACE("Successfully created shader module '%s'. shaders_loaded_count=%d", job->filename, context->shaders.count);
+    }
+
+    for (u32 i = 0; i < prepared; i++) {
+        if (jobs[i].cached.data) {
+            platform_file_map_close(&jobs[i].cached, jobs[i].cached.size);
+        } else if (jobs[i].code) {
+            mem_free(jobs[i].code, jobs[i].code_size, MEM_SUBSYSTEM_RENDERER);
+        }
+    }
+    mem_free(work, count * sizeof(rl_job), MEM_SUBSYSTEM_RENDERER);
+    mem_free(jobs, count * sizeof(vk_shader_job), MEM_SUBSYSTEM_RENDERER);
+
+    RL_PROFILE_ZONE_END(compile_zone);
+    return success;
+}
+
+b8 vk_shader_module_compile(VK_Context *context, const char *filename) {
+    return vk_shader_modules_compile(context, &filename, 1);
 }
 
 void vk_shader_modules_destroy(VK_Context *context) {
     for (u32 i = 0; i < context->shaders.count; i++) {
         vkDestroyShaderModule(context->device, context->shaders.items[i].module, nullptr);
     }
+    context->shaders.count = 0;
 }
\ No newline at end of file
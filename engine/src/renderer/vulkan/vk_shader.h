@@ -7,4 +7,6 @@ b8 vk_shader_init_compiler(VK_Context *context);
 void vk_shader_destroy_compiler(VK_Context *context);
 
 b8 vk_shader_module_compile(VK_Context *context, const char *filename);
+// Cache misses compile in parallel, modules are appended to context->shaders in `filenames` order
+b8 vk_shader_modules_compile(VK_Context *context, const char **filenames, u32 count);
 void vk_shader_modules_destroy(VK_Context *context);
\ No newline at end of file
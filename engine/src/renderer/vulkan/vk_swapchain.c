@@ -191,6 +191,7 @@ void create_image_views(VK_Context *context) {
             context,
             context->swapchain.images[i],
             context->swapchain.chosen_format.surfaceFormat.format,
+            1,
             &context->swapchain.image_views[i]);
     }
 
@@ -1,18 +1,68 @@
 #include "vk_texture.h"
 
+#include "asset/texture_compress.h"
 #include "vk_buffer.h"
 #include "vk_image.h"
 
-b8 vk_texture_create(VK_Context *ctx, VK_Texture *vk_texture) {
-    rl_asset *asset = get_asset("face.jpg");
+static VkFormat texture_vk_format(TEXTURE_FORMAT format) {
+    switch (format) {
+    case TEXTURE_FORMAT_RGBA8:
+        return VK_FORMAT_R8G8B8A8_SRGB;
+    case TEXTURE_FORMAT_BC1:
+        return VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+    case TEXTURE_FORMAT_BC3:
+        return VK_FORMAT_BC3_SRGB_BLOCK;
+    case TEXTURE_FORMAT_BC5:
+        return VK_FORMAT_BC5_UNORM_BLOCK;
+    case TEXTURE_FORMAT_BC7:
+        return VK_FORMAT_BC7_SRGB_BLOCK;
+    }
+    return VK_FORMAT_UNDEFINED;
+}
+
+static b8 format_sampleable(VK_Context *ctx, VkFormat format) {
+    if (format == VK_FORMAT_UNDEFINED) {
+        return false;
+    }
+    VkFormatProperties props;
+    vkGetPhysicalDeviceFormatProperties(ctx->physical_device, format, &props);
+    return (props.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0;
+}
+
+b8 vk_texture_create(VK_Context *ctx, const rl_asset *asset, VK_Texture *vk_texture) {
     rl_texture *texture = asset->handle;
 
+    // Cooked block formats upload as-is, a device without BC sampling gets the chain expanded on the CPU
+    TEXTURE_FORMAT upload_format = texture->format;
+    VkFormat format = texture_vk_format(texture->format);
+    if (texture_format_is_compressed(texture->format) &&
+        (!ctx->device_properties.features.textureCompressionBC || !format_sampleable(ctx, format))) {
+        RL_WARN("Texture '%s': BC formats not supported by the device, decompressing", asset->filename);
+        upload_format = TEXTURE_FORMAT_RGBA8;
+        format = texture->format == TEXTURE_FORMAT_BC5 ? VK_FORMAT_R8G8B8A8_UNORM : VK_FORMAT_R8G8B8A8_SRGB;
+    }
+
+    // Uncooked textures (source loads, hot reloads) only bring level 0, the rest is blitted down on the GPU
+    u32 upload_levels = RL_MIN(texture->mip_count, VK_TEXTURE_MAX_MIP_LEVELS);
+    u32 mip_levels = upload_levels;
+    b8 generate_mips = upload_levels == 1 && !texture_format_is_compressed(upload_format) &&
+                       vk_image_supports_linear_blit(ctx, format);
+    if (generate_mips) {
+        mip_levels = RL_MIN(texture_mip_count_full(texture->width, texture->height), VK_TEXTURE_MAX_MIP_LEVELS);
+    }
+
+    VkDeviceSize level_offsets[VK_TEXTURE_MAX_MIP_LEVELS];
+    for (u32 level = 0; level < upload_levels; level++) {
+        level_offsets[level] = texture_level_offset(upload_format, texture->width, texture->height, level);
+    }
+    VkDeviceSize size = texture_level_offset(upload_format, texture->width, texture->height, upload_levels);
+
     VkBuffer staging_buffer = nullptr;
     VkDeviceMemory staging_buffer_memory = nullptr;
 
     b8 success = vk_buffer_create(
         ctx,
-        texture->size,
+        size,
         VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
         &staging_buffer,
@@ -23,43 +73,55 @@ b8 vk_texture_create(VK_Context *ctx, VK_Texture *vk_texture) {
         return false;
     }
 
+    // Same row order as the asset, the vertex UVs handle orientation
     void *data;
-    vkMapMemory(ctx->device, staging_buffer_memory, 0, texture->size, 0, &data);
-    u8 *dst_bytes = data;
-    u8 *src_bytes = texture->data;
-
-    for (int y = 0; y < texture->height; y++) {
-        // read from the bottom row upward
-        u8 *src_row = src_bytes + (texture->height - 1 - y) * texture->width * texture->channels;
-        u8 *dst_row = dst_bytes + y * texture->width * texture->channels;
-        mem_copy(src_row, dst_row, texture->width * texture->channels);
+    vkMapMemory(ctx->device, staging_buffer_memory, 0, size, 0, &data);
+    if (upload_format == texture->format) {
+        mem_copy(texture->data, data, size);
+    } else {
+        success = texture_decompress(texture, data);
     }
     vkUnmapMemory(ctx->device, staging_buffer_memory);
 
-    success = vk_image_create(
-        ctx,
-        texture->width,
-        texture->height,
-        VK_FORMAT_R8G8B8A8_SRGB,
-        VK_IMAGE_TILING_OPTIMAL,
-        VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        &vk_texture->texture_image, &vk_texture->texture_memory);
+    if (success) {
+        success = vk_image_create(
+            ctx,
+            texture->width,
+            texture->height,
+            mip_levels,
+            format,
+            VK_IMAGE_TILING_OPTIMAL,
+            VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | (generate_mips ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT : 0),
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            &vk_texture->texture_image, &vk_texture->texture_memory);
+    }
 
     if (!success) {
+        vkDestroyBuffer(ctx->device, staging_buffer, nullptr);
+        vkFreeMemory(ctx->device, staging_buffer_memory, nullptr);
         return false;
     }
 
-    // Transition for copying from staging buffer -> transition to shader ready
-    vk_image_transition_layout(ctx, vk_texture->texture_image, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-    vk_buffer_copy_to_image(ctx, staging_buffer, vk_texture->texture_image, texture->width, texture->height);
-    vk_image_transition_layout(ctx, vk_texture->texture_image, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    // One submission: transition for copying from staging buffer -> copy -> mip blits -> shader ready
+    VkCommandBuffer cmd_buf = vk_buffer_begin_single_use(ctx, ctx->graphics_pool);
+    vk_image_transition_layout(cmd_buf, vk_texture->texture_image, 0, mip_levels, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    vk_buffer_copy_to_image(cmd_buf, staging_buffer, vk_texture->texture_image, texture->width, texture->height, upload_levels, level_offsets);
+    if (generate_mips) {
+        vk_image_generate_mips(cmd_buf, vk_texture->texture_image, texture->width, texture->height, mip_levels);
+    } else {
+        vk_image_transition_layout(cmd_buf, vk_texture->texture_image, 0, mip_levels, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+    vk_buffer_end_single_use(ctx, ctx->graphics_pool, cmd_buf, ctx->graphics_queue);
 
     vkDestroyBuffer(ctx->device, staging_buffer, nullptr);
     vkFreeMemory(ctx->device, staging_buffer_memory, nullptr);
 
     // Create view
-    vk_image_view_create(ctx, vk_texture->texture_image, VK_FORMAT_R8G8B8A8_SRGB, &vk_texture->texture_image_view);
+    vk_image_view_create(ctx, vk_texture->texture_image, format, mip_levels, &vk_texture->texture_image_view);
+
+    VkMemoryRequirements requirements;
+    vkGetImageMemoryRequirements(ctx->device, vk_texture->texture_image, &requirements);
+    asset_set_gpu_size(asset_find(asset->filename), requirements.size);
 
     return true;
 }
@@ -108,7 +170,7 @@ b8 vk_texture_create_sampler(VK_Context *ctx) {
     sampler_create_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
     sampler_create_info.mipLodBias = 0.0f;
     sampler_create_info.minLod = 0.0f;
-    sampler_create_info.maxLod = 0.0f;
+    sampler_create_info.maxLod = VK_LOD_CLAMP_NONE; // Every level of the view
 
     VK_CHECK_RETURN_FALSE(vkCreateSampler(ctx->device, &sampler_create_info, nullptr, &ctx->texture_sampler), "Failed to create texture sampler");
 
@@ -3,7 +3,8 @@
 #include "defines.h"
 #include "vk_types.h"
 
-b8 vk_texture_create(VK_Context *ctx, VK_Texture *vk_texture);
+// Uploads a ready texture asset and reports its GPU size
+b8 vk_texture_create(VK_Context *ctx, const rl_asset *asset, VK_Texture *vk_texture);
 void vk_texture_destroy(VK_Context *ctx, VK_Texture *vk_texture);
 
 b8 vk_texture_create_sampler(VK_Context *ctx);
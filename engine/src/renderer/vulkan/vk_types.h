@@ -42,6 +42,8 @@
 }
 #endif
 
+#define VK_TEXTURE_MAX_MIP_LEVELS 16 // Up to 32768 x 32768
+
 /*-- Callback function to catch validation errors  -*/
 static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(VkDebugUtilsMessageSeverityFlagBitsEXT severity,
                                                     VkDebugUtilsMessageTypeFlagsEXT,
@@ -114,6 +116,22 @@ typedef struct VK_Texture {
     VkDeviceMemory texture_memory;
 } VK_Texture;
 
+// GPU copy of a texture loaded after startup (asset_load_async), keyed by its asset handle
+typedef struct VK_StreamedTexture {
+    rl_asset_handle handle;
+    VK_Texture texture;
+} VK_StreamedTexture;
+
+// Destroyed once the frames that may still sample it have finished
+typedef struct VK_RetiredTexture {
+    VK_Texture texture;
+    u64 frame;
+} VK_RetiredTexture;
+
+DA_DEFINE(VK_StreamedTextures, VK_StreamedTexture);
+DA_DEFINE(VK_RetiredTextures, VK_RetiredTexture);
+DA_DEFINE(VK_AssetHandles, rl_asset_handle);
+
 typedef struct VK_Shader {
     rl_asset_shader *asset;
     VkShaderModule module;
@@ -153,6 +171,7 @@ typedef struct VK_Context {
     VkPhysicalDevice physical_device;
     VkDevice device;
     VK_DeviceProperties device_properties;
+    VkPipelineCache pipeline_cache; // Persisted in the cache dir across runs
 
     VkQueue graphics_queue;
     VkQueue present_queue;
@@ -167,6 +186,7 @@ typedef struct VK_Context {
     VkFence transfer_fence; // Waiting for staging buffer to transfer vertex data
 
     // Per frame
+    u64 frame_number; // Frames begun so far
     u32 current_frame;
     u32 max_frames_in_flight;
     VkCommandBuffer *command_buffers;
@@ -190,6 +210,11 @@ typedef struct VK_Context {
     VkSampler texture_sampler;
     VK_Texture texture_wood;
 
+    // Streaming, uploads are spread over frames
+    VK_StreamedTextures streamed_textures;
+    VK_RetiredTextures retired_textures;
+    VK_AssetHandles pending_uploads;
+
     mat4 view;
     mat4 proj;
 
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "defines.h"
+
+#define HASH_SEED 0xcbf29ce484222325ull
+#define HASH_PRIME 0x100000001b3ull
+
+// FNV-1a, chain several buffers by passing the previous result as `seed`
+RL_INLINE u64 hash_bytes(const void *data, u64 size, u64 seed) {
+    const u8 *p = (const u8 *)data;
+    u64 hash = seed;
+    for (u64 i = 0; i < size; i++) {
+        hash ^= p[i];
+        hash *= HASH_PRIME;
+    }
+    return hash;
+}
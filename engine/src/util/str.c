@@ -6,6 +6,7 @@
 #include "memory/arena.h"
 #include "memory/containers/dynamic_array.h"
 #include "core/logger.h"
+#include "util/hash.h"
 #include <string.h>
 
 #define FORMAT_STRING_MAX 512
@@ -147,6 +148,10 @@ b8 cstr_ends_with(const char *str, const char *suffix) {
     return memcmp(str + (len_str - len_suf), suffix, len_suf) == 0;
 }
 
+u64 cstr_hash(const char *str) {
+    return hash_bytes(str, cstr_len(str), HASH_SEED);
+}
+
 char *cstr_format(rl_arena *arena, const char *fmt, ...) {
     va_list args;
     va_start(args, fmt);
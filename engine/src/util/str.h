@@ -28,6 +28,7 @@ u32 cstr_len(const char *str);
 char *cstr_format(rl_arena *arena, const char *fmt, ...);
 char *cstr_format_va(rl_arena *arena, const char *fmt, va_list args);
 b8 cstr_ends_with(const char *str, const char *suffix);
+u64 cstr_hash(const char *str); // FNV-1a
 
 #define RL_STRING(arena, str) rl_string_create(arena, str)
 #define RL_FORMAT_STRING(arena, fmt, ...) rl_string_format(arena, fmt, __VA_ARGS__)
\ No newline at end of file
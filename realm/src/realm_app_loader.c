@@ -163,6 +163,8 @@ void realm_app_module_unload(realm_app_module *module) {
         return;
     }
 
+    // Queued log records may still point at the module's strings
+    logger_flush();
     platform_unload_lib(&module->lib);
     module->lib.handle = nullptr;
     module->lib.path[0] = '\0';